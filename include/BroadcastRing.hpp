@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer ring read by any number of readers, each with its own
+// cursor. The writer never waits for readers: a reader that falls more than
+// N entries behind is told it was lapped and skips to the oldest entry still
+// intact. Every slot is a small seqlock, and all state lives inline, so the
+// ring can be placed in memory shared between processes.
+template <typename T, std::size_t N>
+class BroadcastRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "BroadcastRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "BroadcastRing payload must be trivially copyable");
+    static_assert(sizeof(T) % sizeof(std::uint64_t) == 0, "BroadcastRing payload must be a whole number of words");
+    static constexpr std::size_t WORDS = sizeof(T) / sizeof(std::uint64_t);
+    static constexpr std::uint64_t MASK = N - 1;
+
+public:
+    static constexpr std::size_t CAPACITY = N;
+
+    enum class Read { OK, EMPTY, LAPPED };
+
+    // Writers must be serialised by the caller.
+    void publish(const T &value) noexcept {
+        std::uint64_t w[WORDS];
+        std::memcpy(w, &value, sizeof(T));
+        const std::uint64_t pos = head_.load(std::memory_order_relaxed);
+        Slot &s = slots_[pos & MASK];
+        s.seq.store(2 * pos + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i) s.data[i].store(w[i], std::memory_order_relaxed);
+        s.seq.store(2 * pos + 2, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_release);
+    }
+
+    // Position the next publish will take; a new reader starts here.
+    std::uint64_t head() const noexcept { return head_.load(std::memory_order_acquire); }
+
+    // Copies the entry at `cursor` and advances it. On LAPPED the cursor has
+    // been moved forward to the oldest entry that is still readable.
+    Read read(std::uint64_t &cursor, T &out) const noexcept {
+        const Slot &s = slots_[cursor & MASK];
+        const std::uint64_t want = 2 * cursor + 2;
+        std::uint64_t s0 = s.seq.load(std::memory_order_acquire);
+        if (s0 < want) return Read::EMPTY;     // not written yet (or mid-write)
+        if (s0 == want) {
+            std::uint64_t w[WORDS];
+            for (std::size_t i = 0; i < WORDS; ++i) w[i] = s.data[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) == want) {
+                std::memcpy(&out, w, sizeof(T));
+                ++cursor;
+                return Read::OK;
+            }
+        }
+        // the writer is on a later lap; the slot at head() may be mid-write
+        const std::uint64_t h = head();
+        cursor = h > N ? h - N + 1 : 0;
+        return Read::LAPPED;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> seq{0};     // 2*pos+1 while writing pos, 2*pos+2 once written
+        std::atomic<std::uint64_t> data[WORDS];
+    };
+
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+    alignas(64) Slot slots_[N];
+};
@@ -1,44 +1,207 @@
 #pragma once 
 
-#include <variant>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <condition_variable>
 #include <atomic>
+#include <chrono>
+#include <functional>
 
+#include "EventBus.hpp"
 #include "ExecutionEngine.hpp"
+#include "FlightRecorder.hpp"
+#include "Metrics.hpp"
+#include "Tape.hpp"
+#include "Messages.hpp"
+#include "ThreadConfig.hpp"
 
-struct NewOrderMsg { std::shared_ptr<Order> order; };
-struct CancelMsg { int orderId; };
-struct ModifyMsg { int orderId; std::optional<double> px; std::optional<int> qty; };
-using InboundMsg = std::variant<NewOrderMsg, CancelMsg, ModifyMsg>;
+using SessionId = std::uint32_t;
+constexpr SessionId NO_SESSION = ~SessionId{0};
 
-struct TradeEvent { ExecutionEngine::Trade fill; };
-struct TopOfBookEvt { std::string symbol; double bidPx; int bidQty; double askPx; int askQty; };
-using OutboundMsg = std::variant<TradeEvent, TopOfBookEvt>;
+// What happens when a queue is full.
+enum class Overflow : std::uint8_t {
+    BLOCK,      // the producer (inbound) or the matching thread (outbound) waits
+    REJECT,     // inbound only: the message is refused with a THROTTLED reject
+    CONFLATE    // outbound only: market data gives way, see FlowControl
+};
+
+// Bounds on the runner's queues; 0 means unbounded. Messages wait in the
+// inbound queue for the matching thread, events in the outbound queue for
+// poll(). A session may have at most sessionCredits messages waiting; its
+// pushes never wait (a gateway pushes and polls on one thread) and are
+// refused past that or a full queue.
+//
+// Outbound BLOCK stops matching while the queue is full, so nothing is ever
+// lost and a stuck consumer backs up into the inbound queue; the check is
+// made per batch, which can overshoot by one batch's events. CONFLATE keeps
+// execution reports whole and stops matching only when they alone fill the
+// queue; beyond capacity a quote replaces the symbol's quote still queued
+// and incremental L3 events are dropped (the seq gap tells the consumer to
+// resync from a snapshot).
+struct FlowControl {
+    std::size_t   inCapacity     = 64 * 1024;
+    std::size_t   outCapacity    = 1024 * 1024;
+    std::uint32_t sessionCredits = 4096;
+    Overflow      inbound        = Overflow::BLOCK;       // BLOCK or REJECT
+    Overflow      outbound       = Overflow::CONFLATE;    // BLOCK or CONFLATE
+};
 
 class EngineRunner { 
 public:
-    EngineRunner();
+    // The worker applies `worker` to itself and runs `prewarm` before taking
+    // messages, so the books and risk tables it creates are first-touched on
+    // its own node. Messages pushed meanwhile wait in the queue.
+    explicit EngineRunner(const ThreadConfig& worker = {}, PrewarmConfig prewarm = {});
     ~EngineRunner();
 
-    void push(const InboundMsg& msg);
+    // Returns false, or a short count, for refused messages. Without a
+    // session a full queue waits or refuses as flowControl().inbound says.
+    // A session's pushes never wait: messages past its credits are refused,
+    // each with a THROTTLED reject.
+    bool push(const InboundMsg& msg);
+    // One lock and one wake-up for the whole batch.
+    std::size_t push(const InboundMsg* msgs, std::size_t n, SessionId from = NO_SESSION);
     bool poll(OutboundMsg& out);
     void stop();
+    // An eventfd that is readable while poll() has events to give, so a
+    // consumer can sleep in poll(2), epoll or an event loop instead of
+    // spinning. The worker signals it at most once per batch; poll() clears
+    // it when it runs dry. -1 if the fd could not be created.
+    int eventFd() const { return eventFd_; }
+    // Makes eventFd() readable as if events were queued, for a consumer
+    // that moved events from poll() into a buffer of its own and still has
+    // some to hand out.
+    void raiseEventFd();
+
+    // Push delivery: while a handler is set, the worker hands it each batch
+    // of events straight from its own buffer, and nothing reaches poll() or
+    // eventFd(). Throttle rejects are handed over on the refused producer's
+    // thread. Calls never overlap, and none is made once setEventHandler()
+    // has returned with another handler. The handler runs on the matching
+    // path: it must return quickly and must not call into the runner.
+    using EventHandler = std::function<void(const OutboundMsg* events, std::size_t n)>;
+    void setEventHandler(EventHandler handler);
+
+    // Any number of readers can follow the outbound events without taking
+    // them from poll(): every event is also broadcast, before conflation,
+    // to each subscription that accepts it. Subscribers never slow the
+    // engine down; one that falls a whole ring behind loses events (see
+    // EventBus.hpp). Subscriptions must not outlive the runner.
+    std::unique_ptr<EventBus::Subscription> subscribe(const EventFilter& filter = {}) {
+        return bus_.subscribe(filter);
+    }
+
+    // Messages a producer can push now without waiting or being refused.
+    std::size_t credits(SessionId session = NO_SESSION) const;
+    // False for a policy that does not apply to its queue.
+    bool setFlowControl(const FlowControl& fc);
+    FlowControl flowControl() const;
+
+    // A session binds a client connection to an account. Closing a session
+    // opened with cancelOnDisconnect pulls the orders it placed that still
+    // rest; other sessions of the account keep theirs.
+    SessionId openSession(AccountId account, bool cancelOnDisconnect);
+    void closeSession(SessionId session);
+
+    // Order-by-order (L3) events are off by default. Sequence numbers keep
+    // counting while off, so a consumer that turns the feed on starts with a
+    // gap and resyncs from a BOOK_SNAPSHOT.
+    void setL3Feed(bool on) { l3_.store(on, std::memory_order_relaxed); }
+
+    // Closed bars of engine().stats() are published as BAR events. A bar
+    // closes with the first trade after its end or, for a quiet symbol, as
+    // soon as the worker is idle past that end.
+    void setBarInterval(std::chrono::nanoseconds interval) {
+        eng_.stats().setBarInterval(interval.count());
+    }
+
+    // Appends every fill and top-of-book change to a tape under `root`
+    // (see Tape.hpp) from now on, until the runner is destroyed. False if
+    // the root cannot be created or a tape is already being recorded.
+    bool recordTape(const std::string& root);
+
+    // The flight recorder keeps the last inbound messages, fills, book
+    // changes and outbound events of every thread that touches the runner.
+    // It is dumped on request, when one message takes longer than the
+    // latency threshold (at most once a second; 0, the default, is off), and
+    // when an exception escapes the worker. Dumps go to `dir` unless a path
+    // is given; see FlightRecorder.hpp for reading them back.
+    std::string dumpFlightRecorder(const std::string& path = {}) const {
+        return flight_.dump(FlightRecorder::Reason::REQUEST, path);
+    }
+    void setFlightDumpDir(const std::string& dir) { flight_.setDir(dir); }
+    void setLatencyDump(std::chrono::nanoseconds threshold);
+
+    // False if some of the worker's ThreadConfig or memory locking could not
+    // be applied.
+    bool workerConfigured() const { return configured_.load(); }
 
     ExecutionEngine& engine() { return eng_; }
     const ExecutionEngine& engine() const { return eng_; }
+    // Queue traffic, order flow and book sizes; see Metrics.hpp.
+    Metrics& metrics() { return metrics_; }
+    const Metrics& metrics() const { return metrics_; }
 
 private:
+    struct Session { AccountId account; bool cancelOnDisconnect; bool open; std::uint32_t inFlight; };
+    // track: from a cancel-on-disconnect session, which keeps its order ids;
+    // closes: the MASS_CANCEL that pulls them when the session closes.
+    struct Pending { InboundMsg msg; SessionId from; bool track = false; bool closes = false; };
+
     void loop();
-    
+    void handle(const Pending& p);
+    void trackOrder(SessionId session, OrderId id);
+    void publishTob(SymbolId sym);
+    void publishSnapshot(SymbolId sym, std::uint64_t clientId);
+    void closeDueBars();
+    void enqueue(const OutboundMsg& m);
+    void flushOut();
+    void signalEventFd();
+    bool deliver(const OutboundMsg* events, std::size_t n);
+    void onSlowMessage();
+    // callers hold mtx_
+    std::size_t roomFor(SessionId from) const;
+    bool outRoom() const;
+    bool queueOut(const OutboundMsg& m);
+    bool armEventFd();
+    void throttle(const InboundMsg& m, std::vector<OutboundMsg>& direct);
+
     ExecutionEngine eng_;
+    Metrics metrics_;
+    FlightRecorder flight_;
+    EventBus bus_;
     std::thread worker_;
 
-    std::queue<InboundMsg> inQ_;
-    std::queue<OutboundMsg> outQ_;
+    // The worker swaps inQ_ for batch_, handles the whole batch, then
+    // publishes its events from outBatch_ under one lock.
+    std::vector<Pending> inQ_;
+    std::vector<Pending> batch_;
+    std::vector<OutboundMsg> outBatch_;
+    std::vector<TopOfBookEvt> lastQuote_;   // per symbol, as last published
+    std::deque<OutboundMsg> outQ_;
+    std::uint64_t outPopped_ = 0;
+    std::size_t outReports_ = 0;            // outQ_ entries that are not market data
+    std::vector<std::uint64_t> lastTob_;    // per symbol: 1 + outQ_ position of its last quote
+    std::vector<Session> sessions_;
+    std::vector<std::vector<OrderId>> sessionOrders_;   // matching thread: ids placed per session
+    std::vector<ExecutionEngine::RestingOrder> snapshotRows_;
+    FlowControl flow_;
 
-    std::mutex mtx_;
-    std::condition_variable cv_;
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;            // wakes the matching thread
+    std::condition_variable room_;          // wakes producers waiting for room
+    int blocked_ = 0;
+    int eventFd_ = -1;
+    bool signalled_ = false;                // eventFd_ written and not yet cleared
     std::atomic<bool> running_{true};
-};
\ No newline at end of file
+    std::atomic<bool> configured_{true};
+    std::atomic<bool> l3_{false};
+    std::mutex handlerMtx_;                 // held while the handler runs
+    EventHandler handler_;
+    std::atomic<bool> hasHandler_{false};
+    std::unique_ptr<TapeWriter> tapeOwner_;
+    std::atomic<TapeWriter*> tape_{nullptr};
+    std::atomic<std::uint64_t> slowTicks_{0};
+    std::chrono::steady_clock::time_point lastSlowDump_{};
+    bool busyPoll_ = false;
+};
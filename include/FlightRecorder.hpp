@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Always-on history of what the engine did last. Each recording thread owns
+// a ring of the last RING records and writes it with plain stores; nothing
+// is shared between writers and nothing takes a lock. dump() copies every
+// ring to a binary file, from any thread or from a signal handler (only
+// open / write / close are used), and load() merges the rings back into one
+// timeline ordered by timestamp.
+//
+// Records carry the TSC (or a monotonic clock where there is none); a dump
+// carries the calibration to turn them into wall-clock time.
+class FlightRecorder {
+public:
+    static constexpr std::size_t RING        = 4096;     // records per thread
+    static constexpr int         MAX_THREADS = 16;       // later threads are not recorded
+    static constexpr std::size_t BODY        = 64;
+
+    enum class Kind : std::uint16_t {
+        ENQUEUE = 1,    // InboundMsg, on the pushing thread
+        HANDLE,         // InboundMsg, matching thread starts on it
+        DONE,           // matching thread finished; aux = InboundType, body = ticks taken
+        FILL,           // ExecutionEngine::Trade
+        BOOK,           // ExecutionEngine::BookEvent
+        OUT,            // OutboundMsg
+        NOTE            // text
+    };
+    enum class Reason : std::uint32_t { REQUEST, SIGNAL, LATENCY, EXCEPTION };
+
+    struct Record {
+        unsigned char body[BODY];
+        std::uint64_t tsc;
+        std::atomic<std::uint64_t> n;   // 1 + position in the thread's stream, stored last
+        Kind          kind;
+        std::uint32_t aux;
+    };
+
+    explicit FlightRecorder(std::string dir = {});      // empty: $TMPDIR or /tmp
+    ~FlightRecorder();
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    static std::uint64_t ticks() noexcept;
+
+    void record(Kind k, const void* body, std::size_t len, std::uint32_t aux = 0) noexcept {
+        Ring* r = local();
+        if (!r) return;
+        const std::uint64_t n = r->head.load(std::memory_order_relaxed);
+        Record& rec = r->recs[n % RING];
+        rec.n.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(rec.body, body, len < BODY ? len : BODY);
+        rec.tsc  = ticks();
+        rec.kind = k;
+        rec.aux  = aux;
+        rec.n.store(n + 1, std::memory_order_release);
+        r->head.store(n + 1, std::memory_order_relaxed);
+    }
+    template <class T>
+    void record(Kind k, const T& body, std::uint32_t aux = 0) noexcept {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= BODY);
+        record(k, &body, sizeof(T), aux);
+    }
+    void note(const char* text) noexcept {
+        record(Kind::NOTE, static_cast<const void*>(text), std::strlen(text) + 1);
+    }
+
+    // Writes a dump to `path`, or to a fresh <dir>/tcx-flight.<pid>.<k>.bin,
+    // and returns the file name ("" on failure). Records being written while
+    // the rings are copied are left out.
+    std::string dump(Reason why, const std::string& path = {}) const;
+    void setDir(const std::string& dir) noexcept;
+
+    // Estimated TSC ticks per nanosecond; spins for a few ms the first time.
+    double ticksPerNs() const noexcept;
+
+    // Every live recorder dumps into its dir on `sig` (default SIGUSR2).
+    static bool installSignalHandler(int sig = 0);
+
+    // Decoder side.
+    struct Event {
+        std::int64_t  wallNs;           // reconstructed from the dump's calibration
+        std::uint64_t tsc;
+        std::uint32_t thread;           // OS thread id
+        Kind          kind;
+        std::uint32_t aux;
+        unsigned char body[BODY];
+    };
+    struct Dump {
+        Reason reason;
+        std::int32_t pid;
+        std::int64_t wallNs;            // when the dump was taken
+        double ticksPerNs;
+        std::vector<std::pair<std::uint32_t, std::string>> threads;  // id, name
+        std::vector<Event> events;      // all threads, oldest first
+    };
+    static bool load(const std::string& path, Dump& out);
+
+private:
+    struct Ring {
+        std::atomic<std::uint64_t> head{0};
+        std::uint32_t tid = 0;
+        char name[16] = {};
+        Record recs[RING];
+    };
+    struct Local {                      // zero-initialised per thread
+        std::uint64_t owner;
+        Ring* ring;
+    };
+    static constexpr int LOCAL_CACHE = 4;
+    static inline thread_local Local locals_[LOCAL_CACHE];
+
+    Ring* local() noexcept {
+        for (Local& l : locals_)
+            if (l.owner == id_) return l.ring;
+        return claim();
+    }
+    Ring* claim() noexcept;
+    static constexpr std::size_t DIR_LEN = 256;
+    void nextDumpName(char (&out)[DIR_LEN + 64]) const noexcept;
+    bool dumpTo(const char* file, Reason why) const noexcept;
+    bool writeTo(int fd, Reason why) const noexcept;
+    static void onSignal(int sig);
+
+    std::uint64_t id_;
+    std::atomic<Ring*> rings_[MAX_THREADS] = {};
+    std::atomic<int> nRings_{0};
+    char dir_[DIR_LEN] = {};
+    mutable std::atomic<std::uint32_t> dumps_{0};
+    std::int64_t mono0_;
+    std::uint64_t tsc0_;
+    mutable std::atomic<double> ticksPerNs_{0.0};
+};
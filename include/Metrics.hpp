@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "ShmRegion.hpp"
+#include "SymbolTable.hpp"
+
+// Engine-wide counters and gauges. Every thread that records gets its own
+// cache-line-aligned block and only ever writes to it, so recording is a
+// plain load and store with no locked instruction and no false sharing;
+// readers sum the blocks. The registry lives in a shared-memory segment
+// (/dev/shm/tcx-metrics.<pid>.<n>) so tce_top can watch a running engine.
+enum class Metric : std::uint32_t {
+    MSGS_IN,            // pushed onto the inbound queue
+    MSGS_HANDLED,       // taken off it by the matching thread
+    EVENTS_OUT,         // pushed onto the outbound queue
+    EVENTS_POLLED,      // taken off it, or handed straight to the event handler
+    ORDERS,
+    CANCELS,
+    MODIFIES,
+    MASS_CANCELS,
+    ACKS,
+    REJECTS,
+    FILLS,
+    FILLED_QTY,
+    THROTTLED,          // refused at a full inbound queue or out of credits
+    CONFLATED,          // market data conflated or dropped at a full outbound queue
+    RESTING_ORDERS,     // gauges: set by the matching thread
+    BOOKS,
+    COUNT
+};
+constexpr std::uint32_t METRIC_COUNT = static_cast<std::uint32_t>(Metric::COUNT);
+
+inline const char* metricName(Metric m) noexcept
+{
+    static const char* const names[METRIC_COUNT] = {
+        "msgs_in", "msgs_handled", "events_out", "events_polled", "orders", "cancels",
+        "modifies", "mass_cancels", "acks", "rejects", "fills", "filled_qty",
+        "throttled", "conflated", "resting_orders", "books"};
+    return m < Metric::COUNT ? names[static_cast<std::uint32_t>(m)] : "?";
+}
+
+constexpr std::uint32_t METRICS_MAGIC   = 0x4d584354;    // "TCXM"
+constexpr std::uint32_t METRICS_VERSION = 2;
+constexpr std::uint32_t METRICS_THREADS = 64;            // the last one is shared
+constexpr std::uint32_t METRICS_BOOKS   = SymbolTable::DEFAULT_CAPACITY;
+
+struct alignas(64) MetricsBlock {
+    std::atomic<std::uint64_t> v[METRIC_COUNT];
+};
+
+struct MetricsRegion {
+    std::atomic<std::uint32_t> magic{0};        // written last
+    std::uint32_t version = METRICS_VERSION;
+    std::int32_t  pid = 0;
+    std::uint32_t metrics = METRIC_COUNT;
+    std::int64_t  startNs = 0;                  // wall clock at creation
+    std::atomic<std::uint32_t> threads{0};      // blocks handed out
+    std::atomic<std::uint32_t> books{0};        // 1 + highest book SymbolId seen
+
+    MetricsBlock block[METRICS_THREADS] = {};
+
+    // resting orders per book, indexed by SymbolId
+    struct Book {
+        std::atomic<std::uint32_t> orders{0};
+        char name[SHM_SYMBOL_LEN] = {};
+    } book[METRICS_BOOKS];
+};
+
+// Totals over all threads at one moment (blocks are read one by one, so a
+// reading can be a few increments inconsistent across metrics).
+struct MetricsSnapshot {
+    std::uint64_t v[METRIC_COUNT] = {};
+
+    std::uint64_t operator[](Metric m) const noexcept { return v[static_cast<std::uint32_t>(m)]; }
+    std::uint64_t inQueue() const noexcept  { return depth(Metric::MSGS_IN, Metric::MSGS_HANDLED); }
+    std::uint64_t outQueue() const noexcept { return depth(Metric::EVENTS_OUT, Metric::EVENTS_POLLED); }
+
+private:
+    std::uint64_t depth(Metric in, Metric out) const noexcept {
+        return (*this)[in] > (*this)[out] ? (*this)[in] - (*this)[out] : 0;
+    }
+};
+
+MetricsSnapshot readMetrics(const MetricsRegion& r) noexcept;
+
+class Metrics {
+public:
+    // Maps a fresh segment; falls back to private memory (not visible to
+    // tce_top, shmName() empty) if /dev/shm is unavailable.
+    Metrics();
+    ~Metrics() = default;
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    void add(Metric m, std::uint64_t n = 1) noexcept {
+        Local& l = local();
+        auto& c = l.block->v[static_cast<std::uint32_t>(m)];
+        if (l.shared) c.fetch_add(n, std::memory_order_relaxed);
+        else c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    // A gauge must be set from one thread only; readers sum it like a counter.
+    void set(Metric m, std::uint64_t value) noexcept {
+        local().block->v[static_cast<std::uint32_t>(m)].store(value, std::memory_order_relaxed);
+    }
+    // Matching thread only.
+    void setBookOrders(SymbolId sym, std::uint32_t orders, const std::string& name) noexcept;
+
+    MetricsSnapshot read() const noexcept { return readMetrics(*region_); }
+    std::uint32_t bookOrders(SymbolId sym) const noexcept {
+        return sym < METRICS_BOOKS ? region_->book[sym].orders.load(std::memory_order_relaxed) : 0;
+    }
+    const std::string& shmName() const noexcept { return name_; }
+
+private:
+    struct Local {                              // zero-initialised per thread
+        std::uint64_t owner;                    // registry id; 0 = unused
+        MetricsBlock* block;
+        bool shared;
+    };
+    static constexpr int LOCAL_CACHE = 4;       // registries a thread records into
+    static inline thread_local Local locals_[LOCAL_CACHE];
+
+    Local& local() noexcept {
+        for (Local& l : locals_)
+            if (l.owner == id_) return l;
+        return claim();
+    }
+    Local& claim() noexcept;
+
+    std::uint64_t id_;
+    std::string name_;
+    ShmMapping map_;
+    std::unique_ptr<MetricsRegion> heap_;
+    MetricsRegion* region_;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "ShmRegion.hpp"
+
+// Client side of the shared-memory transport, for a process other than the
+// engine's. Requests go onto the client's own SPSC ring; events are read
+// from the broadcast ring, which carries every client's acks, rejects and
+// fills as well as market data. Not thread-safe: use one client per thread.
+class ShmClient {
+public:
+    // Maps /dev/shm/<name> and claims a free slot bound to `account`.
+    // Returns nullptr if no engine serves `name`, all slots are taken, or the
+    // gateway does not pick the slot up within timeoutMs.
+    static std::unique_ptr<ShmClient> connect(const std::string &name, AccountId account,
+                                              bool cancelOnDisconnect, int timeoutMs = 1000);
+    ~ShmClient();
+
+    ShmClient(const ShmClient &) = delete;
+    ShmClient &operator=(const ShmClient &) = delete;
+
+    // Spins while the request ring is full. NEW_ORDER and BOOK_SNAPSHOT get a
+    // client id (one is assigned if 0) tagged with the slot; that id is
+    // returned, else 0.
+    // Returns 0 without sending once the engine has gone away.
+    std::uint64_t send(InboundMsg msg);
+    // Requests that fit in the ring now. The gateway drains a ring only as
+    // far as the engine grants the session credits, so this is the
+    // client's end of the engine's flow control.
+    std::size_t credits() const noexcept {
+        return SHM_REQUEST_RING - region_->clients[slot_].requests.size();
+    }
+
+    // Next event from the broadcast ring; false if there is none yet.
+    bool next(OutboundMsg &out);
+    // Events this client missed because it fell a full ring behind.
+    std::uint64_t lost() const noexcept { return lost_; }
+
+    // Known symbols resolve from the shared directory; unknown ones are
+    // interned by the engine (a round trip through the gateway).
+    SymbolId symbolId(const std::string &symbol);
+    const char *symbolName(SymbolId id) const noexcept;
+
+    bool connected() const noexcept;
+    std::uint32_t slot() const noexcept { return slot_; }
+    AccountId account() const noexcept { return region_->clients[slot_].account; }
+
+private:
+    ShmClient(ShmMapping map, std::uint32_t slot);
+
+    void refreshSymbols();
+
+    ShmMapping map_;
+    ShmRegion *region_;
+    std::uint32_t slot_;
+    std::uint64_t cursor_ = 0;
+    std::uint64_t lost_ = 0;
+    std::uint64_t nextClientId_ = 0;
+    SymbolId knownSymbols_ = 1;
+    std::unordered_map<std::string, SymbolId> symbolIds_;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "EngineRunner.hpp"
+#include "ShmRegion.hpp"
+#include "ThreadConfig.hpp"
+
+// Engine side of the shared-memory transport. Owns /dev/shm/<name> and one
+// thread that drains every client's request ring into the runner and copies
+// the runner's events onto the broadcast ring. The gateway must be the
+// runner's only consumer: nothing else may call runner.poll() while it runs.
+//
+// Each client slot is bound to a runner session. Orders and mass cancels are
+// stamped with the slot's account, and a client that disconnects (or whose
+// process dies) has its session closed.
+class ShmGateway {
+public:
+    // Returns nullptr if the segment cannot be created. With cfg.busyPoll the
+    // thread spins when idle; otherwise it naps for a few microseconds.
+    static std::unique_ptr<ShmGateway> open(EngineRunner &runner, const std::string &name,
+                                            const ThreadConfig &cfg = {});
+    ~ShmGateway();
+
+    ShmGateway(const ShmGateway &) = delete;
+    ShmGateway &operator=(const ShmGateway &) = delete;
+
+    std::uint32_t clients() const noexcept;
+
+private:
+    ShmGateway(EngineRunner &runner, ShmMapping map, const ThreadConfig &cfg);
+
+    void loop();
+    bool serviceSlot(std::uint32_t i, bool checkLiveness);
+    void mirrorSymbols();
+
+    EngineRunner &runner_;
+    ShmMapping map_;
+    ShmRegion *region_;
+    SessionId sessions_[SHM_MAX_CLIENTS] = {};
+    std::thread thread_;
+    std::atomic<bool> running_{true};
+    bool busyPoll_;
+};
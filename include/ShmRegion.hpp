@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "BroadcastRing.hpp"
+#include "Messages.hpp"
+#include "SpscRing.hpp"
+
+// Layout of the shared-memory segment (/dev/shm/<name>) that connects
+// out-of-process clients to an engine. The engine side (ShmGateway) creates
+// it; clients (ShmClient) map it and claim a slot. Everything in it is
+// trivially copyable or a lock-free atomic, so it works across processes.
+constexpr std::uint32_t SHM_MAGIC        = 0x31584354;   // "TCX1"
+constexpr std::uint32_t SHM_VERSION      = 1;
+constexpr std::uint32_t SHM_MAX_CLIENTS  = 32;
+constexpr std::size_t   SHM_REQUEST_RING = 1024;         // per client
+constexpr std::size_t   SHM_EVENT_RING   = 64 * 1024;    // shared by all clients
+constexpr std::size_t   SHM_SYMBOL_LEN   = 32;           // incl. terminator
+
+// The low byte of a slot's state word; see shmReservedBy() for the rest.
+enum class ShmSlotState : std::uint32_t {
+    FREE = 0,
+    RESERVED,   // a client won the slot and is filling it in
+    CLAIMED,    // slot filled in, gateway has not opened a session yet
+    ACTIVE,
+    CLOSING     // client is gone; gateway drains the ring and frees the slot
+};
+constexpr std::uint32_t SHM_STATE_MASK = 0xFF;
+
+// A client reserves a slot with its pid in the upper bits of the same word,
+// so the gateway can free a reservation whose process died before claiming.
+inline std::uint32_t shmReservedBy(std::int32_t pid) noexcept {
+    return (static_cast<std::uint32_t>(pid) << 8) | static_cast<std::uint32_t>(ShmSlotState::RESERVED);
+}
+
+struct ShmClientSlot {
+    std::atomic<std::uint32_t> state{0};
+    AccountId     account = 0;
+    std::int32_t  pid = 0;                    // for liveness checks
+    std::uint32_t cancelOnDisconnect = 0;
+
+    // symbol lookups the client cannot answer from the directory
+    std::atomic<std::uint32_t> internReq{0};  // bumped by the client
+    std::atomic<std::uint32_t> internDone{0}; // set to internReq when answered
+    SymbolId      internId = SymbolTable::NONE;
+    char          internName[SHM_SYMBOL_LEN] = {};
+
+    SpscRing<InboundMsg, SHM_REQUEST_RING> requests;
+};
+
+struct ShmRegion {
+    std::atomic<std::uint32_t> magic{0};      // written last by the gateway
+    std::uint32_t version = SHM_VERSION;
+    std::int32_t  serverPid = 0;
+    std::uint32_t maxClients = SHM_MAX_CLIENTS;
+
+    // mirror of the engine's SymbolTable; entry i is symbol id i
+    std::atomic<std::uint32_t> symbolCount{1};
+    char symbols[SymbolTable::DEFAULT_CAPACITY][SHM_SYMBOL_LEN] = {};
+
+    ShmClientSlot clients[SHM_MAX_CLIENTS];
+    BroadcastRing<OutboundMsg, SHM_EVENT_RING> events;
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free &&
+              std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared-memory atomics must be lock-free to be process-shared");
+
+// Client ids carry the slot in their top 16 bits so ids minted by different
+// processes cannot collide on the shared event ring.
+inline std::uint64_t shmClientId(std::uint32_t slot, std::uint64_t id) noexcept {
+    return (std::uint64_t{slot + 1} << 48) | (id & ((std::uint64_t{1} << 48) - 1));
+}
+
+// RAII mapping of a named POSIX shared-memory object.
+class ShmMapping {
+public:
+    ShmMapping() = default;
+    ~ShmMapping();
+    ShmMapping(ShmMapping &&o) noexcept;
+    ShmMapping &operator=(ShmMapping &&o) noexcept;
+    ShmMapping(const ShmMapping &) = delete;
+    ShmMapping &operator=(const ShmMapping &) = delete;
+
+    // create = true makes (or replaces) the object and unlinks it again when
+    // the mapping is destroyed. Returns an unmapped object on failure.
+    static ShmMapping open(const std::string &name, std::size_t size, bool create);
+
+    void *data() const noexcept { return addr_; }
+    explicit operator bool() const noexcept { return addr_ != nullptr; }
+
+private:
+    std::string name_;
+    void *addr_ = nullptr;
+    std::size_t size_ = 0;
+    bool owner_ = false;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "Price.hpp"
+
+using SymbolId = std::uint32_t;
+
+// Interns symbol strings to dense ids so messages can carry a 4-byte id
+// instead of a std::string. Registration takes a lock; name() is lock-free
+// because slots are preallocated and published with a release store.
+class SymbolTable {
+public:
+    static constexpr SymbolId NONE = 0;
+    static constexpr SymbolId DEFAULT_CAPACITY = 4096;
+
+    explicit SymbolTable(SymbolId capacity = DEFAULT_CAPACITY);
+
+    // Returns NONE for an empty symbol or when the table is full.
+    SymbolId intern(const std::string &symbol);
+    SymbolId find(const std::string &symbol) const;
+    const std::string &name(SymbolId id) const noexcept;
+
+    // Price granularity of an interned symbol, in ticks (default 1). Can be
+    // changed from any thread; orders already resting keep their prices.
+    bool setTickSize(SymbolId id, PxTicks tickSize) noexcept;
+    PxTicks tickSize(SymbolId id) const noexcept {
+        return id < capacity_ ? tickSizes_[id].load(std::memory_order_relaxed) : 1;
+    }
+
+    SymbolId size() const noexcept { return count_.load(std::memory_order_acquire); }
+    SymbolId capacity() const noexcept { return capacity_; }
+
+private:
+    SymbolId capacity_;
+    std::unique_ptr<std::string[]> names_;
+    std::unique_ptr<std::atomic<PxTicks>[]> tickSizes_;
+    std::atomic<SymbolId> count_{1};                // slot 0 is NONE
+    std::unordered_map<std::string, SymbolId> ids_;
+    mutable std::mutex mtx_;
+};
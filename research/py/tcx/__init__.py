@@ -1,6 +1,6 @@
 from ._ffi import BUY, SELL, LIMIT, MARKET, STOP
 from .engine import Engine
-from .event  import EventType, Trade, TopOfBook
+from .event  import EventType, Trade, TopOfBook, Reject
 
 __all__ = ["Engine", "BUY", "SELL", "LIMIT", "MARKET", "STOP",
-           "EventType", "Trade", "TopOfBook"]
+           "EventType", "Trade", "TopOfBook", "Reject"]
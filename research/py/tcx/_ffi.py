@@ -25,17 +25,39 @@ else:
 
 lib = ctypes.CDLL(str(_dll_path))
 
-class _Evt(ctypes.Structure):
-    _fields_=[('type',   ctypes.c_int),
-              ('symbol', ctypes.c_char*16),
-              ('buyId',  ctypes.c_int),
-              ('sellId', ctypes.c_int),
-              ('qty',    ctypes.c_int),
-              ('px',     ctypes.c_double),
-              ('bidPx',  ctypes.c_double),
-              ('bidQty', ctypes.c_int),
-              ('askPx',  ctypes.c_double),
-              ('askQty', ctypes.c_int)]
+class _Evt(ctypes.Structure):                   # struct tcx_evt, 64 bytes
+    class _Body(ctypes.Union):
+        class _Trade(Structure):
+            _fields_=[('px', ctypes.c_int64), ('buyId', ctypes.c_int64),
+                      ('sellId', ctypes.c_int64), ('qty', ctypes.c_int32)]
+        class _Tob(Structure):
+            _fields_=[('bidPx', ctypes.c_int64), ('askPx', ctypes.c_int64),
+                      ('bidQty', ctypes.c_int32), ('askQty', ctypes.c_int32)]
+        class _Reject(Structure):
+            _fields_=[('orderId', ctypes.c_int64), ('clientId', ctypes.c_uint64),
+                      ('reason', ctypes.c_uint8)]
+        class _MassCancel(Structure):
+            _fields_=[('account', ctypes.c_uint32), ('count', ctypes.c_int32)]
+        class _Ack(Structure):
+            _fields_=[('orderId', ctypes.c_int64), ('clientId', ctypes.c_uint64)]
+        class _L3(Structure):
+            _fields_=[('seq', ctypes.c_uint64), ('orderId', ctypes.c_int64),
+                      ('px', ctypes.c_int64), ('clientId', ctypes.c_uint64),
+                      ('qty', ctypes.c_int32), ('side', ctypes.c_uint8),
+                      ('kind', ctypes.c_uint8)]
+        class _Bar(Structure):
+            _fields_=[('startNs', ctypes.c_int64), ('open', ctypes.c_int64),
+                      ('high', ctypes.c_int64), ('low', ctypes.c_int64),
+                      ('close', ctypes.c_int64), ('vwap', ctypes.c_int64),
+                      ('volume', ctypes.c_int64)]
+        _fields_=[('trade', _Trade), ('tob', _Tob), ('reject', _Reject),
+                  ('massCancel', _MassCancel), ('ack', _Ack), ('l3', _L3),
+                  ('bar', _Bar)]
+    _anonymous_=('body',)
+    _fields_=[('type',     ctypes.c_uint8),
+              ('_pad',     ctypes.c_uint8*3),
+              ('symbolId', ctypes.c_uint32),
+              ('body',     _Body)]
 lib.tcx_poll.argtypes        = (c_void_p,)          # already set
 lib.tcx_next_event.argtypes  = (c_void_p, ctypes.POINTER(_Evt))
 lib.tcx_next_event.restype   = c_int
@@ -55,10 +77,10 @@ lib.tcx_order_free.argtypes = (c_void_p,)
 
 # submit / cancel / modify
 lib.tcx_submit.argtypes = (c_void_p, c_void_p)
-lib.tcx_submit.restype  = c_int
+lib.tcx_submit.restype  = ctypes.c_uint64
 
-lib.tcx_cancel.argtypes = (c_void_p, c_int)
-lib.tcx_modify.argtypes = (c_void_p, c_int, c_double, c_int)
+lib.tcx_cancel.argtypes = (c_void_p, ctypes.c_int64)
+lib.tcx_modify.argtypes = (c_void_p, ctypes.c_int64, c_double, c_int)
 
 # poll (‼ MUST have argtypes or we crash ‼)
 lib.tcx_poll.argtypes = (c_void_p,)
@@ -66,7 +88,7 @@ lib.tcx_poll.restype  = None
 
 # depth
 class _Level(Structure):
-    _fields_ = [("px",  c_double),
+    _fields_ = [("px",  ctypes.c_int64),
                 ("qty", c_int)]
 
 lib.tcx_depth.argtypes = (c_void_p, c_char_p,
@@ -9,7 +9,7 @@ Only the functionality needed by research scripts is exposed:
 """
 
 from __future__ import annotations
-import ctypes, pathlib, sys
+import asyncio, ctypes, pathlib, sys
 from enum import IntEnum
 from typing import List, Tuple
 import os 
@@ -45,25 +45,118 @@ class OrdType(IntEnum): LIMIT = 1; MARKET = 2; STOP = 3
 BUY, SELL   = Side.BUY, Side.SELL
 LIMIT, MARKET, STOP = (OrdType.LIMIT, OrdType.MARKET, OrdType.STOP)
 
-class EventType(IntEnum): TRADE = 1; TOB = 2
+class EventType(IntEnum): TRADE = 0; TOB = 1; REJECT = 2; MASS_CANCEL = 3; ACK = 4; L3 = 5; BAR = 6
+class Overflow(IntEnum): BLOCK = 0; REJECT = 1; CONFLATE = 2
+NO_SESSION = 0xffffffff                         # TCX_NO_SESSION
+class L3Kind(IntEnum):
+    ADD = 0; MODIFY = 1; CANCEL = 2; EXEC = 3
+    SNAPSHOT_BEGIN = 4; SNAPSHOT_ORDER = 5; SNAPSHOT_END = 6
 
 class _Depth(ctypes.Structure):
-    _fields_ = [("px",  ctypes.c_double),
+    _fields_ = [("px",  ctypes.c_int64),
                 ("qty", ctypes.c_int)]
 
-class _Evt(ctypes.Structure):
-    _fields_ = [("type",    ctypes.c_int),
-                ("symbol",  ctypes.c_char * 16),
-                ("buyId",   ctypes.c_int),
-                ("sellId",  ctypes.c_int),
-                ("qty",     ctypes.c_int),
-                ("px",      ctypes.c_double),
-                ("bidPx",   ctypes.c_double),
-                ("bidQty",  ctypes.c_int),
-                ("askPx",   ctypes.c_double),
-                ("askQty",  ctypes.c_int)]
+PX_SCALE = 10000                                # TCX_PX_SCALE
+
+class _TradeBody(ctypes.Structure):
+    _fields_ = [("px",      ctypes.c_int64),
+                ("buyId",   ctypes.c_int64),
+                ("sellId",  ctypes.c_int64),
+                ("qty",     ctypes.c_int32)]
+
+class _TobBody(ctypes.Structure):
+    _fields_ = [("bidPx",   ctypes.c_int64),
+                ("askPx",   ctypes.c_int64),
+                ("bidQty",  ctypes.c_int32),
+                ("askQty",  ctypes.c_int32)]
+
+class _RejectBody(ctypes.Structure):
+    _fields_ = [("orderId",  ctypes.c_int64),
+                ("clientId", ctypes.c_uint64),
+                ("reason",   ctypes.c_uint8)]
+
+class _MassCancelBody(ctypes.Structure):
+    _fields_ = [("account", ctypes.c_uint32),
+                ("count",   ctypes.c_int32)]
+
+class _AckBody(ctypes.Structure):
+    _fields_ = [("orderId",  ctypes.c_int64),
+                ("clientId", ctypes.c_uint64)]
+
+class _L3Body(ctypes.Structure):
+    _fields_ = [("seq",      ctypes.c_uint64),
+                ("orderId",  ctypes.c_int64),
+                ("px",       ctypes.c_int64),
+                ("clientId", ctypes.c_uint64),
+                ("qty",      ctypes.c_int32),
+                ("side",     ctypes.c_uint8),
+                ("kind",     ctypes.c_uint8)]
+
+class _BarBody(ctypes.Structure):
+    _fields_ = [("startNs", ctypes.c_int64),
+                ("open",    ctypes.c_int64),
+                ("high",    ctypes.c_int64),
+                ("low",     ctypes.c_int64),
+                ("close",   ctypes.c_int64),
+                ("vwap",    ctypes.c_int64),
+                ("volume",  ctypes.c_int64)]
+
+class _EvtBody(ctypes.Union):
+    _fields_ = [("trade",      _TradeBody),
+                ("tob",        _TobBody),
+                ("reject",     _RejectBody),
+                ("massCancel", _MassCancelBody),
+                ("ack",        _AckBody),
+                ("l3",         _L3Body),
+                ("bar",        _BarBody)]
+
+class _Evt(ctypes.Structure):                   # struct tcx_evt, 64 bytes
+    _anonymous_ = ("body",)
+    _fields_ = [("type",      ctypes.c_uint8),
+                ("_pad",      ctypes.c_uint8 * 3),
+                ("symbolId",  ctypes.c_uint32),
+                ("body",      _EvtBody)]
+
+class _BarStats(ctypes.Structure):              # struct tcx_bar
+    _fields_ = [("startNs", ctypes.c_int64),
+                ("open", ctypes.c_int64), ("high", ctypes.c_int64),
+                ("low", ctypes.c_int64), ("close", ctypes.c_int64),
+                ("vwap", ctypes.c_int64),
+                ("volume", ctypes.c_int64), ("trades", ctypes.c_uint64)]
+
+class _TradeStats(ctypes.Structure):            # struct tcx_trade_stats
+    _fields_ = [("last", ctypes.c_int64), ("lastQty", ctypes.c_int64),
+                ("lastNs", ctypes.c_int64),
+                ("open", ctypes.c_int64), ("high", ctypes.c_int64),
+                ("low", ctypes.c_int64), ("vwap", ctypes.c_int64),
+                ("volume", ctypes.c_int64), ("trades", ctypes.c_uint64),
+                ("bar", _BarStats)]
+
+_METRICS = ("msgs_in", "msgs_handled", "in_queue", "events_out", "events_polled",
+            "out_queue", "orders", "cancels", "modifies", "mass_cancels", "acks",
+            "rejects", "fills", "filled_qty", "throttled", "conflated",
+            "resting_orders", "books")
+
+class _Metrics(ctypes.Structure):               # struct tcx_engine_metrics
+    _fields_ = [(name, ctypes.c_uint64) for name in _METRICS]
+
+class _FlowCfg(ctypes.Structure):               # struct tcx_flow_cfg
+    _fields_ = [("inCapacity", ctypes.c_uint64), ("outCapacity", ctypes.c_uint64),
+                ("sessionCredits", ctypes.c_uint32),
+                ("inbound", ctypes.c_uint8), ("outbound", ctypes.c_uint8)]
 
 lib.tcx_create_engine.restype = ctypes.c_void_p
+
+class _ThreadCfg(ctypes.Structure):
+    _fields_ = [("cpus", ctypes.POINTER(ctypes.c_int)), ("nCpus", ctypes.c_int),
+                ("fifoPriority", ctypes.c_int), ("numaNode", ctypes.c_int),
+                ("busyPoll", ctypes.c_int)]
+class _PrewarmCfg(ctypes.Structure):
+    _fields_ = [("symbols", ctypes.POINTER(ctypes.c_char_p)), ("nSymbols", ctypes.c_int),
+                ("ordersPerBook", ctypes.c_int), ("warmupRounds", ctypes.c_int),
+                ("lockMemory", ctypes.c_int)]
+lib.tcx_create_engine_cfg.argtypes = [ctypes.POINTER(_ThreadCfg), ctypes.POINTER(_PrewarmCfg)]
+lib.tcx_create_engine_cfg.restype  = ctypes.c_void_p
 lib.tcx_destroy_engine.argtypes = [ctypes.c_void_p]
 
 lib.tcx_order_new.restype = ctypes.c_void_p
@@ -72,17 +165,81 @@ lib.tcx_order_new.argtypes = [ctypes.c_char_p,
                               ctypes.c_double, ctypes.c_int]
 
 lib.tcx_order_free.argtypes = [ctypes.c_void_p]
+lib.tcx_order_set_account.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+lib.tcx_order_set_client_id.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+
+lib.tcx_set_risk_limits.argtypes = [ctypes.c_void_p, ctypes.c_uint32,
+                                    ctypes.c_int, ctypes.c_double,
+                                    ctypes.c_int, ctypes.c_int64]
+lib.tcx_set_risk_limits.restype  = ctypes.c_int
+lib.tcx_position.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32]
+lib.tcx_position.restype  = ctypes.c_int64
 
 lib.tcx_submit.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
-lib.tcx_submit.restype  = ctypes.c_int
+lib.tcx_submit.restype  = ctypes.c_uint64
+lib.tcx_await_ack.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_int]
+lib.tcx_await_ack.restype  = ctypes.c_int64
+lib.tcx_shard_of.argtypes  = [ctypes.c_int64]
+lib.tcx_l3_enable.argtypes   = [ctypes.c_void_p, ctypes.c_int]
+lib.tcx_l3_snapshot.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+lib.tcx_l3_snapshot.restype  = ctypes.c_uint64
+
+lib.tcx_stats.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(_TradeStats)]
+lib.tcx_stats.restype  = ctypes.c_int
+lib.tcx_set_bar_interval.argtypes = [ctypes.c_void_p, ctypes.c_int64]
+
+lib.tcx_record_tape.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+lib.tcx_record_tape.restype  = ctypes.c_int
+lib.tcx_metrics.argtypes = [ctypes.c_void_p, ctypes.POINTER(_Metrics)]
+lib.tcx_metrics.restype  = None
+lib.tcx_book_orders.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+lib.tcx_book_orders.restype  = ctypes.c_uint32
+lib.tcx_metrics_shm.argtypes = [ctypes.c_void_p]
+lib.tcx_metrics_shm.restype  = ctypes.c_char_p
+lib.tcx_flight_dump.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int]
+lib.tcx_flight_dump.restype  = ctypes.c_int
+lib.tcx_flight_latency_dump.argtypes = [ctypes.c_void_p, ctypes.c_int64]
 
-lib.tcx_cancel.argtypes = [ctypes.c_void_p, ctypes.c_int]
-lib.tcx_modify.argtypes = [ctypes.c_void_p, ctypes.c_int,
+lib.tcx_cancel.argtypes = [ctypes.c_void_p, ctypes.c_int64]
+lib.tcx_modify.argtypes = [ctypes.c_void_p, ctypes.c_int64,
                            ctypes.c_double, ctypes.c_int]
 
 lib.tcx_poll.argtypes   = [ctypes.c_void_p]
+lib.tcx_event_fd.argtypes = [ctypes.c_void_p]
+lib.tcx_event_fd.restype  = ctypes.c_int
 lib.tcx_next_event.argtypes = [ctypes.c_void_p, ctypes.POINTER(_Evt)]
 lib.tcx_next_event.restype  = ctypes.c_int
+lib.tcx_subscribe.argtypes   = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32]
+lib.tcx_subscribe.restype    = ctypes.c_void_p
+lib.tcx_sub_next.argtypes    = [ctypes.c_void_p, ctypes.POINTER(_Evt)]
+lib.tcx_sub_next.restype     = ctypes.c_int
+lib.tcx_sub_lost.argtypes    = [ctypes.c_void_p]
+lib.tcx_sub_lost.restype     = ctypes.c_uint64
+lib.tcx_unsubscribe.argtypes = [ctypes.c_void_p]
+
+lib.tcx_symbol_id.argtypes   = [ctypes.c_void_p, ctypes.c_char_p]
+lib.tcx_symbol_id.restype    = ctypes.c_uint32
+lib.tcx_symbol_name.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+lib.tcx_symbol_name.restype  = ctypes.c_char_p
+lib.tcx_set_tick_size.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_int64]
+lib.tcx_set_tick_size.restype  = ctypes.c_int
+lib.tcx_tick_size.argtypes     = [ctypes.c_void_p, ctypes.c_uint32]
+lib.tcx_tick_size.restype      = ctypes.c_int64
+
+lib.tcx_mass_cancel.argtypes   = [ctypes.c_void_p, ctypes.c_uint32,
+                                  ctypes.c_uint32, ctypes.c_int]
+lib.tcx_auction_start.argtypes   = [ctypes.c_void_p, ctypes.c_uint32]
+lib.tcx_auction_uncross.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_int]
+lib.tcx_session_open.argtypes  = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_int]
+lib.tcx_session_open.restype   = ctypes.c_uint32
+lib.tcx_session_close.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+lib.tcx_set_flow_control.argtypes = [ctypes.c_void_p, ctypes.POINTER(_FlowCfg)]
+lib.tcx_set_flow_control.restype  = ctypes.c_int
+lib.tcx_credits.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+lib.tcx_credits.restype  = ctypes.c_int64
+
+lib.tcx_reject_text.argtypes = [ctypes.c_int]
+lib.tcx_reject_text.restype  = ctypes.c_char_p
 
 lib.tcx_depth.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_int,
                           ctypes.POINTER(_Depth), ctypes.POINTER(ctypes.c_int),
@@ -122,20 +279,269 @@ class TopOfBook(tuple):
     def ask_qty(self): return self[4]
     type = EventType.TOB
 
+class Reject(tuple):
+    __slots__ = ()
+    def __new__(cls, sym, order_id, reason, client_id=0):
+        return super().__new__(cls, (sym, order_id, reason, client_id))
+    @property
+    def symbol  (self): return self[0]
+    @property
+    def order_id(self): return self[1]
+    @property
+    def reason  (self): return self[2]
+    @property
+    def client_id(self): return self[3]
+    @property
+    def text    (self): return lib.tcx_reject_text(self[2]).decode()
+    type = EventType.REJECT
+
+class Ack(tuple):
+    __slots__ = ()
+    def __new__(cls, sym, order_id, client_id):
+        return super().__new__(cls, (sym, order_id, client_id))
+    @property
+    def symbol   (self): return self[0]
+    @property
+    def order_id (self): return self[1]
+    @property
+    def client_id(self): return self[2]
+    @property
+    def shard    (self): return lib.tcx_shard_of(self[1])
+    type = EventType.ACK
+
+class MassCancel(tuple):
+    __slots__ = ()
+    def __new__(cls, sym, account, count):
+        return super().__new__(cls, (sym, account, count))
+    @property
+    def symbol (self): return self[0]
+    @property
+    def account(self): return self[1]
+    @property
+    def count  (self): return self[2]
+    type = EventType.MASS_CANCEL
+
+class BookUpdate(tuple):
+    """One L3 feed event; see tcx_l3_kind in api_c.h for qty's meaning."""
+    __slots__ = ()
+    def __new__(cls, sym, kind, seq, order_id, side, px, qty, client_id=0):
+        return super().__new__(cls, (sym, kind, seq, order_id, side, px, qty, client_id))
+    @property
+    def symbol   (self): return self[0]
+    @property
+    def kind     (self): return self[1]
+    @property
+    def seq      (self): return self[2]
+    @property
+    def order_id (self): return self[3]
+    @property
+    def side     (self): return self[4]
+    @property
+    def px       (self): return self[5]
+    @property
+    def qty      (self): return self[6]
+    @property
+    def client_id(self): return self[7]
+    type = EventType.L3
+
+class Bar(tuple):
+    """A closed bar (BAR event), or the open one inside Stats."""
+    __slots__ = ()
+    def __new__(cls, sym, start_ns, o, h, l, c, vwap, volume, trades=0):
+        return tuple.__new__(cls, (sym, start_ns, o, h, l, c, vwap, volume, trades))
+    @property
+    def symbol  (self): return self[0]
+    @property
+    def start_ns(self): return self[1]
+    @property
+    def open    (self): return self[2]
+    @property
+    def high    (self): return self[3]
+    @property
+    def low     (self): return self[4]
+    @property
+    def close   (self): return self[5]
+    @property
+    def vwap    (self): return self[6]
+    @property
+    def volume  (self): return self[7]
+    @property
+    def trades  (self): return self[8]          # 0 on BAR events
+    type = EventType.BAR
+
+class Stats(tuple):
+    """Running statistics of one symbol; see Engine.stats()."""
+    __slots__ = ()
+    def __new__(cls, sym, last, last_qty, last_ns, o, h, l, vwap, volume, trades, bar):
+        return tuple.__new__(cls, (sym, last, last_qty, last_ns, o, h, l, vwap,
+                                   volume, trades, bar))
+    @property
+    def symbol  (self): return self[0]
+    @property
+    def last    (self): return self[1]
+    @property
+    def last_qty(self): return self[2]
+    @property
+    def last_ns (self): return self[3]
+    @property
+    def open    (self): return self[4]
+    @property
+    def high    (self): return self[5]
+    @property
+    def low     (self): return self[6]
+    @property
+    def vwap    (self): return self[7]
+    @property
+    def volume  (self): return self[8]
+    @property
+    def trades  (self): return self[9]
+    @property
+    def bar     (self): return self[10]         # None if no bar is open
+
 class Engine:
-    def __init__(self):
-        self._h = lib.tcx_create_engine()
+    def __init__(self, cpus:list[int]|None=None, fifo_priority:int=0,
+                 numa_node:int=-1, busy_poll:bool=False,
+                 prewarm:list[str]|None=None, orders_per_book:int=1024,
+                 warmup_rounds:int=256, lock_memory:bool=False):
+        if cpus or fifo_priority or numa_node >= 0 or busy_poll or prewarm or lock_memory:
+            arr = (ctypes.c_int * len(cpus or []))(*(cpus or []))
+            cfg = _ThreadCfg(arr, len(arr), fifo_priority, numa_node, int(busy_poll))
+            syms = (ctypes.c_char_p * len(prewarm or []))(*(s.encode() for s in prewarm or []))
+            warm = _PrewarmCfg(syms, len(syms), orders_per_book, warmup_rounds, int(lock_memory))
+            self._h = lib.tcx_create_engine_cfg(ctypes.byref(cfg), ctypes.byref(warm))
+        else:
+            self._h = lib.tcx_create_engine()
+        self._syms: dict[int, str] = {}
+
+    def _symbol(self, sid:int) -> str:
+        name = self._syms.get(sid)
+        if name is None:
+            name = self._syms[sid] = lib.tcx_symbol_name(self._h, sid).decode()
+        return name
 
-    def _new_order(self, sym:str, side:Side, typ:OrdType, px:float, qty:int):
+    def _new_order(self, sym:str, side:Side, typ:OrdType, px:float, qty:int,
+                   account:int=0):
+        """Returns the engine-assigned order id once acked, -1 if rejected."""
         ptr = lib.tcx_order_new(sym.encode(), side, typ, px, qty)
-        oid = lib.tcx_submit(self._h, ptr)
+        if account:
+            lib.tcx_order_set_account(ptr, account)
+        cid = lib.tcx_submit(self._h, ptr)
         lib.tcx_order_free(ptr) 
-        return oid
+        return lib.tcx_await_ack(self._h, cid, 1000)
+
+    def submit_limit (self, sym, side, px, qty, account=0):
+        return self._new_order(sym, side, LIMIT , px, qty, account)
+    def submit_market(self, sym, side, qty, account=0):
+        return self._new_order(sym, side, MARKET, 0.0, qty, account)
+
+    def mass_cancel(self, account:int, sym:str|None=None, side:Side|None=None):
+        sid = lib.tcx_symbol_id(self._h, sym.encode()) if sym else 0
+        lib.tcx_mass_cancel(self._h, account, sid, -1 if side is None else side)
+
+    def auction_start(self, sym:str|None=None):
+        sid = lib.tcx_symbol_id(self._h, sym.encode()) if sym else 0
+        lib.tcx_auction_start(self._h, sid)
+
+    def auction_uncross(self, sym:str|None=None, resume:bool=True):
+        sid = lib.tcx_symbol_id(self._h, sym.encode()) if sym else 0
+        lib.tcx_auction_uncross(self._h, sid, int(resume))
+
+    def open_session(self, account:int, cancel_on_disconnect:bool=True) -> int:
+        return lib.tcx_session_open(self._h, account, int(cancel_on_disconnect))
+
+    def close_session(self, session:int):
+        lib.tcx_session_close(self._h, session)
+
+    def set_flow_control(self, in_capacity:int=64*1024, out_capacity:int=1024*1024,
+                         session_credits:int=4096, inbound:Overflow=Overflow.BLOCK,
+                         outbound:Overflow=Overflow.CONFLATE):
+        """Bounds the engine's queues (0: unbounded). A full inbound queue
+        makes calls wait (BLOCK) or refuses them with a THROTTLED reject
+        (REJECT); a full outbound queue stops matching (BLOCK) or conflates
+        market data (CONFLATE). See tcx_flow_cfg in api_c.h."""
+        cfg = _FlowCfg(in_capacity, out_capacity, session_credits, inbound, outbound)
+        if lib.tcx_set_flow_control(self._h, ctypes.byref(cfg)) != 0:
+            raise ValueError(f"unsupported policy: inbound {inbound!r}, outbound {outbound!r}")
+
+    def credits(self, session:int|None=None) -> int:
+        """Messages that can be sent now without waiting or being refused."""
+        return lib.tcx_credits(self._h, NO_SESSION if session is None else session)
 
-    def submit_limit (self, sym, side, px, qty):
-        return self._new_order(sym, side, LIMIT , px, qty)
-    def submit_market(self, sym, side, qty):
-        return self._new_order(sym, side, MARKET, 0.0, qty)
+    def set_risk_limits(self, account:int, max_order_qty:int=0,
+                        max_notional:float=0.0, max_open_orders:int=0,
+                        max_position:int=0):
+        """Per-account pre-trade limits; 0 leaves a limit unbounded."""
+        if lib.tcx_set_risk_limits(self._h, account, max_order_qty,
+                                   max_notional, max_open_orders,
+                                   max_position) != 0:
+            raise ValueError(f"account {account} out of range")
+
+    def position(self, account:int, sym:str) -> int:
+        sid = lib.tcx_symbol_id(self._h, sym.encode())
+        return lib.tcx_position(self._h, account, sid)
+
+    def enable_l3(self, on:bool=True):
+        lib.tcx_l3_enable(self._h, int(on))
+
+    def l3_snapshot(self, sym:str) -> int:
+        """Requests the book's resting orders on the L3 feed; returns the
+        client id carried by the snapshot's events."""
+        return lib.tcx_l3_snapshot(self._h, lib.tcx_symbol_id(self._h, sym.encode()))
+
+    def set_tick_size(self, sym:str, tick:float):
+        """Limit prices of sym must be multiples of tick from now on; others
+        are rejected with BAD_PRICE."""
+        if lib.tcx_set_tick_size(self._h, lib.tcx_symbol_id(self._h, sym.encode()),
+                                 round(tick * PX_SCALE)) != 0:
+            raise ValueError(f"bad tick size {tick} for {sym}")
+
+    def tick_size(self, sym:str) -> float:
+        return lib.tcx_tick_size(self._h, lib.tcx_symbol_id(self._h, sym.encode())) / PX_SCALE
+
+    def stats(self, sym:str) -> Stats|None:
+        """Running last / OHLC / VWAP / volume of a symbol; None before its
+        first trade. Reads a published snapshot, never the trade history."""
+        st = _TradeStats()
+        if not lib.tcx_stats(self._h, lib.tcx_symbol_id(self._h, sym.encode()),
+                             ctypes.byref(st)):
+            return None
+        b = st.bar
+        bar = Bar(sym, b.startNs, b.open / PX_SCALE, b.high / PX_SCALE,
+                  b.low / PX_SCALE, b.close / PX_SCALE, b.vwap / PX_SCALE,
+                  b.volume, b.trades) if b.trades else None
+        return Stats(sym, st.last / PX_SCALE, st.lastQty, st.lastNs,
+                     st.open / PX_SCALE, st.high / PX_SCALE, st.low / PX_SCALE,
+                     st.vwap / PX_SCALE, st.volume, st.trades, bar)
+
+    def set_bar_interval(self, seconds:float):
+        """Bar length (default 60 s); 0 turns bars off."""
+        lib.tcx_set_bar_interval(self._h, int(seconds * 1000))
+
+    def record_tape(self, root:str):
+        """Records fills and quotes under root/YYYYMMDD; read with tcx.tape.Tape."""
+        if lib.tcx_record_tape(self._h, root.encode()) != 0:
+            raise OSError(f"cannot record a tape under {root}")
+
+    def metrics(self) -> dict[str, int]:
+        """Engine counters and queue depths, summed over threads."""
+        m = _Metrics()
+        lib.tcx_metrics(self._h, ctypes.byref(m))
+        return {name: getattr(m, name) for name in _METRICS}
+
+    def book_orders(self, sym:str) -> int:
+        return lib.tcx_book_orders(self._h, lib.tcx_symbol_id(self._h, sym.encode()))
+
+    def dump_flight(self, path:str|None=None) -> str:
+        """Writes the flight recorder to path (or a new file under $TMPDIR);
+        returns the file name. Decode with tce_flight."""
+        name = ctypes.create_string_buffer(512)
+        if lib.tcx_flight_dump(self._h, path.encode() if path else None, name, len(name)) != 0:
+            raise OSError(f"cannot write a flight-recorder dump to {path or 'the dump dir'}")
+        return name.value.decode()
+
+    def dump_when_slower_than(self, seconds:float):
+        """Dumps the flight recorder when one message takes longer than this; 0 is off."""
+        lib.tcx_flight_latency_dump(self._h, int(seconds * 1e6))
 
     def cancel(self, order_id:int):
         lib.tcx_cancel(self._h, order_id)
@@ -143,21 +549,79 @@ class Engine:
     def modify(self, order_id:int, px:float=0.0, qty:int|None=0):
         lib.tcx_modify(self._h, order_id, px, 0 if qty is None else qty)
 
-    def poll(self) -> List[Trade|TopOfBook]:
+    def poll(self) -> List[Trade|TopOfBook|Reject|MassCancel|Ack|BookUpdate|Bar]:
         lib.tcx_poll(self._h)     
         evt = _Evt()
         out = []
         while lib.tcx_next_event(self._h, ctypes.byref(evt)):
-            if evt.type == EventType.TRADE:
-                out.append(Trade(evt.symbol.decode(),
-                                 evt.buyId, evt.sellId,
-                                 evt.qty, evt.px))
-            else:
-                out.append(TopOfBook(evt.symbol.decode(),
-                                     evt.bidPx, evt.bidQty,
-                                     evt.askPx, evt.askQty))
+            out.append(self._event(evt))
         return out
 
+    def fileno(self) -> int:
+        """Readable while poll() has events; see tcx_event_fd."""
+        return lib.tcx_event_fd(self._h)
+
+    async def events(self):
+        """Yields each non-empty poll() as the engine produces it, sleeping
+        in the running asyncio loop in between instead of spinning."""
+        loop = asyncio.get_running_loop()
+        fd = self.fileno()
+        ready = asyncio.Event()
+        def wake():
+            # the fd stays readable until poll() drains the queue; take the
+            # signal here so the loop does not spin while we are suspended
+            try: os.read(fd, 8)
+            except BlockingIOError: pass
+            ready.set()
+        loop.add_reader(fd, wake)
+        try:
+            while True:
+                ready.clear()
+                batch = self.poll()
+                if batch:
+                    yield batch
+                else:
+                    await ready.wait()
+        finally:
+            loop.remove_reader(fd)
+
+    def subscribe(self, symbol:str|None=None,
+                  types:list[EventType]|None=None) -> Subscription:
+        """A broadcast reader of this engine's events, independent of poll()
+        and of every other subscription; see tcx_subscribe."""
+        sid = lib.tcx_symbol_id(self._h, symbol.encode()) if symbol else 0
+        mask = sum(1 << t for t in set(types or ()))
+        return Subscription(self, lib.tcx_subscribe(self._h, sid, mask))
+
+    def _event(self, evt:_Evt):
+        sym = self._symbol(evt.symbolId)
+        if evt.type == EventType.TRADE:
+            t = evt.trade
+            return Trade(sym, t.buyId, t.sellId, t.qty, t.px / PX_SCALE)
+        elif evt.type == EventType.REJECT:
+            return Reject(sym, evt.reject.orderId,
+                          evt.reject.reason, evt.reject.clientId)
+        elif evt.type == EventType.ACK:
+            return Ack(sym, evt.ack.orderId, evt.ack.clientId)
+        elif evt.type == EventType.MASS_CANCEL:
+            return MassCancel(sym, evt.massCancel.account,
+                              evt.massCancel.count)
+        elif evt.type == EventType.L3:
+            b = evt.l3
+            return BookUpdate(sym, L3Kind(b.kind), b.seq, b.orderId,
+                              Side(b.side), b.px / PX_SCALE, b.qty,
+                              b.clientId)
+        elif evt.type == EventType.BAR:
+            b = evt.bar
+            return Bar(sym, b.startNs, b.open / PX_SCALE, b.high / PX_SCALE,
+                       b.low / PX_SCALE, b.close / PX_SCALE,
+                       b.vwap / PX_SCALE, b.volume)
+        elif evt.type == EventType.TOB:
+            b = evt.tob
+            return TopOfBook(sym,
+                             b.bidPx / PX_SCALE, b.bidQty,
+                             b.askPx / PX_SCALE, b.askQty)
+
     def depth(self, symbol:str, levels:int=5) -> Tuple[List[Tuple[float,int]],
                                                        List[Tuple[float,int]]]:
         BidArr = _Depth * levels
@@ -167,8 +631,8 @@ class Engine:
         lib.tcx_depth(self._h, symbol.encode(), levels,
                       bids, ctypes.byref(nB),
                       asks, ctypes.byref(nA))
-        bid_lvls = [(bids[i].px, bids[i].qty) for i in range(nB.value)]
-        ask_lvls = [(asks[i].px, asks[i].qty) for i in range(nA.value)]
+        bid_lvls = [(bids[i].px / PX_SCALE, bids[i].qty) for i in range(nB.value)]
+        ask_lvls = [(asks[i].px / PX_SCALE, asks[i].qty) for i in range(nA.value)]
         return bid_lvls, ask_lvls
 
     def stop(self):
@@ -179,5 +643,30 @@ class Engine:
     def __enter__(self):  return self
     def __exit__(self, *exc): self.stop()
 
-__all__ = ["Engine", "BUY", "SELL", "LIMIT", "MARKET", "STOP",
-           "Trade", "TopOfBook"]
+class Subscription:
+    """Events from Engine.subscribe(); close() before the engine stops."""
+    def __init__(self, engine:Engine, handle):
+        self._engine, self._h = engine, handle
+
+    def poll(self) -> List[Trade|TopOfBook|Reject|MassCancel|Ack|BookUpdate|Bar]:
+        evt = _Evt()
+        out = []
+        while lib.tcx_sub_next(self._h, ctypes.byref(evt)):
+            out.append(self._engine._event(evt))
+        return out
+
+    @property
+    def lost(self) -> int:
+        """Events missed because this reader fell a whole ring behind."""
+        return lib.tcx_sub_lost(self._h)
+
+    def close(self):
+        if self._h:
+            lib.tcx_unsubscribe(self._h)
+            self._h = None
+
+    def __enter__(self): return self
+    def __exit__(self, *exc): self.close()
+
+__all__ = ["Engine", "Subscription", "BUY", "SELL", "LIMIT", "MARKET", "STOP", "Overflow",
+           "Trade", "TopOfBook", "Reject", "MassCancel", "Ack", "Bar", "Stats"]
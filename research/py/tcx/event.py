@@ -11,8 +11,9 @@ def _dcls(_cls=None, *, slots=True, **kw):
     return wrap if _cls is None else wrap(_cls)
 
 class EventType(Enum):
-    TRADE = auto()
-    TOB   = auto()
+    TRADE  = auto()
+    TOB    = auto()
+    REJECT = auto()
 
 @_dcls
 class Trade:
@@ -31,3 +32,10 @@ class TopOfBook:
     ask_px:  float
     ask_qty: int
     type:    EventType = EventType.TOB
+
+@_dcls
+class Reject:
+    symbol:   str
+    order_id: int
+    reason:   int
+    type:     EventType = EventType.REJECT
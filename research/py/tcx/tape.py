@@ -0,0 +1,107 @@
+"""
+research/py/tcx/tape.py
+Zero-copy reader for the engine's trade / quote tape (layout: src/Tape.hpp).
+
+    day = Tape("/data/tape/20240105")
+    px  = day.trades["px"]                    # mapped column, no parsing
+    lo, hi = day.trade_range(t0_ns, t1_ns)
+    rows = day.trade_rows("AAPL", t0_ns, t1_ns)
+
+Columns are numpy arrays over the mapped files when numpy is installed and
+typed memoryviews otherwise. Prices are fixed-point: divide by px_scale.
+"""
+import bisect, mmap, os, struct
+
+try:
+    import numpy as np
+except ImportError:                             # memoryviews are still zero-copy
+    np = None
+
+MAGIC   = 0x3145504154584354                    # "TCXTAPE1"
+VERSION = 1
+BLOCK   = 4096                                  # rows per index entry
+_SYMBOL_LEN = 32
+_META = struct.Struct("=QIIqqQQ")   # magic version symbols pxScale dayStartNs trades quotes
+
+TRADE_COLUMNS = (("ts", "q"), ("sym", "I"), ("px", "q"), ("qty", "i"),
+                 ("buy", "q"), ("sell", "q"))
+QUOTE_COLUMNS = (("ts", "q"), ("sym", "I"), ("bid", "q"), ("ask", "q"),
+                 ("bidqty", "i"), ("askqty", "i"))
+
+def _map(path):
+    with open(path, "rb") as f:
+        size = os.fstat(f.fileno()).st_size
+        return mmap.mmap(f.fileno(), size, access=mmap.ACCESS_READ)
+
+def _view(mm, fmt, n):
+    if np is not None:
+        return np.frombuffer(mm, dtype=np.dtype(fmt), count=n)
+    return memoryview(mm)[:n * struct.calcsize(fmt)].cast(fmt)
+
+class Tape:
+    """One day's directory; refresh() picks up rows appended since."""
+    def __init__(self, day_dir:str):
+        self.dir = day_dir
+        self.refresh()
+
+    def refresh(self):
+        meta = _map(os.path.join(self.dir, "meta"))
+        (magic, version, nsyms, self.px_scale, self.day_start_ns,
+         ntrades, nquotes) = _META.unpack_from(meta, 0)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError(f"{self.dir}: not a version {VERSION} tape")
+        names = meta[_META.size:_META.size + nsyms * _SYMBOL_LEN]
+        self.symbols = {}
+        for i in range(1, nsyms):
+            name = names[i * _SYMBOL_LEN:(i + 1) * _SYMBOL_LEN].split(b"\0", 1)[0]
+            if name:
+                self.symbols[name.decode()] = i
+        self.trades = self._table("trades", TRADE_COLUMNS, ntrades)
+        self.quotes = self._table("quotes", QUOTE_COLUMNS, nquotes)
+        self._index = {"trades": self._blocks("trades", ntrades),
+                       "quotes": self._blocks("quotes", nquotes)}
+
+    def _table(self, name, columns, n):
+        return {c: _view(_map(os.path.join(self.dir, f"{name}.{c}")), fmt, n)
+                for c, fmt in columns}
+
+    def _blocks(self, name, n):
+        nb = (n + BLOCK - 1) // BLOCK
+        return _view(_map(os.path.join(self.dir, f"{name}.idx")), "Q", 2 * nb)
+
+    def _range(self, table, t0, t1):
+        ts = table["ts"]
+        if np is not None:
+            return tuple(int(i) for i in np.searchsorted(ts, [t0, t1]))
+        return bisect.bisect_left(ts, t0), bisect.bisect_left(ts, t1)
+
+    def _rows(self, name, sym, t0, t1):
+        table = getattr(self, name)
+        sid = self.symbols.get(sym, 0)
+        lo, hi = self._range(table, t0, t1)
+        syms, blocks, bit = table["sym"], self._index[name], 1 << (sid % 64)
+        rows = []
+        while sid and lo < hi:
+            end = min(hi, (lo // BLOCK + 1) * BLOCK)
+            if blocks[2 * (lo // BLOCK) + 1] & bit:      # skip blocks without sym
+                if np is not None:
+                    rows.extend((lo + np.flatnonzero(syms[lo:end] == sid)).tolist())
+                else:
+                    rows.extend(r for r in range(lo, end) if syms[r] == sid)
+            lo = end
+        return rows
+
+    def trade_range(self, t0:int, t1:int) -> tuple[int, int]:
+        """Rows [lo, hi) of the trades with t0 <= ts < t1 (ns since the epoch)."""
+        return self._range(self.trades, t0, t1)
+
+    def quote_range(self, t0:int, t1:int) -> tuple[int, int]:
+        return self._range(self.quotes, t0, t1)
+
+    def trade_rows(self, sym:str, t0:int, t1:int) -> list[int]:
+        return self._rows("trades", sym, t0, t1)
+
+    def quote_rows(self, sym:str, t0:int, t1:int) -> list[int]:
+        return self._rows("quotes", sym, t0, t1)
+
+__all__ = ["Tape", "TRADE_COLUMNS", "QUOTE_COLUMNS"]
@@ -1,85 +1,582 @@
 #include "EngineRunner.hpp"
 
-EngineRunner::EngineRunner()
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+static_assert(static_cast<int>(L3Kind::ADD)    == static_cast<int>(ExecutionEngine::BookChange::ADD) &&
+              static_cast<int>(L3Kind::MODIFY) == static_cast<int>(ExecutionEngine::BookChange::MODIFY) &&
+              static_cast<int>(L3Kind::CANCEL) == static_cast<int>(ExecutionEngine::BookChange::CANCEL) &&
+              static_cast<int>(L3Kind::EXEC)   == static_cast<int>(ExecutionEngine::BookChange::EXEC),
+              "L3Kind out of sync with BookChange");
+
+EngineRunner::EngineRunner(const ThreadConfig& worker, PrewarmConfig prewarm)
+    : eventFd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), busyPoll_(worker.busyPoll)
 {
     eng_.setTradeHandler([this](const ExecutionEngine::Trade& t){
-        std::lock_guard lk(mtx_);
-        outQ_.push(TradeEvent{t});
+        OutboundMsg m{};
+        m.type     = OutboundType::TRADE;
+        m.symbolId = t.symbolId;
+        m.trade    = {t.price, t.buyId, t.sellId, t.qty};
+        flight_.record(FlightRecorder::Kind::FILL, t);
+        if (auto* tape = tape_.load(std::memory_order_acquire))
+            tape->trade(t.tsNs, t.symbolId, m.trade.px, t.qty, t.buyId, t.sellId);
+        metrics_.add(Metric::FILLS);
+        metrics_.add(Metric::FILLED_QTY, static_cast<std::uint64_t>(t.qty));
+        enqueue(m);
+    });
+    eng_.setRejectHandler([this](const ExecutionEngine::Reject& r){
+        OutboundMsg m{};
+        m.type     = OutboundType::REJECT;
+        m.symbolId = r.symbolId;
+        m.reject   = {r.orderId, r.clientId, r.reason};
+        metrics_.add(Metric::REJECTS);
+        enqueue(m);
+    });
+    eng_.setAcceptHandler([this](const ExecutionEngine::Accept& a){
+        OutboundMsg m{};
+        m.type     = OutboundType::ACK;
+        m.symbolId = a.symbolId;
+        m.ack      = {a.orderId, a.clientId};
+        metrics_.add(Metric::ACKS);
+        enqueue(m);
+    });
+    eng_.setBookEventHandler([this](const ExecutionEngine::BookEvent& b){
+        flight_.record(FlightRecorder::Kind::BOOK, b);
+        metrics_.setBookOrders(b.symbolId, static_cast<std::uint32_t>(eng_.orderCount(b.symbolId)),
+                               eng_.symbols().name(b.symbolId));
+        if (!l3_.load(std::memory_order_relaxed)) return;
+        OutboundMsg m{};
+        m.type     = OutboundType::L3;
+        m.symbolId = b.symbolId;
+        m.l3       = {b.seq, b.orderId, b.price, 0, b.qty, b.side,
+                      static_cast<L3Kind>(b.change)};
+        enqueue(m);
+    });
+    eng_.stats().setBarHandler([this](SymbolId sym, const TradeStats::Bar& b){
+        OutboundMsg m{};
+        m.type     = OutboundType::BAR;
+        m.symbolId = sym;
+        m.bar      = {b.startNs, b.open, b.high, b.low, b.close, b.vwap(), b.volume};
+        enqueue(m);
+    });
+    worker_ = std::thread([this, worker, prewarm = std::move(prewarm)]{
+        bool ok = applyThreadConfig(worker);
+        if (!prewarm.symbols.empty()) ok &= eng_.prewarm(prewarm);
+        configured_.store(ok);
+        try {
+            loop();
+        } catch (const std::exception& e) {
+            flight_.note(e.what());
+            flight_.dump(FlightRecorder::Reason::EXCEPTION);
+            throw;
+        } catch (...) {
+            flight_.dump(FlightRecorder::Reason::EXCEPTION);
+            throw;
+        }
     });
-    worker_ = std::thread([this]{ loop(); });
 }
 
 EngineRunner::~EngineRunner()
 {
     stop();
     if (worker_.joinable()) worker_.join();
+    if (eventFd_ >= 0) ::close(eventFd_);
+}
+
+namespace {
+// quotes and incremental L3 may be conflated or dropped; everything else is a report
+bool isMarketData(const OutboundMsg& m) noexcept
+{
+    return m.type == OutboundType::TOB ||
+           (m.type == OutboundType::L3 && m.l3.kind < L3Kind::SNAPSHOT_BEGIN);
+}
+}
+
+bool EngineRunner::push(const InboundMsg& m)
+{
+    return push(&m, 1) == 1;
+}
+
+std::size_t EngineRunner::push(const InboundMsg* msgs, std::size_t n, SessionId from)
+{
+    if (n == 0) return 0;
+    for (std::size_t i = 0; i < n; ++i) flight_.record(FlightRecorder::Kind::ENQUEUE, msgs[i]);
+
+    std::size_t taken = 0, rejects = 0;
+    bool signal = false;
+    std::vector<OutboundMsg> direct;        // rejects for the event handler
+    {
+        std::unique_lock lk(mtx_);
+        const bool block = from == NO_SESSION && flow_.inbound == Overflow::BLOCK;
+        const bool track = from < sessions_.size() && sessions_[from].cancelOnDisconnect;
+        for (;;) {
+            const std::size_t room = std::min(roomFor(from), n - taken);
+            for (std::size_t i = 0; i < room; ++i) inQ_.push_back({msgs[taken + i], from, track});
+            if (from < sessions_.size()) sessions_[from].inFlight += static_cast<std::uint32_t>(room);
+            taken += room;
+            if (taken == n || !block || !running_.load()) break;
+            cv_.notify_one();               // let the matching thread make room
+            ++blocked_;
+            room_.wait(lk, [&]{ return roomFor(from) > 0 || !running_.load(); });
+            --blocked_;
+        }
+        // with a stuck consumer an anonymous producer learns from the return value only
+        for (std::size_t i = taken; i < n; ++i)
+            if (from != NO_SESSION || !flow_.outCapacity || outQ_.size() < flow_.outCapacity) {
+                throttle(msgs[i], direct);
+                ++rejects;
+            }
+        signal = rejects && armEventFd();
+    }
+    if (!direct.empty() && !deliver(direct.data(), direct.size())) {
+        std::lock_guard lk(mtx_);           // the handler went away meanwhile
+        for (const OutboundMsg& r : direct) queueOut(r);
+        signal = armEventFd() || signal;
+    }
+    if (signal) signalEventFd();
+    if (taken) {
+        metrics_.add(Metric::MSGS_IN, taken);
+        cv_.notify_one();
+    }
+    if (taken < n) metrics_.add(Metric::THROTTLED, n - taken);
+    if (rejects) {
+        metrics_.add(Metric::REJECTS, rejects);
+        metrics_.add(Metric::EVENTS_OUT, rejects);
+    }
+    return taken;
+}
+
+std::size_t EngineRunner::roomFor(SessionId from) const
+{
+    std::size_t room = !flow_.inCapacity ? SIZE_MAX
+                     : inQ_.size() < flow_.inCapacity ? flow_.inCapacity - inQ_.size() : 0;
+    if (from < sessions_.size() && flow_.sessionCredits) {
+        const std::uint32_t used = sessions_[from].inFlight;
+        room = std::min<std::size_t>(room, used < flow_.sessionCredits ? flow_.sessionCredits - used : 0);
+    }
+    return room;
+}
+
+void EngineRunner::throttle(const InboundMsg& m, std::vector<OutboundMsg>& direct)
+{
+    OutboundMsg r{};
+    r.type     = OutboundType::REJECT;
+    r.symbolId = m.type == InboundType::NEW_ORDER ? m.symbolId : SymbolTable::NONE;
+    r.reject   = {m.type == InboundType::CANCEL || m.type == InboundType::MODIFY ? m.orderId : NO_ORDER,
+                  m.clientId, RejectReason::THROTTLED};
+    flight_.record(FlightRecorder::Kind::OUT, r);
+    bus_.publish(r);
+    if (hasHandler_.load(std::memory_order_acquire)) direct.push_back(r);
+    else queueOut(r);
+}
+
+std::size_t EngineRunner::credits(SessionId session) const
+{
+    std::lock_guard lk(mtx_);
+    return roomFor(session);
 }
 
-void EngineRunner::push(const InboundMsg& m) {
-    { std::lock_guard lk(mtx_); inQ_.push(m); }
+bool EngineRunner::setFlowControl(const FlowControl& fc)
+{
+    if (fc.inbound == Overflow::CONFLATE || fc.outbound == Overflow::REJECT) return false;
+    {
+        std::lock_guard lk(mtx_);
+        flow_ = fc;
+    }
+    room_.notify_all();
     cv_.notify_one();
+    return true;
 }
 
-bool EngineRunner::poll(OutboundMsg& out)
+FlowControl EngineRunner::flowControl() const
 {
     std::lock_guard lk(mtx_);
-    if (outQ_.empty()) return false;
-    out = std::move(outQ_.front());
-    outQ_.pop();
+    return flow_;
+}
+
+bool EngineRunner::poll(OutboundMsg& out)
+{
+    bool wake;
+    {
+        std::lock_guard lk(mtx_);
+        if (outQ_.empty()) {
+            if (signalled_) {               // under the lock, or a new signal could be eaten
+                std::uint64_t n;
+                while (::read(eventFd_, &n, sizeof n) < 0 && errno == EINTR) {}
+                signalled_ = false;
+            }
+            return false;
+        }
+        const bool full = !outRoom();
+        out = outQ_.front();
+        outQ_.pop_front();
+        ++outPopped_;
+        if (!isMarketData(out)) --outReports_;
+        wake = full && outRoom() && !inQ_.empty();
+    }
+    if (wake) cv_.notify_one();
+    metrics_.add(Metric::EVENTS_POLLED);
+    return true;
+}
+
+bool EngineRunner::outRoom() const
+{
+    const std::size_t held = flow_.outbound == Overflow::CONFLATE ? outReports_ : outQ_.size();
+    return !flow_.outCapacity || held < flow_.outCapacity;
+}
+
+bool EngineRunner::queueOut(const OutboundMsg& m)
+{
+    const bool market = isMarketData(m);
+    if (market && flow_.outbound == Overflow::CONFLATE && flow_.outCapacity &&
+        outQ_.size() >= flow_.outCapacity) {
+        if (m.type == OutboundType::L3) return false;
+        if (m.symbolId < lastTob_.size() && lastTob_[m.symbolId] > outPopped_) {
+            outQ_[lastTob_[m.symbolId] - 1 - outPopped_] = m;
+            return false;
+        }
+    }
+    outQ_.push_back(m);
+    if (!market) ++outReports_;
+    if (m.type == OutboundType::TOB) {
+        if (m.symbolId >= lastTob_.size()) lastTob_.resize(m.symbolId + 1, 0);
+        lastTob_[m.symbolId] = outPopped_ + outQ_.size();
+    }
+    return true;
+}
+
+// Callers hold mtx_. True if the event fd has to be written, which the
+// caller does after unlocking: once per batch, and not again until poll()
+// has drained the queue.
+bool EngineRunner::armEventFd()
+{
+    if (signalled_ || outQ_.empty() || eventFd_ < 0) return false;
+    signalled_ = true;
+    return true;
+}
+
+void EngineRunner::raiseEventFd()
+{
+    bool signal;
+    {
+        std::lock_guard lk(mtx_);
+        signal = !signalled_ && eventFd_ >= 0;
+        signalled_ = true;
+    }
+    if (signal) signalEventFd();
+}
+
+void EngineRunner::signalEventFd()
+{
+    const std::uint64_t one = 1;
+    while (::write(eventFd_, &one, sizeof one) < 0 && errno == EINTR) {}
+}
+
+// Matching thread only: events wait in outBatch_ until flushOut() moves the
+// whole batch under one lock.
+void EngineRunner::enqueue(const OutboundMsg& m)
+{
+    flight_.record(FlightRecorder::Kind::OUT, m);
+    outBatch_.push_back(m);
+}
+
+void EngineRunner::flushOut()
+{
+    if (outBatch_.empty()) return;
+    if (deliver(outBatch_.data(), outBatch_.size())) {
+        if (bus_.subscribers()) {
+            std::lock_guard lk(mtx_);       // bus writers are serialised by mtx_
+            for (const OutboundMsg& m : outBatch_) bus_.publish(m);
+        }
+        metrics_.add(Metric::EVENTS_POLLED, outBatch_.size());  // first, so outQueue() never sees them
+        metrics_.add(Metric::EVENTS_OUT, outBatch_.size());
+        outBatch_.clear();
+        return;
+    }
+    std::size_t queued = 0;
+    bool signal;
+    {
+        std::lock_guard lk(mtx_);
+        for (const OutboundMsg& m : outBatch_) {
+            bus_.publish(m);
+            queued += queueOut(m);
+        }
+        signal = armEventFd();
+    }
+    if (signal) signalEventFd();
+    metrics_.add(Metric::EVENTS_OUT, queued);
+    if (queued < outBatch_.size()) metrics_.add(Metric::CONFLATED, outBatch_.size() - queued);
+    outBatch_.clear();
+}
+
+void EngineRunner::setEventHandler(EventHandler handler)
+{
+    std::lock_guard lk(handlerMtx_);
+    hasHandler_.store(static_cast<bool>(handler), std::memory_order_release);
+    handler_ = std::move(handler);
+}
+
+bool EngineRunner::deliver(const OutboundMsg* events, std::size_t n)
+{
+    if (!hasHandler_.load(std::memory_order_acquire)) return false;
+    std::lock_guard lk(handlerMtx_);
+    if (!handler_) return false;
+    handler_(events, n);
     return true;
 }
 
 void EngineRunner::stop()
 {
-    running_.store(false);
+    {
+        std::lock_guard lk(mtx_);       // a waiter is either before its check or notified
+        running_.store(false);
+    }
+    cv_.notify_one();
+    room_.notify_all();
+}
+
+bool EngineRunner::recordTape(const std::string& root)
+{
+    std::lock_guard lk(mtx_);
+    if (tapeOwner_) return false;
+    tapeOwner_ = TapeWriter::open(root, eng_.symbols());
+    if (!tapeOwner_) return false;
+    tape_.store(tapeOwner_.get(), std::memory_order_release);
+    return true;
+}
+
+SessionId EngineRunner::openSession(AccountId account, bool cancelOnDisconnect)
+{
+    std::lock_guard lk(mtx_);
+    sessions_.push_back({account, cancelOnDisconnect, true, 0});
+    return static_cast<SessionId>(sessions_.size() - 1);
+}
+
+void EngineRunner::closeSession(SessionId id)
+{
+    InboundMsg mc{};
+    {
+        std::lock_guard lk(mtx_);
+        if (id >= sessions_.size() || !sessions_[id].open) return;
+        sessions_[id].open = false;
+        if (!sessions_[id].cancelOnDisconnect) return;
+        // pulling the orders is never throttled
+        mc = InboundMsg::massCancel(sessions_[id].account);
+        inQ_.push_back({mc, id, false, true});
+    }
+    flight_.record(FlightRecorder::Kind::ENQUEUE, mc);
+    metrics_.add(Metric::MSGS_IN);
     cv_.notify_one();
 }
 
 void EngineRunner::loop()
 {
-    static const std::string emptySym;
     while (running_.load())
     {
-        InboundMsg msg;
         {
             std::unique_lock lk(mtx_);
-            cv_.wait(lk, [&]{ return !inQ_.empty() || !running_.load(); });
+            // a full outbound queue holds matching back (see FlowControl)
+            auto ready = [&]{ return (!inQ_.empty() && outRoom()) || !running_.load(); };
+            if (busyPoll_) {
+                while (!ready()) {
+                    lk.unlock();
+                    closeDueBars();
+                    cpuRelax();
+                    lk.lock();
+                }
+            }
+            else if (const std::int64_t due = eng_.stats().nextCloseNs()) {
+                const std::chrono::system_clock::time_point at{
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                        std::chrono::nanoseconds(due))};
+                if (!cv_.wait_until(lk, at, ready)) {
+                    lk.unlock();
+                    closeDueBars();
+                    continue;
+                }
+            }
+            else cv_.wait(lk, ready);
             if (!running_.load()) break;
-            msg = std::move(inQ_.front());
-            inQ_.pop();
+            // everything queued, in one swap; both buffers keep their capacity
+            batch_.swap(inQ_);
+            for (const Pending& p : batch_)
+                if (!p.closes && p.from < sessions_.size() && sessions_[p.from].inFlight)
+                    --sessions_[p.from].inFlight;
+            if (blocked_) room_.notify_all();
         }
+        const std::uint64_t slow = slowTicks_.load(std::memory_order_relaxed);
+        for (const Pending& p : batch_) {
+            flight_.record(FlightRecorder::Kind::HANDLE, p.msg);
+            const std::uint64_t t0 = FlightRecorder::ticks();
+            handle(p);
+            const std::uint64_t took = FlightRecorder::ticks() - t0;
+            flight_.record(FlightRecorder::Kind::DONE, took, static_cast<std::uint32_t>(p.msg.type));
+            if (slow && took > slow) onSlowMessage();
+        }
+        flushOut();
+        metrics_.add(Metric::MSGS_HANDLED, batch_.size());
+        metrics_.set(Metric::RESTING_ORDERS, eng_.orderCount());
+        metrics_.set(Metric::BOOKS, eng_.bookCount());
+        batch_.clear();
+    }
+}
 
-        const std::string* symPtr = &emptySym;
+void EngineRunner::setLatencyDump(std::chrono::nanoseconds threshold)
+{
+    const double ticks = threshold.count() > 0 ? double(threshold.count()) * flight_.ticksPerNs() : 0.0;
+    slowTicks_.store(ticks > 0 ? std::max<std::uint64_t>(1, static_cast<std::uint64_t>(ticks)) : 0,
+                     std::memory_order_relaxed);
+}
 
-        std::visit([&](auto&& m){
-            using T = std::decay_t<decltype(m)>;
+void EngineRunner::onSlowMessage()
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastSlowDump_ < std::chrono::seconds(1)) return;
+    lastSlowDump_ = now;
+    flight_.dump(FlightRecorder::Reason::LATENCY);
+}
 
-            if constexpr (std::is_same_v<T, NewOrderMsg>) {
-                symPtr = &m.order->getSymbol();
-                eng_.submit(m.order);
+void EngineRunner::closeDueBars()
+{
+    TradeStats& st = eng_.stats();
+    if (const std::int64_t due = st.nextCloseNs()) {
+        const std::int64_t now = TradeStats::nowNs();
+        if (due <= now) {
+            st.closeBars(now);
+            flushOut();
+        }
+    }
+}
 
-            } else if constexpr (std::is_same_v<T, CancelMsg>) {
-                eng_.cancel(m.orderId);
+void EngineRunner::handle(const Pending& p)
+{
+    const InboundMsg& m = p.msg;
+    SymbolId sym = SymbolTable::NONE;
 
-            } else if constexpr (std::is_same_v<T, ModifyMsg>) {
-                eng_.modify(m.orderId, m.px, m.qty);
-            }
-        }, msg);
-
-        if (!symPtr->empty()) {
-            if (auto* book = eng_.getBook(*symPtr)) {
-                auto bid = book->getBestBid();
-                auto ask = book->getBestAsk();
-
-                std::lock_guard lk(mtx_);
-                outQ_.push(TopOfBookEvt{
-                    *symPtr,
-                    bid ? bid->getPrice()    : 0.0,
-                    bid ? bid->getQuantity() : 0,
-                    ask ? ask->getPrice()    : 0.0,
-                    ask ? ask->getQuantity() : 0
-                });
-            }
+    switch (m.type) {
+    case InboundType::NEW_ORDER: {
+        metrics_.add(Metric::ORDERS);
+        auto order = std::make_shared<Order>(NO_ORDER, eng_.symbols().name(m.symbolId),
+                                             m.side, m.ordType, m.px, m.qty, m.account);
+        order->setClientId(m.clientId);
+        if (const OrderId id = eng_.submit(order, m.symbolId); id >= 0) {
+            sym = m.symbolId;
+            if (p.track) trackOrder(p.from, id);
+        }
+        break;
+    }
+    case InboundType::CANCEL:
+        metrics_.add(Metric::CANCELS);
+        eng_.cancel(m.orderId, m.clientId,
+                    (m.flags & IN_OWNER) ? std::optional<AccountId>(m.account) : std::nullopt, &sym);
+        break;
+    case InboundType::MODIFY:
+        metrics_.add(Metric::MODIFIES);
+        eng_.modify(m.orderId,
+                    (m.flags & IN_HAS_PX)  ? std::optional<PxTicks>(m.px) : std::nullopt,
+                    (m.flags & IN_HAS_QTY) ? std::optional<int>(m.qty)    : std::nullopt,
+                    m.clientId,
+                    (m.flags & IN_OWNER) ? std::optional<AccountId>(m.account) : std::nullopt, &sym);
+        break;
+    case InboundType::MASS_CANCEL: {
+        metrics_.add(Metric::MASS_CANCELS);
+        std::vector<SymbolId> touched;
+        int n;
+        if (p.closes) {
+            std::vector<OrderId> ids;
+            if (p.from < sessionOrders_.size()) ids.swap(sessionOrders_[p.from]);
+            n = eng_.cancelOrders(m.account, ids, &touched);
         }
+        else n = eng_.massCancel(m.account,
+                    m.symbolId != SymbolTable::NONE ? std::optional<SymbolId>(m.symbolId) : std::nullopt,
+                    (m.flags & IN_HAS_SIDE) ? std::optional<OrderSide>(m.side) : std::nullopt,
+                    &touched);
+
+        OutboundMsg ack{};
+        ack.type       = OutboundType::MASS_CANCEL;
+        ack.symbolId   = m.symbolId;
+        ack.massCancel = {m.account, n};
+        enqueue(ack);
+        for (SymbolId t : touched) publishTob(t);
+        break;
+    }
+    case InboundType::AUCTION_START:
+        eng_.setAuction(m.symbolId != SymbolTable::NONE ? std::optional<SymbolId>(m.symbolId)
+                                                        : std::nullopt, true);
+        break;
+    case InboundType::AUCTION_UNCROSS: {
+        std::vector<SymbolId> touched;
+        eng_.uncross(m.symbolId != SymbolTable::NONE ? std::optional<SymbolId>(m.symbolId)
+                                                     : std::nullopt,
+                     (m.flags & IN_RESUME) != 0, &touched);
+        for (SymbolId t : touched) publishTob(t);
+        break;
+    }
+    case InboundType::BOOK_SNAPSHOT:
+        publishSnapshot(m.symbolId, m.clientId);
+        break;
+    }
+
+    if (sym != SymbolTable::NONE) publishTob(sym);
+}
+
+// The list is swept of orders that no longer rest whenever it would grow,
+// so a long-lived session keeps roughly its resting orders.
+void EngineRunner::trackOrder(SessionId session, OrderId id)
+{
+    if (session >= sessionOrders_.size()) sessionOrders_.resize(session + 1);
+    auto& ids = sessionOrders_[session];
+    if (ids.size() >= 1024 && ids.size() == ids.capacity())
+        ids.erase(std::remove_if(ids.begin(), ids.end(),
+                                 [this](OrderId o){ return !eng_.isResting(o); }), ids.end());
+    ids.push_back(id);
+}
+
+void EngineRunner::publishTob(SymbolId sym)
+{
+    // a book in auction is crossed by design; quote it again after uncrossing
+    if (auto* book = eng_.getBook(sym); book && !book->inAuction()) {
+        const BookSnapshot s = book->snapshot();
+
+        OutboundMsg out{};
+        out.type     = OutboundType::TOB;
+        out.symbolId = sym;
+        out.tob      = { s.nBids ? s.bids[0].px : 0,
+                         s.nAsks ? s.asks[0].px : 0,
+                         s.nBids ? s.bids[0].qty : 0,
+                         s.nAsks ? s.asks[0].qty : 0 };
+        // most orders and cancels land behind the top: don't repeat the quote
+        if (sym >= lastQuote_.size()) lastQuote_.resize(sym + 1, TopOfBookEvt{0, 0, -1, -1});
+        TopOfBookEvt& last = lastQuote_[sym];
+        if (last.bidPx == out.tob.bidPx && last.askPx == out.tob.askPx &&
+            last.bidQty == out.tob.bidQty && last.askQty == out.tob.askQty)
+            return;
+        last = out.tob;
+        if (auto* tape = tape_.load(std::memory_order_acquire))
+            tape->quote(TradeStats::nowNs(), sym, out.tob.bidPx, out.tob.askPx,
+                        out.tob.bidQty, out.tob.askQty);
+        enqueue(out);
+    }
+}
+
+void EngineRunner::publishSnapshot(SymbolId sym, std::uint64_t clientId)
+{
+    const std::uint64_t seq = eng_.restingOrders(sym, snapshotRows_);
+    const int n = static_cast<int>(snapshotRows_.size());
+
+    OutboundMsg out{};
+    out.type     = OutboundType::L3;
+    out.symbolId = sym;
+    out.l3       = {seq, NO_ORDER, 0, clientId, n, OrderSide::BUY, L3Kind::SNAPSHOT_BEGIN};
+
+    enqueue(out);
+    for (const auto& r : snapshotRows_) {
+        out.l3 = {seq, r.orderId, r.price, clientId, r.qty, r.side, L3Kind::SNAPSHOT_ORDER};
+        enqueue(out);
     }
+    out.l3 = {seq, NO_ORDER, 0, clientId, n, OrderSide::BUY, L3Kind::SNAPSHOT_END};
+    enqueue(out);
 }
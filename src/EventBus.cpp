@@ -0,0 +1,36 @@
+#include "EventBus.hpp"
+
+std::unique_ptr<EventBus::Subscription> EventBus::subscribe(const EventFilter& filter)
+{
+    std::lock_guard lk(mtx_);
+    if (!ring_.load(std::memory_order_relaxed)) ring_.store(new Ring(), std::memory_order_relaxed);
+    std::unique_ptr<Subscription> s(new Subscription(*this, filter));
+    subscribers_.fetch_add(1, std::memory_order_release);   // publishes ring_
+    return s;
+}
+
+EventBus::Subscription::Subscription(EventBus& bus, const EventFilter& filter)
+    : bus_(bus),
+      ring_(*bus.ring_.load(std::memory_order_relaxed)),
+      filter_(filter),
+      cursor_(ring_.head()) {}
+
+EventBus::Subscription::~Subscription()
+{
+    std::lock_guard lk(bus_.mtx_);
+    bus_.subscribers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool EventBus::Subscription::next(OutboundMsg& out) noexcept
+{
+    for (;;) {
+        const std::uint64_t at = cursor_;
+        switch (ring_.read(cursor_, out)) {
+        case Ring::Read::OK:
+            if (filter_.accepts(out)) return true;
+            break;
+        case Ring::Read::EMPTY:  return false;
+        case Ring::Read::LAPPED: lost_ += cursor_ - at; break;
+        }
+    }
+}
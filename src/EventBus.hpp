@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "BroadcastRing.hpp"
+#include "Messages.hpp"
+
+// Which events a subscription sees.
+struct EventFilter {
+    SymbolId      symbol = SymbolTable::NONE;   // NONE: every symbol
+    std::uint32_t types  = 0;                   // bit per OutboundType; 0: every type
+
+    static constexpr std::uint32_t bit(OutboundType t) noexcept {
+        return std::uint32_t{1} << static_cast<unsigned>(t);
+    }
+    bool accepts(const OutboundMsg& m) const noexcept {
+        return (symbol == SymbolTable::NONE || m.symbolId == symbol) &&
+               (types == 0 || (types & bit(m.type)));
+    }
+};
+
+// In-process fan-out of a runner's outbound events. The writer copies each
+// event once into a BroadcastRing; every subscription reads it through its
+// own cursor and filter, so subscribers cost the writer nothing and do not
+// see each other. The writer never waits: a subscription that falls a whole
+// ring behind skips ahead and counts what it missed.
+//
+// The ring is allocated with the first subscription; until then, and while
+// nobody is subscribed, publish() is a load and a branch.
+class EventBus {
+public:
+    static constexpr std::size_t RING = 64 * 1024;
+    using Ring = BroadcastRing<OutboundMsg, RING>;
+
+    // Not thread-safe: use one subscription per thread. Must not outlive
+    // its bus.
+    class Subscription {
+    public:
+        ~Subscription();
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+        // Next event that passes the filter; false once caught up.
+        bool next(OutboundMsg& out) noexcept;
+        // Events skipped because the writer lapped this subscription
+        // (whether or not they would have passed the filter).
+        std::uint64_t lost() const noexcept { return lost_; }
+        const EventFilter& filter() const noexcept { return filter_; }
+
+    private:
+        friend class EventBus;
+        Subscription(EventBus& bus, const EventFilter& filter);
+
+        EventBus& bus_;
+        const Ring& ring_;
+        EventFilter filter_;
+        std::uint64_t cursor_;
+        std::uint64_t lost_ = 0;
+    };
+
+    EventBus() = default;
+    ~EventBus() { delete ring_.load(std::memory_order_relaxed); }
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    // Writers must be serialised by the caller.
+    void publish(const OutboundMsg& m) noexcept {
+        if (subscribers_.load(std::memory_order_acquire) == 0) return;  // pairs with subscribe()
+        ring_.load(std::memory_order_relaxed)->publish(m);
+    }
+
+    // Any thread. The subscription sees events published from now on.
+    std::unique_ptr<Subscription> subscribe(const EventFilter& filter = {});
+    std::size_t subscribers() const noexcept { return subscribers_.load(std::memory_order_relaxed); }
+
+private:
+    std::mutex mtx_;                    // subscribe / unsubscribe
+    std::atomic<Ring*> ring_{nullptr};
+    std::atomic<std::size_t> subscribers_{0};
+};
@@ -1,12 +1,45 @@
 #include "ExecutionEngine.hpp"
-#include <stdexcept>
+#include "ThreadConfig.hpp"
 
-ExecutionEngine::ExecutionEngine() = default;
+#include <algorithm>
+
+namespace {
+inline PxTicks limitOf(const Order& o)
+{
+    return o.getType() == OrderType::MARKET ? 0 : o.getPrice();
+}
+}
+
+ExecutionEngine::ExecutionEngine(ShardId shard)
+    : risk_(RiskGate::DEFAULT_ACCOUNTS, symbols_.capacity()),
+      stats_(symbols_.capacity()),
+      booksById_(std::make_unique<std::atomic<OrderBook*>[]>(symbols_.capacity())),
+      bookSeq_(symbols_.capacity(), 0),
+      bookOrders_(symbols_.capacity(), 0),
+      shard_(shard & MAX_SHARD) {}
 
 void ExecutionEngine::ensureBook(const std::string& symbol) {
+    SymbolId sid = symbols_.intern(symbol);
     std::lock_guard lock(booksMtx_);
-    if (books_.find(symbol) == books_.end())
-        books_.emplace(symbol, std::make_unique<OrderBook>(symbol));
+    if (books_.find(symbol) == books_.end()) {
+        auto& book = books_.emplace(symbol, std::make_unique<OrderBook>(symbol, sid)).first->second;
+        if (auctionByDefault_) book->setAuction(true);
+        if (ordersPerBook_) book->reserve(ordersPerBook_);
+        if (sid != SymbolTable::NONE) booksById_[sid].store(book.get(), std::memory_order_release);
+    }
+}
+
+OrderBook* ExecutionEngine::ensureBook(SymbolId sid) {
+    if (sid == SymbolTable::NONE || sid >= symbols_.capacity()) return nullptr;
+    if (auto* book = getBook(sid)) return book;
+    std::lock_guard lock(booksMtx_);
+    if (auto* book = booksById_[sid].load(std::memory_order_relaxed)) return book;
+    const auto& symbol = symbols_.name(sid);
+    auto& book = books_.emplace(symbol, std::make_unique<OrderBook>(symbol, sid)).first->second;
+    if (auctionByDefault_) book->setAuction(true);
+    if (ordersPerBook_) book->reserve(ordersPerBook_);
+    booksById_[sid].store(book.get(), std::memory_order_release);
+    return book.get();
 }
 
 OrderBook* ExecutionEngine::getBook(const std::string& symbol) {
@@ -21,59 +54,315 @@ const OrderBook* ExecutionEngine::getBook(const std::string& symbol) const {
     return (it == books_.end()) ? nullptr : it->second.get();
 }
 
-int ExecutionEngine::submit(const std::shared_ptr<Order>& o)
+RejectReason ExecutionEngine::validate(const Order* o) const noexcept
+{
+    if(!o) return RejectReason::NULL_ORDER;
+    if(auto r = o->validate(); r != RejectReason::NONE) return r;
+    if(o->getQuantity()>maxOrderQty_) return RejectReason::QTY_LIMIT;
+    return RejectReason::NONE;
+}
+
+RejectReason ExecutionEngine::validate(const Order* o, SymbolId sym) const noexcept
+{
+    if(auto r = validate(o); r != RejectReason::NONE) return r;
+    if(!onTick(limitOf(*o), symbols_.tickSize(sym))) return RejectReason::BAD_PRICE;
+    return RejectReason::NONE;
+}
+
+void ExecutionEngine::reject(SymbolId sym, OrderId id, RejectReason why,
+                             std::uint64_t clientId) const
+{
+    if(rejectCb_) rejectCb_({sym, id, clientId, why});
+}
+
+void ExecutionEngine::bookEvent(SymbolId sym, BookChange change, OrderId id,
+                                OrderSide side, PxTicks px, int qty)
+{
+    if(bookCb_) bookCb_({sym, ++bookSeq_[sym], change, id, side, px, qty});
+}
+
+void ExecutionEngine::publishFills(SymbolId sym, const std::vector<Match>& fills)
 {
-    if(!o)                           throw std::invalid_argument("null order");
-    if(o->getQuantity()>maxOrderQty_)throw std::invalid_argument("qty too big");
+    if(fills.empty()) return;
+    for(const auto& m: fills){
+        if(m.buyDone)  idToBook_.erase(m.buyId);
+        if(m.sellDone) idToBook_.erase(m.sellId);
+        bookOrders_[sym] -= m.buyDone + m.sellDone;
+    }
+    const std::int64_t now = TradeStats::nowNs();
+    for(const auto& m: fills){
+        if(recordStats_) stats_.onTrade(sym, m.price, m.qty, now);
+        risk_.onFill(m.buyAccount,  sym, OrderSide::BUY,  m.buyLimit,  m.qty, m.buyDone);
+        risk_.onFill(m.sellAccount, sym, OrderSide::SELL, m.sellLimit, m.qty, m.sellDone);
+        if(tradeCb_) tradeCb_({sym, m.buyId, m.sellId, m.price, m.qty, now});
+        bookEvent(sym, BookChange::EXEC, m.buyId,  OrderSide::BUY,  m.price, m.qty);
+        bookEvent(sym, BookChange::EXEC, m.sellId, OrderSide::SELL, m.price, m.qty);
+    }
+    if(recordStats_) stats_.publish(sym);
+}
 
-    ensureBook(o->getSymbol());
-    auto* book = getBook(o->getSymbol());
-    int id = book->addOrder(o);
+OrderId ExecutionEngine::submit(const std::shared_ptr<Order>& o) noexcept
+{
+    return submit(o, o ? symbols_.intern(o->getSymbol()) : SymbolTable::NONE);
+}
 
-    { std::lock_guard lk(booksMtx_); idToBook_[id]=book; }
+OrderId ExecutionEngine::submit(const std::shared_ptr<Order>& o, SymbolId sym) noexcept
+{
+    auto r = validate(o.get(), sym);
+    if(r == RejectReason::NONE)
+        r = risk_.check(o->getAccount(), sym, o->getSide(), limitOf(*o), o->getQuantity());
+    if(r != RejectReason::NONE){
+        reject(sym, NO_ORDER, r, o ? o->getClientId() : 0);
+        return -1;
+    }
 
-    auto fills = book->match();
-    if(tradeCb_ && !fills.empty()){
-        for(const auto& m: fills)
-            tradeCb_({o->getSymbol(), m.buyId, m.sellId, m.price, m.qty});
+    auto* book = ensureBook(sym);
+    if(!book || book->getSymbol() != o->getSymbol()){
+        reject(sym, NO_ORDER, RejectReason::SYMBOL_MISMATCH, o->getClientId());
+        return -1;
     }
+
+    // ids are only spent on accepted orders
+    OrderId id = makeOrderId(shard_, ++seq_);
+    o->assignId(id);
+    book->addOrder(o);
+
+    idToBook_.insert(id, book);
+    ++bookOrders_[sym];
+    risk_.onAccept(o->getAccount(), sym, o->getSide(), limitOf(*o), o->getQuantity());
+    if(acceptCb_) acceptCb_({sym, id, o->getClientId()});
+    bookEvent(sym, BookChange::ADD, id, o->getSide(), limitOf(*o), o->getQuantity());
+
+    publishFills(sym, book->match());
+    book->publish();
     return id;
 }
 
-bool ExecutionEngine::cancel(int id)
+bool ExecutionEngine::cancel(OrderId id, std::uint64_t clientId,
+                             std::optional<AccountId> owner, SymbolId* touched) noexcept
 {
-    OrderBook* book;
-    { std::lock_guard lk(booksMtx_);
-      auto it=idToBook_.find(id); if(it==idToBook_.end()) return false;
-      book=it->second; }
+    auto* book = bookForOrder(id);
+    if(!book){ reject(SymbolTable::NONE, id, RejectReason::UNKNOWN_ORDER, clientId); return false; }
 
-    bool ok = book->removeOrder(id);
-    if(ok){ std::lock_guard lk(booksMtx_); idToBook_.erase(id); }
+    bool ok = removeResting(book, id, owner);
+    if(ok){
+        book->publish();
+        if(touched) *touched = book->getSymbolId();
+    }
+    else reject(book->getSymbolId(), id, RejectReason::UNKNOWN_ORDER, clientId);
     return ok;
 }
 
-bool ExecutionEngine::modify(int id,
-                             std::optional<double> px,
-                             std::optional<int> qt)
+int ExecutionEngine::cancelOrders(AccountId acct, const std::vector<OrderId>& ids,
+                                  std::vector<SymbolId>* touched) noexcept
+{
+    int n = 0;
+    for(OrderId id : ids){
+        auto* book = bookForOrder(id);
+        if(!book || !removeResting(book, id, acct)) continue;
+        ++n;
+        book->publish();
+        if(touched && std::find(touched->begin(), touched->end(), book->getSymbolId()) == touched->end())
+            touched->push_back(book->getSymbolId());
+    }
+    return n;
+}
+
+// Takes a resting order out of its book with all the bookkeeping; the
+// caller publishes the book.
+bool ExecutionEngine::removeResting(OrderBook* book, OrderId id, std::optional<AccountId> owner)
+{
+    auto o = book->getOrder(id);
+    if(!o || (owner && o->getAccount() != *owner)) return false;
+    int left = o->getQuantity();
+    if(!o->isActive() || !book->removeOrder(id)) return false;
+    idToBook_.erase(id);
+    --bookOrders_[book->getSymbolId()];
+    risk_.onCancel(o->getAccount(), book->getSymbolId(), o->getSide(), limitOf(*o), left);
+    bookEvent(book->getSymbolId(), BookChange::CANCEL, id, o->getSide(), limitOf(*o), left);
+    return true;
+}
+
+std::vector<OrderBook*> ExecutionEngine::booksFor(std::optional<SymbolId> sym)
+{
+    std::vector<OrderBook*> books;
+    if(sym){ if(auto* b = getBook(*sym)) books.push_back(b); return books; }
+    std::lock_guard lk(booksMtx_);
+    for(auto& [name, b] : books_) books.push_back(b.get());
+    return books;
+}
+
+void ExecutionEngine::setAuction(std::optional<SymbolId> sym, bool on) noexcept
+{
+    if(sym) ensureBook(*sym);
+    else    auctionByDefault_ = on;       // books created later join in
+    for(auto* book : booksFor(sym)) book->setAuction(on);
+}
+
+int ExecutionEngine::uncross(std::optional<SymbolId> sym, bool resume,
+                             std::vector<SymbolId>* touched) noexcept
+{
+    int n = 0;
+    for(auto* book : booksFor(sym)){
+        auto fills = book->uncross();
+        n += static_cast<int>(fills.size());
+        publishFills(book->getSymbolId(), fills);
+        if(resume){
+            if(!sym) auctionByDefault_ = false;
+            book->setAuction(false);
+            publishFills(book->getSymbolId(), book->match());
+        }
+        book->publish();
+        if(touched) touched->push_back(book->getSymbolId());
+    }
+    return n;
+}
+
+int ExecutionEngine::massCancel(AccountId acct,
+                                std::optional<SymbolId> sym,
+                                std::optional<OrderSide> side,
+                                std::vector<SymbolId>* touched) noexcept
+{
+    int n = 0;
+    for(auto* book : booksFor(sym)){
+        auto gone = book->removeAccountOrders(acct, side);
+        if(gone.empty()) continue;
+        for(const auto& c : gone) idToBook_.erase(c.orderId);
+        bookOrders_[book->getSymbolId()] -= static_cast<int>(gone.size());
+        for(const auto& c : gone){
+            risk_.onCancel(acct, book->getSymbolId(), c.side, c.limit, c.qty);
+            bookEvent(book->getSymbolId(), BookChange::CANCEL, c.orderId, c.side, c.limit, c.qty);
+        }
+        n += static_cast<int>(gone.size());
+        book->publish();
+        if(touched) touched->push_back(book->getSymbolId());
+    }
+    return n;
+}
+
+bool ExecutionEngine::modify(OrderId id,
+                             std::optional<PxTicks> px,
+                             std::optional<int> qt,
+                             std::uint64_t clientId,
+                             std::optional<AccountId> owner,
+                             SymbolId* touched) noexcept
 {
     auto* book = bookForOrder(id);
-    if(!book) return false;
+    if(!book){ reject(SymbolTable::NONE, id, RejectReason::UNKNOWN_ORDER, clientId); return false; }
 
-    if(!book->modifyOrder(id, px, qt)) return false;
+    SymbolId sym = book->getSymbolId();
+    auto o = book->getOrder(id);
+    if(o && owner && o->getAccount() != *owner){
+        reject(sym, id, RejectReason::UNKNOWN_ORDER, clientId);
+        return false;
+    }
+    if(qt && *qt < 0)          { reject(sym, id, RejectReason::BAD_QTY, clientId);   return false; }
+    if(qt && *qt>maxOrderQty_) { reject(sym, id, RejectReason::QTY_LIMIT, clientId); return false; }
+    if(px && (*px <= 0 || !onTick(*px, symbols_.tickSize(sym))))
+                               { reject(sym, id, RejectReason::BAD_PRICE, clientId); return false; }
 
-    auto fills = book->match();
-    if(tradeCb_ && !fills.empty()){
-        const auto& sym = book->getSymbol();
-        for(const auto& m: fills)
-            tradeCb_({sym, m.buyId, m.sellId, m.price, m.qty});
+    if(!o || !o->isActive()){
+        reject(sym, id, o ? RejectReason::INACTIVE_ORDER : RejectReason::UNKNOWN_ORDER, clientId);
+        return false;
     }
+
+    AccountId acct = o->getAccount();
+    PxTicks oldPx = limitOf(*o);
+    int oldQty = o->getQuantity();
+    PxTicks newPx = (px && o->getType() != OrderType::MARKET) ? *px : oldPx;
+    int newQty = qt.value_or(oldQty);
+    if(auto r = risk_.checkReplace(acct, sym, o->getSide(), oldPx, oldQty, newPx, newQty);
+       newQty > 0 && r != RejectReason::NONE){
+        reject(sym, id, r, clientId);
+        return false;
+    }
+
+    if(!book->modifyOrder(id, px, qt)){
+        reject(sym, id, RejectReason::INACTIVE_ORDER, clientId);
+        return false;
+    }
+    risk_.onCancel(acct, sym, o->getSide(), oldPx, oldQty);
+    if(newQty > 0){
+        risk_.onAccept(acct, sym, o->getSide(), newPx, newQty);
+        bookEvent(sym, BookChange::MODIFY, id, o->getSide(), newPx, newQty);
+    }
+    else {
+        idToBook_.erase(id);
+        --bookOrders_[sym];
+        bookEvent(sym, BookChange::CANCEL, id, o->getSide(), oldPx, oldQty);
+    }
+
+    publishFills(sym, book->match());
+    book->publish();
+    if(touched) *touched = sym;
     return true;
 }
 
-OrderBook* ExecutionEngine::bookForOrder(int orderId) {
-    std::lock_guard lock(booksMtx_);
-    auto it = idToBook_.find(orderId);
-    return (it == idToBook_.end()) ? nullptr : it->second;
+bool ExecutionEngine::prewarm(const PrewarmConfig& cfg)
+{
+    bool ok = !cfg.lockMemory || lockProcessMemory();
+    prefaultStack();
+
+    { std::lock_guard lk(booksMtx_);
+      ordersPerBook_ = cfg.ordersPerBook;
+      books_.reserve(books_.size() + cfg.symbols.size());
+      for (auto& [name, book] : books_) book->reserve(cfg.ordersPerBook); }
+    idToBook_.reserve(cfg.symbols.size() * cfg.ordersPerBook);
+
+    auto tradeCb = std::move(tradeCb_);
+    auto rejectCb = std::move(rejectCb_);
+    auto acceptCb = std::move(acceptCb_);
+    auto bookCb = std::move(bookCb_);
+    tradeCb_ = nullptr;
+    rejectCb_ = nullptr;
+    acceptCb_ = nullptr;
+    bookCb_ = nullptr;
+    recordStats_ = false;
+
+    for(const auto& sym : cfg.symbols){
+        ensureBook(sym);
+        SymbolId sid = symbols_.find(sym);
+        // warm-up orders would trade against real ones, or stay behind in an auction
+        OrderBook* book = ensureBook(sid);
+        if(!book || book->inAuction() || orderCount(sid)) continue;
+        for(int i = 0; i < cfg.warmupRounds; ++i){
+            auto bid  = std::make_shared<Order>(sym, OrderSide::BUY , OrderType::LIMIT, 2.0, 2);
+            auto ask  = std::make_shared<Order>(sym, OrderSide::SELL, OrderType::LIMIT, 2.0, 2);
+            auto rest = std::make_shared<Order>(sym, OrderSide::BUY , OrderType::LIMIT, 1.0, 1);
+            submit(bid, sid);
+            submit(rest, sid);
+            modify(rest->getOrderId(), toTicks(1.5), 2);
+            submit(ask, sid);
+            cancel(rest->getOrderId());
+        }
+    }
+
+    // the warm-up orders' ids stay spent: seq_ never goes back
+    tradeCb_ = std::move(tradeCb);
+    rejectCb_ = std::move(rejectCb);
+    acceptCb_ = std::move(acceptCb);
+    bookCb_ = std::move(bookCb);
+    recordStats_ = true;
+    return ok;
+}
+
+std::uint64_t ExecutionEngine::restingOrders(SymbolId sym, std::vector<RestingOrder>& out) const
+{
+    out.clear();
+    const OrderBook* book = sym < symbols_.capacity()
+                          ? booksById_[sym].load(std::memory_order_acquire) : nullptr;
+    if(!book) return sym < bookSeq_.size() ? bookSeq_[sym] : 0;
+
+    for(const auto& orders : {book->getBuyOrders(), book->getSellOrders()})
+        for(const auto& o : orders)
+            out.push_back({o->getOrderId(), o->getSide(), limitOf(*o), o->getQuantity()});
+    return bookSeq_[sym];
+}
+
+OrderBook* ExecutionEngine::bookForOrder(OrderId orderId) {
+    if (shardOf(orderId) != shard_) return nullptr;
+    auto* book = idToBook_.find(orderId);
+    return book ? *book : nullptr;
 }
 
 
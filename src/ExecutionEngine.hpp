@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <unordered_map>
 #include <memory>
 #include <functional>
@@ -7,40 +8,196 @@
 #include <vector>
 #include <mutex>
 #include "OrderBook.hpp"
+#include "FlatIdMap.hpp"
+#include "SymbolTable.hpp"
+#include "RiskGate.hpp"
+#include "TradeStats.hpp"
+
+// Startup warm-up, run before the first real order.
+struct PrewarmConfig {
+    std::vector<std::string> symbols;   // books to create up front
+    std::size_t ordersPerBook = 1024;   // expected resting orders per book
+    int  warmupRounds = 256;            // synthetic order cycles per book
+    bool lockMemory   = false;          // mlockall current and future pages
+};
 
 class ExecutionEngine {
 public:
 
     struct Trade {
-        std::string symbol;
-        int buyId;
-        int sellId;
-        double price;
+        SymbolId symbolId;
+        OrderId buyId;
+        OrderId sellId;
+        PxTicks price;
+        int qty;
+        std::int64_t tsNs;          // wall clock, ns since the epoch
+    };
+
+    struct Reject {
+        SymbolId symbolId;
+        OrderId orderId;            // NO_ORDER for a rejected new order
+        std::uint64_t clientId;
+        RejectReason reason;
+    };
+
+    struct Accept {
+        SymbolId symbolId;
+        OrderId orderId;
+        std::uint64_t clientId;
+    };
+
+    // Order-by-order (L3) change to a book. seq counts every change of one
+    // symbol without gaps. ADD is sent when an order enters the book, before
+    // it matches; MODIFY always moves the order to the back of its level.
+    enum class BookChange : std::uint8_t { ADD, MODIFY, CANCEL, EXEC };
+    struct BookEvent {
+        SymbolId symbolId;
+        std::uint64_t seq;
+        BookChange change;
+        OrderId orderId;
+        OrderSide side;
+        PxTicks price;              // limit (0 for market orders); EXEC: trade price
+        int qty;                    // ADD / MODIFY: new quantity; CANCEL / EXEC: quantity removed
+    };
+
+    struct RestingOrder {
+        OrderId orderId;
+        OrderSide side;
+        PxTicks price;              // 0 for market orders
         int qty;
     };
 
+    // Handlers run inline on the matching path and must not throw.
     using TradeHandler = std::function<void(const Trade&)>;
-    explicit ExecutionEngine();
+    using RejectHandler = std::function<void(const Reject&)>;
+    using AcceptHandler = std::function<void(const Accept&)>;
+    using BookEventHandler = std::function<void(const BookEvent&)>;
+    // Ids minted by this engine carry `shard`; see makeOrderId().
+    explicit ExecutionEngine(ShardId shard = 0);
+
+    ShardId shard() const { return shard_; }
 
     void ensureBook(const std::string& symbol);
+    OrderBook* ensureBook(SymbolId symbolId);
     OrderBook* getBook(const std::string& symbol);
     const OrderBook* getBook(const std::string &symbol) const;
+    // Lock-free, from any thread: a book is published once when it is
+    // created and never moves, so readers never wait on the matcher.
+    OrderBook* getBook(SymbolId symbolId) noexcept {
+        return symbolId < symbols_.capacity() ? booksById_[symbolId].load(std::memory_order_acquire) : nullptr;
+    }
+
+    SymbolTable& symbols() { return symbols_; }
+    const SymbolTable& symbols() const { return symbols_; }
+    RiskGate& risk() { return risk_; }
+    const RiskGate& risk() const { return risk_; }
+    // Fed with every fill before the trade handler sees it.
+    TradeStats& stats() { return stats_; }
+    const TradeStats& stats() const { return stats_; }
+
+    // Limit prices must also be on the symbol's tick (symbols().tickSize).
+    RejectReason validate(const Order* order) const noexcept;
+    RejectReason validate(const Order* order, SymbolId symbolId) const noexcept;
+
+    // An accepted order is assigned its id, reported through the accept
+    // handler before it can trade, and the id is returned. Failures never
+    // throw: submit returns -1 and cancel/modify return false, each after
+    // reporting the reason through the reject handler. Ids of other shards
+    // are rejected without a lookup. clientId is echoed on a reject.
+    OrderId submit(const std::shared_ptr<Order>& order) noexcept;
+    // Same, for callers that already hold the interned symbol id.
+    OrderId submit(const std::shared_ptr<Order>& order, SymbolId symbolId) noexcept;
+    // With an owner, an order of any other account is rejected as
+    // UNKNOWN_ORDER, so clients cannot probe for other accounts' ids. On
+    // success `touched`, if given, is set to the symbol whose book changed.
+    bool cancel(OrderId orderId, std::uint64_t clientId = 0,
+        std::optional<AccountId> owner = std::nullopt,
+        SymbolId* touched = nullptr) noexcept;
+    bool modify(OrderId orderId, 
+        std::optional<PxTicks> newPrice = std::nullopt,
+        std::optional<int> newQty = std::nullopt,
+        std::uint64_t clientId = 0,
+        std::optional<AccountId> owner = std::nullopt,
+        SymbolId* touched = nullptr) noexcept;
+
+    // Pulls every resting order of an account, optionally restricted to one
+    // symbol and/or side; returns the number of orders cancelled and, if
+    // asked, the symbols whose books changed.
+    int massCancel(AccountId account,
+        std::optional<SymbolId> symbolId = std::nullopt,
+        std::optional<OrderSide> side = std::nullopt,
+        std::vector<SymbolId>* touched = nullptr) noexcept;
+    // Pulls those of `ids` that still rest and belong to `account`; ids that
+    // have since filled or been cancelled are skipped without a reject.
+    int cancelOrders(AccountId account, const std::vector<OrderId>& ids,
+        std::vector<SymbolId>* touched = nullptr) noexcept;
+    // Matching thread only.
+    bool isResting(OrderId orderId) const noexcept {
+        return shardOf(orderId) == shard_ && idToBook_.find(orderId) != nullptr;
+    }
+
+    // Call auction: while a book is in auction orders rest without matching;
+    // uncross() executes them at one equilibrium price per book. symbolId
+    // nullopt applies to every book.
+    void setAuction(std::optional<SymbolId> symbolId, bool on) noexcept;
+    int uncross(std::optional<SymbolId> symbolId,
+        bool resumeContinuous = true,
+        std::vector<SymbolId>* touched = nullptr) noexcept;
+
+    // Creates the configured books, reserves the id and book tables and runs
+    // crossing, modify and cancel cycles through every book with the handlers
+    // detached, so allocator free lists, page tables and caches are warm and
+    // no events, exposure or trade stats are left behind. Books that are in
+    // auction or already hold orders are not cycled. Returns false if
+    // memory could not be locked.
+    bool prewarm(const PrewarmConfig& cfg);
 
-    int submit(const std::shared_ptr<Order>& order);
-    bool cancel(int orderId);
-    bool modify(int orderId, 
-        std::optional<double> newPrice = std::nullopt, 
-        std::optional<int> newQty = std::nullopt);
+    // A book's resting orders in priority order (bids, then asks) and the
+    // BookEvent seq they reflect. Call from the matching thread, so no change
+    // can fall between the copy and the seq.
+    std::uint64_t restingOrders(SymbolId symbolId, std::vector<RestingOrder>& out) const;
+    // Resting orders in total and in one book, and books created; matching
+    // thread only.
+    std::size_t orderCount() const noexcept { return idToBook_.size(); }
+    int orderCount(SymbolId symbolId) const noexcept {
+        return symbolId < bookOrders_.size() ? bookOrders_[symbolId] : 0;
+    }
+    std::size_t bookCount() const noexcept { return books_.size(); }
 
     void setMaxOrderQty(int maxQty) { maxOrderQty_ = maxQty; }
     void setTradeHandler(TradeHandler cb) { tradeCb_ = std::move(cb); }
+    void setRejectHandler(RejectHandler cb) { rejectCb_ = std::move(cb); }
+    void setAcceptHandler(AcceptHandler cb) { acceptCb_ = std::move(cb); }
+    // Sequence numbers only advance while a book event handler is set.
+    void setBookEventHandler(BookEventHandler cb) { bookCb_ = std::move(cb); }
 
 private:
-    OrderBook* bookForOrder(int orderId);
+    OrderBook* bookForOrder(OrderId orderId);
+    bool removeResting(OrderBook* book, OrderId orderId, std::optional<AccountId> owner);
+    std::vector<OrderBook*> booksFor(std::optional<SymbolId> symbolId);
+    void reject(SymbolId symbolId, OrderId orderId, RejectReason why,
+                std::uint64_t clientId = 0) const;
+    void publishFills(SymbolId symbolId, const std::vector<Match>& fills);
+    void bookEvent(SymbolId symbolId, BookChange change, OrderId orderId,
+                   OrderSide side, PxTicks price, int qty);
+    SymbolTable symbols_;
+    RiskGate risk_;
+    TradeStats stats_;
     std::unordered_map<std::string, std::unique_ptr<OrderBook>> books_;
-    std::unordered_map<int, OrderBook*> idToBook_;
-    mutable std::mutex booksMtx_;
+    std::unique_ptr<std::atomic<OrderBook*>[]> booksById_;  // per SymbolId, set once
+    std::vector<std::uint64_t> bookSeq_;    // per SymbolId
+    std::vector<int> bookOrders_;           // per SymbolId; matching thread only
+    FlatIdMap<OrderId, OrderBook*> idToBook_;   // matching thread only
+    mutable std::mutex booksMtx_;           // guards books_
     int maxOrderQty_ {1'000'000};
+    bool auctionByDefault_ {false};
+    std::size_t ordersPerBook_ {0};         // index size for new books, from prewarm()
     TradeHandler tradeCb_ {nullptr};
+    RejectHandler rejectCb_ {nullptr};
+    AcceptHandler acceptCb_ {nullptr};
+    BookEventHandler bookCb_ {nullptr};
+    bool recordStats_ {true};
+    ShardId shard_;
+    std::uint64_t seq_ {0};
 };
 
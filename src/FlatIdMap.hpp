@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Open-addressing map from order id to V, with linear probing and
+// backward-shift deletion (no tombstones). Ids are handed out densely and in
+// order, so `id & mask` places live orders in consecutive slots and a lookup
+// is normally a single probe. Kept at most half full.
+template <typename K, typename V>
+class FlatIdMap {
+    static_assert(std::numeric_limits<K>::is_integer, "FlatIdMap keys are integer ids");
+    static constexpr K EMPTY = std::numeric_limits<K>::min();
+
+public:
+    explicit FlatIdMap(std::size_t capacity = 1024) { rehash(capacity); }
+
+    V* find(K id) noexcept {
+        for (std::size_t i = slot(id);; i = (i + 1) & mask_) {
+            if (slots_[i].id == id) return &slots_[i].value;
+            if (slots_[i].id == EMPTY) return nullptr;
+        }
+    }
+    const V* find(K id) const noexcept { return const_cast<FlatIdMap*>(this)->find(id); }
+
+    // Inserts or overwrites.
+    void insert(K id, V value) {
+        if (2 * (size_ + 1) > slots_.size()) rehash(2 * slots_.size());
+        std::size_t i = slot(id);
+        while (slots_[i].id != EMPTY && slots_[i].id != id) i = (i + 1) & mask_;
+        if (slots_[i].id == EMPTY) ++size_;
+        slots_[i] = {id, std::move(value)};
+    }
+
+    bool erase(K id) noexcept {
+        std::size_t i = slot(id);
+        while (slots_[i].id != id) {
+            if (slots_[i].id == EMPTY) return false;
+            i = (i + 1) & mask_;
+        }
+        // Pull later entries of the probe run back into the hole.
+        for (std::size_t j = (i + 1) & mask_; slots_[j].id != EMPTY; j = (j + 1) & mask_) {
+            std::size_t home = slot(slots_[j].id);
+            if (((j - home) & mask_) >= ((j - i) & mask_)) {
+                slots_[i] = std::move(slots_[j]);
+                i = j;
+            }
+        }
+        slots_[i] = Slot{};
+        --size_;
+        return true;
+    }
+
+    void reserve(std::size_t n) {
+        std::size_t cap = slots_.size();
+        while (cap < 2 * n) cap *= 2;
+        if (cap != slots_.size()) rehash(cap);
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    // Entries that fit before the next rehash.
+    std::size_t capacity() const noexcept { return slots_.size() / 2; }
+    bool empty() const noexcept { return size_ == 0; }
+
+private:
+    struct Slot {
+        K id = EMPTY;
+        V value{};
+    };
+
+    std::size_t slot(K id) const noexcept {
+        return static_cast<std::size_t>(static_cast<std::make_unsigned_t<K>>(id)) & mask_;
+    }
+
+    void rehash(std::size_t capacity) {
+        std::size_t cap = 16;
+        while (cap < capacity) cap *= 2;
+        std::vector<Slot> old(cap);
+        old.swap(slots_);
+        mask_ = cap - 1;
+        size_ = 0;
+        for (auto& s : old)
+            if (s.id != EMPTY) insert(s.id, std::move(s.value));
+    }
+
+    std::vector<Slot> slots_;
+    std::size_t mask_ = 0;
+    std::size_t size_ = 0;
+};
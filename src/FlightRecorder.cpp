@@ -0,0 +1,315 @@
+#include "FlightRecorder.hpp"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+constexpr std::uint64_t FLIGHT_MAGIC   = 0x3130544c46584354;   // "TCXFLT01"
+constexpr std::uint32_t FLIGHT_VERSION = 1;
+constexpr int           MAX_LIVE       = 8;                    // recorders a signal dumps
+
+std::atomic<std::uint64_t> nextRecorder{1};
+std::atomic<FlightRecorder*> live[MAX_LIVE];
+
+struct FileHeader {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t reason;
+    std::int32_t  pid;
+    std::uint32_t rings;
+    std::uint32_t ringSize;
+    std::uint32_t recordSize;
+    std::int64_t  wallNs;           // clocks when the dump was taken
+    std::int64_t  monoNs;
+    std::uint64_t tsc;
+    double        ticksPerNs;
+};
+struct RingHeader {                 // followed by `count` DiskRecords
+    std::uint32_t tid;
+    char          name[16];
+    std::uint32_t count;
+};
+struct DiskRecord {                 // FlightRecorder::Record without the atomic
+    unsigned char body[FlightRecorder::BODY];
+    std::uint64_t tsc;
+    std::uint64_t n;
+    std::uint16_t kind;             // 0: torn while dumping
+    std::uint32_t aux;
+};
+static_assert(sizeof(DiskRecord) == sizeof(FlightRecorder::Record) &&
+              offsetof(DiskRecord, aux) == offsetof(FlightRecorder::Record, aux),
+              "dump records must mirror the ring");
+
+std::int64_t clockNs(clockid_t c) noexcept
+{
+    timespec ts{};
+    clock_gettime(c, &ts);
+    return std::int64_t{ts.tv_sec} * 1'000'000'000 + ts.tv_nsec;
+}
+
+bool writeAll(int fd, const void* p, std::size_t n) noexcept
+{
+    const char* c = static_cast<const char*>(p);
+    while (n) {
+        const ssize_t w = ::write(fd, c, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        c += w;
+        n -= static_cast<std::size_t>(w);
+    }
+    return true;
+}
+
+// snprintf is not async-signal-safe
+char* append(char* p, const char* end, const char* s) noexcept
+{
+    while (*s && p < end) *p++ = *s++;
+    return p;
+}
+char* append(char* p, const char* end, std::uint64_t v) noexcept
+{
+    char digits[20];
+    int n = 0;
+    do { digits[n++] = static_cast<char>('0' + v % 10); v /= 10; } while (v);
+    while (n && p < end) *p++ = digits[--n];
+    return p;
+}
+}
+
+FlightRecorder::FlightRecorder(std::string dir)
+    : id_(nextRecorder.fetch_add(1, std::memory_order_relaxed))
+{
+    if (dir.empty()) {
+        const char* tmp = std::getenv("TMPDIR");
+        dir = tmp && *tmp ? tmp : "/tmp";
+    }
+    setDir(dir);
+    mono0_ = clockNs(CLOCK_MONOTONIC);
+    tsc0_  = ticks();
+    for (auto& slot : live) {
+        FlightRecorder* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, this)) break;
+    }
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    for (auto& slot : live) {
+        FlightRecorder* expected = this;
+        slot.compare_exchange_strong(expected, nullptr);
+    }
+    for (auto& r : rings_) delete r.load();
+}
+
+std::uint64_t FlightRecorder::ticks() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(clockNs(CLOCK_MONOTONIC));
+#endif
+}
+
+FlightRecorder::Ring* FlightRecorder::claim() noexcept
+{
+    static thread_local int evict = 0;
+    Local* l = nullptr;
+    for (Local& c : locals_)
+        if (c.owner == 0) { l = &c; break; }
+    if (!l) { l = &locals_[evict]; evict = (evict + 1) % LOCAL_CACHE; }
+
+    int i = nRings_.load(std::memory_order_relaxed);
+    while (i < MAX_THREADS && !nRings_.compare_exchange_weak(i, i + 1, std::memory_order_relaxed)) {}
+    Ring* r = i < MAX_THREADS ? new (std::nothrow) Ring() : nullptr;    // touched by its writer
+    if (r) {
+        r->tid = static_cast<std::uint32_t>(::syscall(SYS_gettid));
+        pthread_getname_np(pthread_self(), r->name, sizeof r->name);
+        rings_[i].store(r, std::memory_order_release);
+    }
+    l->owner = id_;             // a thread over the limit caches nullptr and records nothing
+    l->ring  = r;
+    return r;
+}
+
+void FlightRecorder::setDir(const std::string& dir) noexcept
+{
+    const std::size_t n = std::min(dir.size(), sizeof dir_ - 1);
+    std::memcpy(dir_, dir.data(), n);
+    dir_[n] = '\0';
+}
+
+double FlightRecorder::ticksPerNs() const noexcept
+{
+    if (const double t = ticksPerNs_.load(std::memory_order_relaxed)) return t;
+    std::int64_t m0 = mono0_;
+    std::uint64_t t0 = tsc0_;
+    if (clockNs(CLOCK_MONOTONIC) - m0 < 10'000'000) {       // too young to tell: measure
+        m0 = clockNs(CLOCK_MONOTONIC);
+        t0 = ticks();
+        while (clockNs(CLOCK_MONOTONIC) - m0 < 5'000'000) {}
+    }
+    const std::uint64_t t1 = ticks();
+    const double t = double(t1 - t0) / double(clockNs(CLOCK_MONOTONIC) - m0);
+    ticksPerNs_.store(t > 0 ? t : 1.0, std::memory_order_relaxed);
+    return ticksPerNs_.load(std::memory_order_relaxed);
+}
+
+bool FlightRecorder::writeTo(int fd, Reason why) const noexcept
+{
+    FileHeader h{};
+    h.magic      = FLIGHT_MAGIC;
+    h.version    = FLIGHT_VERSION;
+    h.reason     = static_cast<std::uint32_t>(why);
+    h.pid        = ::getpid();
+    h.rings      = static_cast<std::uint32_t>(std::min(nRings_.load(std::memory_order_acquire), MAX_THREADS));
+    h.ringSize   = RING;
+    h.recordSize = sizeof(DiskRecord);
+    h.wallNs     = clockNs(CLOCK_REALTIME);
+    h.monoNs     = clockNs(CLOCK_MONOTONIC);
+    h.tsc        = ticks();
+    const double cached = ticksPerNs_.load(std::memory_order_relaxed);
+    h.ticksPerNs = h.monoNs - mono0_ > 1'000'000 ? double(h.tsc - tsc0_) / double(h.monoNs - mono0_)
+                 : cached > 0 ? cached : 1.0;
+    if (!writeAll(fd, &h, sizeof h)) return false;
+
+    DiskRecord buf[32];
+    for (std::uint32_t i = 0; i < h.rings; ++i) {
+        const Ring* r = rings_[i].load(std::memory_order_acquire);
+        RingHeader rh{};
+        const std::uint64_t head = r ? r->head.load(std::memory_order_acquire) : 0;
+        const std::uint64_t first = head > RING ? head - RING : 0;
+        if (r) {
+            rh.tid = r->tid;
+            std::memcpy(rh.name, r->name, sizeof rh.name);
+        }
+        rh.count = static_cast<std::uint32_t>(head - first);
+        if (!writeAll(fd, &rh, sizeof rh)) return false;
+
+        std::size_t j = 0;
+        for (std::uint64_t k = first; k < head; ++k) {
+            const Record& rec = r->recs[k % RING];
+            const std::uint64_t n = rec.n.load(std::memory_order_acquire);
+            std::memcpy(static_cast<void*>(&buf[j]), static_cast<const void*>(&rec), sizeof buf[j]);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (n != k + 1 || rec.n.load(std::memory_order_relaxed) != n) buf[j].kind = 0;
+            if (++j == sizeof buf / sizeof buf[0] || k + 1 == head) {
+                if (!writeAll(fd, buf, j * sizeof buf[0])) return false;
+                j = 0;
+            }
+        }
+    }
+    return true;
+}
+
+void FlightRecorder::nextDumpName(char (&out)[DIR_LEN + 64]) const noexcept
+{
+    char* p = out;
+    const char* end = out + sizeof out - 1;
+    p = append(p, end, dir_);
+    p = append(p, end, "/tcx-flight.");
+    p = append(p, end, static_cast<std::uint64_t>(::getpid()));
+    p = append(p, end, ".");
+    p = append(p, end, dumps_.fetch_add(1, std::memory_order_relaxed));
+    p = append(p, end, ".bin");
+    *p = '\0';
+}
+
+std::string FlightRecorder::dump(Reason why, const std::string& path) const
+{
+    char name[DIR_LEN + 64];
+    if (path.empty()) nextDumpName(name);
+    else {
+        const std::size_t n = std::min(path.size(), sizeof name - 1);
+        std::memcpy(name, path.data(), n);
+        name[n] = '\0';
+    }
+    if (!dumpTo(name, why)) return {};
+    return name;
+}
+
+bool FlightRecorder::dumpTo(const char* file, Reason why) const noexcept
+{
+    const int fd = ::open(file, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    const bool ok = writeTo(fd, why);
+    ::close(fd);
+    return ok;
+}
+
+void FlightRecorder::onSignal(int)
+{
+    const int saved = errno;
+    for (auto& slot : live) {
+        const FlightRecorder* f = slot.load(std::memory_order_acquire);
+        if (!f) continue;
+        char name[DIR_LEN + 64];
+        f->nextDumpName(name);
+        f->dumpTo(name, Reason::SIGNAL);
+    }
+    errno = saved;
+}
+
+bool FlightRecorder::installSignalHandler(int sig)
+{
+    struct sigaction sa{};
+    sa.sa_handler = &FlightRecorder::onSignal;
+    sa.sa_flags   = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    return sigaction(sig ? sig : SIGUSR2, &sa, nullptr) == 0;
+}
+
+bool FlightRecorder::load(const std::string& path, Dump& out)
+{
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    FileHeader h{};
+    bool ok = std::fread(&h, sizeof h, 1, f) == 1 && h.magic == FLIGHT_MAGIC &&
+              h.version == FLIGHT_VERSION && h.recordSize == sizeof(DiskRecord) &&
+              h.ticksPerNs > 0;
+    out = {};
+    out.reason = static_cast<Reason>(h.reason);
+    out.pid    = h.pid;
+    out.wallNs = h.wallNs;
+    out.ticksPerNs = h.ticksPerNs;
+
+    std::vector<DiskRecord> recs;
+    for (std::uint32_t i = 0; ok && i < h.rings; ++i) {
+        RingHeader rh{};
+        ok = std::fread(&rh, sizeof rh, 1, f) == 1 && rh.count <= h.ringSize;
+        if (!ok) break;
+        recs.resize(rh.count);
+        ok = std::fread(recs.data(), sizeof(DiskRecord), rh.count, f) == rh.count;
+        out.threads.push_back({rh.tid, std::string(rh.name, strnlen(rh.name, sizeof rh.name))});
+        for (const DiskRecord& r : recs) {
+            if (!r.kind) continue;
+            Event e{};
+            e.tsc    = r.tsc;
+            e.wallNs = h.wallNs - static_cast<std::int64_t>(
+                           double(static_cast<std::int64_t>(h.tsc - r.tsc)) / h.ticksPerNs);
+            e.thread = rh.tid;
+            e.kind   = static_cast<Kind>(r.kind);
+            e.aux    = r.aux;
+            std::memcpy(e.body, r.body, BODY);
+            out.events.push_back(e);
+        }
+    }
+    std::fclose(f);
+    std::stable_sort(out.events.begin(), out.events.end(),
+                     [](const Event& a, const Event& b){ return a.tsc < b.tsc; });
+    return ok;
+}
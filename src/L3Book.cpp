@@ -0,0 +1,124 @@
+#include "L3Book.hpp"
+
+#include <limits>
+
+bool L3Book::apply(const OutboundMsg& ev)
+{
+    if (ev.type != OutboundType::L3 || ev.symbolId != symbol_) return true;
+    const L3Evt& e = ev.l3;
+
+    switch (e.kind) {
+    case L3Kind::SNAPSHOT_BEGIN:
+        if (state_ != State::STALE) return true;      // someone else's resync
+        clear();
+        seq_   = e.seq;
+        state_ = State::SNAPSHOT;
+        return true;
+    case L3Kind::SNAPSHOT_ORDER:
+        if (state_ == State::SNAPSHOT) add(e.orderId, e.side, e.px, e.qty);
+        return true;
+    case L3Kind::SNAPSHOT_END:
+        if (state_ != State::SNAPSHOT) return true;
+        if (e.seq == seq_ && orders() == static_cast<std::size_t>(e.qty)) {
+            state_ = State::LIVE;
+            return true;
+        }
+        clear();                                     // rows went missing
+        state_ = State::STALE;
+        return false;
+    default:
+        break;
+    }
+
+    if (state_ == State::STALE && e.seq == 1 && index_.empty()) state_ = State::LIVE;
+    if (state_ != State::LIVE) return true;           // waiting for a snapshot
+    if (e.seq != seq_ + 1) {
+        clear();
+        state_ = State::STALE;
+        return false;
+    }
+    seq_ = e.seq;
+
+    switch (e.kind) {
+    case L3Kind::ADD:    add(e.orderId, e.side, e.px, e.qty); break;
+    case L3Kind::MODIFY: remove(e.orderId); add(e.orderId, e.side, e.px, e.qty); break;
+    case L3Kind::CANCEL: remove(e.orderId); break;
+    case L3Kind::EXEC:   reduce(e.orderId, e.qty); break;
+    default: break;
+    }
+    return true;
+}
+
+long long L3Book::queueAhead(OrderId id) const noexcept
+{
+    auto w = index_.find(id);
+    if (w == index_.end()) return -1;
+    const Queue& q = w->second.side == OrderSide::BUY ? bids_.at(w->second.key)
+                                                      : asks_.at(w->second.key);
+    long long ahead = 0;
+    for (auto it = q.begin(); it != w->second.it; ++it) ahead += it->qty;
+    return ahead;
+}
+
+bool L3Book::best(OrderSide side, PxTicks& px, long long& qty) const noexcept
+{
+    auto top = [&](const auto& levels) {
+        for (const auto& [key, q] : levels) {
+            if (key == keyOf(side, 0)) continue;      // market orders have no price
+            px  = key;
+            qty = 0;
+            for (const auto& e : q) qty += e.qty;
+            return true;
+        }
+        return false;
+    };
+    return side == OrderSide::BUY ? top(bids_) : top(asks_);
+}
+
+PxTicks L3Book::keyOf(OrderSide side, PxTicks px) noexcept
+{
+    // market orders (px 0) rank ahead of every limit, as in the engine's book
+    if (px != 0) return px;
+    return side == OrderSide::BUY ? std::numeric_limits<PxTicks>::max()
+                                  : std::numeric_limits<PxTicks>::lowest();
+}
+
+void L3Book::add(OrderId id, OrderSide side, PxTicks px, int qty)
+{
+    const PxTicks key = keyOf(side, px);
+    Queue& q = side == OrderSide::BUY ? bids_[key] : asks_[key];
+    index_[id] = {side, key, q.insert(q.end(), {id, qty})};
+}
+
+void L3Book::remove(OrderId id)
+{
+    auto w = index_.find(id);
+    if (w == index_.end()) return;
+    const Where& where = w->second;
+    if (where.side == OrderSide::BUY) {
+        auto lvl = bids_.find(where.key);
+        lvl->second.erase(where.it);
+        if (lvl->second.empty()) bids_.erase(lvl);
+    } else {
+        auto lvl = asks_.find(where.key);
+        lvl->second.erase(where.it);
+        if (lvl->second.empty()) asks_.erase(lvl);
+    }
+    index_.erase(w);
+}
+
+void L3Book::reduce(OrderId id, int qty)
+{
+    auto w = index_.find(id);
+    if (w == index_.end()) return;
+    w->second.it->qty -= qty;
+    if (w->second.it->qty <= 0) remove(id);
+}
+
+void L3Book::clear()
+{
+    bids_.clear();
+    asks_.clear();
+    index_.clear();
+    seq_ = 0;
+}
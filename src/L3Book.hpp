@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include "Messages.hpp"
+
+// Consumer-side replica of one symbol's book, rebuilt from the L3 feed.
+// Incrementals must arrive with consecutive seqs; a gap clears the replica
+// and marks it STALE until the next snapshot of the symbol comes through
+// the stream (ask for one with InboundMsg::bookSnapshot). A replica that
+// starts before the symbol's first event (seq 1) needs no snapshot.
+class L3Book {
+public:
+    enum class State { STALE, SNAPSHOT, LIVE };   // SNAPSHOT: between BEGIN and END
+
+    explicit L3Book(SymbolId symbol) : symbol_(symbol) {}
+
+    // Ignores events of other types and symbols. Returns false when this
+    // event revealed a gap, i.e. when a snapshot should be requested.
+    bool apply(const OutboundMsg &ev);
+
+    State state() const noexcept { return state_; }
+    std::uint64_t seq() const noexcept { return seq_; }       // last applied
+    std::size_t orders() const noexcept { return index_.size(); }
+
+    // Quantity resting ahead of the order at its price level; -1 if unknown.
+    long long queueAhead(OrderId orderId) const noexcept;
+    // Best limit price and total quantity on a side; false if it is empty.
+    bool best(OrderSide side, PxTicks &px, long long &qty) const noexcept;
+
+private:
+    struct Entry { OrderId orderId; int qty; };
+    using Queue = std::list<Entry>;
+    struct Where { OrderSide side; PxTicks key; Queue::iterator it; };
+
+    static PxTicks keyOf(OrderSide side, PxTicks px) noexcept;
+    void add(OrderId id, OrderSide side, PxTicks px, int qty);
+    void remove(OrderId id);
+    void reduce(OrderId id, int qty);
+    void clear();
+
+    SymbolId symbol_;
+    State state_ = State::STALE;
+    std::uint64_t seq_ = 0;
+    std::map<PxTicks, Queue, std::greater<>> bids_;
+    std::map<PxTicks, Queue, std::less<>> asks_;
+    std::unordered_map<OrderId, Where> index_;
+};
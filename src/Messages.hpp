@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include "Order.hpp"
+#include "Price.hpp"
+#include "SymbolTable.hpp"
+
+// ────────── inbound (producer → runner) ──────────────────────────────────
+enum class InboundType : std::uint8_t {
+    NEW_ORDER = 0, CANCEL = 1, MODIFY = 2, MASS_CANCEL = 3,
+    AUCTION_START = 4, AUCTION_UNCROSS = 5, BOOK_SNAPSHOT = 6
+};
+
+enum InboundFlags : std::uint8_t {
+    IN_HAS_PX   = 1 << 0,  // MODIFY: px is set
+    IN_HAS_QTY  = 1 << 1,  // MODIFY: qty is set
+    IN_HAS_SIDE = 1 << 2,  // MASS_CANCEL: only cancel `side`
+    IN_RESUME   = 1 << 3,  // AUCTION_UNCROSS: return to continuous matching
+    IN_OWNER    = 1 << 4   // CANCEL / MODIFY: only an order of `account`
+};
+
+// One cache line, trivially copyable; layout mirrors tcx_msg in api_c.h.
+struct alignas(64) InboundMsg {
+    InboundType  type;
+    OrderSide    side;
+    OrderType    ordType;
+    std::uint8_t flags;
+    SymbolId     symbolId;
+    PxTicks      px;
+    OrderId      orderId;   // CANCEL / MODIFY target; unused for NEW_ORDER
+    int          qty;
+    AccountId    account;
+    std::uint64_t clientId; // echoed on the ack (NEW_ORDER) or any reject
+
+    static InboundMsg newOrder(SymbolId sym, const Order &o) noexcept {
+        InboundMsg m{};
+        m.type     = InboundType::NEW_ORDER;
+        m.side     = o.getSide();
+        m.ordType  = o.getType();
+        m.symbolId = sym;
+        m.px       = o.getPrice();
+        m.qty      = o.getQuantity();
+        m.account  = o.getAccount();
+        m.clientId = o.getClientId();
+        return m;
+    }
+    static InboundMsg cancel(OrderId orderId) noexcept {
+        InboundMsg m{};
+        m.type    = InboundType::CANCEL;
+        m.orderId = orderId;
+        return m;
+    }
+    static InboundMsg modify(OrderId orderId, std::optional<PxTicks> px,
+                             std::optional<int> qty) noexcept {
+        InboundMsg m{};
+        m.type    = InboundType::MODIFY;
+        m.orderId = orderId;
+        if (px)  { m.flags |= IN_HAS_PX;  m.px  = *px; }
+        if (qty) { m.flags |= IN_HAS_QTY; m.qty = *qty; }
+        return m;
+    }
+    // symbolId NONE cancels across all symbols.
+    static InboundMsg massCancel(AccountId account, SymbolId sym = SymbolTable::NONE,
+                                 std::optional<OrderSide> side = std::nullopt) noexcept {
+        InboundMsg m{};
+        m.type     = InboundType::MASS_CANCEL;
+        m.account  = account;
+        m.symbolId = sym;
+        if (side) { m.flags |= IN_HAS_SIDE; m.side = *side; }
+        return m;
+    }
+    // symbolId NONE applies to every book.
+    static InboundMsg auctionStart(SymbolId sym = SymbolTable::NONE) noexcept {
+        InboundMsg m{};
+        m.type     = InboundType::AUCTION_START;
+        m.symbolId = sym;
+        return m;
+    }
+    static InboundMsg auctionUncross(SymbolId sym = SymbolTable::NONE,
+                                     bool resumeContinuous = true) noexcept {
+        InboundMsg m{};
+        m.type     = InboundType::AUCTION_UNCROSS;
+        m.symbolId = sym;
+        if (resumeContinuous) m.flags |= IN_RESUME;
+        return m;
+    }
+    // Asks for the book's resting orders on the L3 feed; clientId is echoed
+    // on the snapshot's events.
+    static InboundMsg bookSnapshot(SymbolId sym, std::uint64_t clientId = 0) noexcept {
+        InboundMsg m{};
+        m.type     = InboundType::BOOK_SNAPSHOT;
+        m.symbolId = sym;
+        m.clientId = clientId;
+        return m;
+    }
+};
+
+// ────────── outbound (runner → consumers) ────────────────────────────────
+enum class OutboundType : std::uint8_t { TRADE = 0, TOB = 1, REJECT = 2, MASS_CANCEL = 3, ACK = 4,
+                                         L3 = 5, BAR = 6 };
+
+// L3 feed: ADD..EXEC mirror ExecutionEngine::BookChange and carry the
+// symbol's next seq. A snapshot is SNAPSHOT_BEGIN, one SNAPSHOT_ORDER per
+// resting order in priority order, then SNAPSHOT_END; all three carry the
+// seq the snapshot reflects, and the snapshot sits in the stream exactly
+// where that seq falls, so the next incremental is seq + 1.
+enum class L3Kind : std::uint8_t {
+    ADD = 0, MODIFY = 1, CANCEL = 2, EXEC = 3,
+    SNAPSHOT_BEGIN = 4, SNAPSHOT_ORDER = 5, SNAPSHOT_END = 6
+};
+
+struct TradeEvent      { PxTicks px; OrderId buyId; OrderId sellId; int qty; };
+struct TopOfBookEvt    { PxTicks bidPx; PxTicks askPx; int bidQty; int askQty; };
+struct RejectEvt       { OrderId orderId; std::uint64_t clientId; RejectReason reason; };
+struct MassCancelEvt   { AccountId account; int count; };
+struct AckEvt          { OrderId orderId; std::uint64_t clientId; };
+// qty: ADD / MODIFY / SNAPSHOT_ORDER the order's quantity, CANCEL / EXEC the
+// quantity removed, SNAPSHOT_BEGIN / END the number of orders.
+struct L3Evt           { std::uint64_t seq; OrderId orderId; PxTicks px;
+                         std::uint64_t clientId; int qty; OrderSide side; L3Kind kind; };
+// A closed bar; see TradeStats. The trade count is in the symbol's summary.
+struct BarEvt          { std::int64_t startNs; PxTicks open; PxTicks high; PxTicks low;
+                         PxTicks close; PxTicks vwap; std::int64_t volume; };
+
+// One cache line, trivially copyable; layout mirrors tcx_evt in api_c.h.
+struct alignas(64) OutboundMsg {
+    OutboundType type;
+    std::uint8_t pad_[3];
+    SymbolId     symbolId;
+    union {
+        TradeEvent   trade;
+        TopOfBookEvt tob;
+        RejectEvt    reject;
+        MassCancelEvt massCancel;
+        AckEvt       ack;
+        L3Evt        l3;
+        BarEvt       bar;
+    };
+};
+
+static_assert(std::is_trivially_copyable_v<InboundMsg>  && sizeof(InboundMsg)  == 64);
+static_assert(std::is_trivially_copyable_v<OutboundMsg> && sizeof(OutboundMsg) == 64);
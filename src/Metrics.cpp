@@ -0,0 +1,71 @@
+#include "Metrics.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+static std::atomic<std::uint64_t> nextRegistry{1};
+static std::atomic<std::uint32_t> nextSegment{0};
+
+Metrics::Metrics()
+    : id_(nextRegistry.fetch_add(1, std::memory_order_relaxed))
+{
+    const std::string name = "tcx-metrics." + std::to_string(getpid()) + "." +
+                             std::to_string(nextSegment.fetch_add(1, std::memory_order_relaxed));
+    map_ = ShmMapping::open(name, sizeof(MetricsRegion), true);
+    if (map_) {
+        region_ = new (map_.data()) MetricsRegion();
+        name_ = name;
+    } else {
+        heap_ = std::make_unique<MetricsRegion>();
+        region_ = heap_.get();
+    }
+    region_->pid = getpid();
+    region_->startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    region_->magic.store(METRICS_MAGIC, std::memory_order_release);
+}
+
+Metrics::Local& Metrics::claim() noexcept
+{
+    // blocks are never given back, so a thread keeps its block if this
+    // registry is evicted from its cache and later claims another one
+    static thread_local int evict = 0;
+    Local* l = nullptr;
+    for (Local& c : locals_)
+        if (c.owner == 0) { l = &c; break; }
+    if (!l) { l = &locals_[evict]; evict = (evict + 1) % LOCAL_CACHE; }
+
+    std::uint32_t i = region_->threads.load(std::memory_order_relaxed);
+    while (i < METRICS_THREADS &&
+           !region_->threads.compare_exchange_weak(i, i + 1, std::memory_order_relaxed)) {}
+    l->owner  = id_;
+    l->shared = i >= METRICS_THREADS - 1;
+    l->block  = &region_->block[l->shared ? METRICS_THREADS - 1 : i];
+    return *l;
+}
+
+void Metrics::setBookOrders(SymbolId sym, std::uint32_t orders, const std::string& name) noexcept
+{
+    if (sym >= METRICS_BOOKS) return;
+    MetricsRegion::Book& b = region_->book[sym];
+    if (!b.name[0]) {
+        std::strncpy(b.name, name.c_str(), SHM_SYMBOL_LEN - 1);
+        if (region_->books.load(std::memory_order_relaxed) <= sym)
+            region_->books.store(sym + 1, std::memory_order_release);
+    }
+    b.orders.store(orders, std::memory_order_relaxed);
+}
+
+MetricsSnapshot readMetrics(const MetricsRegion& r) noexcept
+{
+    MetricsSnapshot s;
+    const std::uint32_t n = std::min(r.threads.load(std::memory_order_acquire), METRICS_THREADS);
+    for (std::uint32_t t = 0; t < n; ++t)
+        for (std::uint32_t m = 0; m < METRIC_COUNT; ++m)
+            s.v[m] += r.block[t].v[m].load(std::memory_order_relaxed);
+    return s;
+}
@@ -1,50 +1,71 @@
 #include "Order.hpp"
 
-std::atomic<int> Order::nextOrderId{0};
+const char *toString(RejectReason r) noexcept {
+    switch (r) {
+    case RejectReason::NONE:            return "none";
+    case RejectReason::NULL_ORDER:      return "null order";
+    case RejectReason::EMPTY_SYMBOL:    return "symbol must not be empty";
+    case RejectReason::BAD_QTY:         return "quantity must be positive";
+    case RejectReason::BAD_PRICE:       return "price must be positive and on the tick for non-market orders";
+    case RejectReason::QTY_LIMIT:       return "quantity exceeds limit";
+    case RejectReason::SYMBOL_MISMATCH: return "order symbol does not match book";
+    case RejectReason::UNKNOWN_ORDER:   return "unknown order id";
+    case RejectReason::INACTIVE_ORDER:  return "order is cancelled or filled";
+    case RejectReason::UNKNOWN_ACCOUNT: return "unknown account";
+    case RejectReason::NOTIONAL_LIMIT:  return "open notional limit exceeded";
+    case RejectReason::OPEN_ORDER_LIMIT:return "open order limit exceeded";
+    case RejectReason::POSITION_LIMIT:  return "position limit exceeded";
+    case RejectReason::THROTTLED:       return "throttled: engine queue full or out of credits";
+    }
+    return "unknown";
+}
 
-Order::Order(const std::string &symbol, OrderSide side, OrderType type, double price, int quantity) : 
+Order::Order(const std::string &symbol, OrderSide side, OrderType type, double price, int quantity,
+             AccountId account) : 
+    Order(NO_ORDER, symbol, side, type, toTicks(price), quantity, account) {}
+
+Order::Order(OrderId orderId, const std::string &symbol, OrderSide side, OrderType type, PxTicks price, int quantity,
+             AccountId account) :
+    orderId(orderId),
     symbol(symbol),
     side(side),
     type(type),
     price(price),
     quantity(quantity),
-    active(true) 
-{
-    if (symbol.empty()) throw std::invalid_argument("Symbol must not be empty");
-    if (quantity <= 0) throw std::invalid_argument("Quantity must be positive");
-    if (type != OrderType::MARKET && price <= 0.0) {
-        throw std::invalid_argument("Price must be positive for non-market orders");
-    }
-    orderId = nextOrderId.fetch_add(1, std::memory_order_relaxed);
-}
-
+    account(account),
+    active(true) {}
 
-int Order::getOrderId() const { return orderId; }
+OrderId Order::getOrderId() const { return orderId; }
 OrderSide Order::getSide() const { return side; }
 OrderType Order::getType() const { return type; }
-double Order::getPrice() const { return price; }
+PxTicks Order::getPrice() const { return price; }
 int Order::getQuantity() const { return quantity; }
 bool Order::isActive() const { return active; }
 const std::string &Order::getSymbol() const { return symbol; }
+AccountId Order::getAccount() const { return account; }
 
-void Order::modify(double newPrice, int newQuantity) {
-    if (!active) throw std::logic_error("Cannot modify a cancelled/filled order");
-    if (newQuantity < 0) throw std::invalid_argument("Quantity cannot be negative");
+RejectReason Order::validate() const noexcept {
+    if (symbol.empty()) return RejectReason::EMPTY_SYMBOL;
+    if (quantity <= 0) return RejectReason::BAD_QTY;
+    if (type != OrderType::MARKET && price <= 0) return RejectReason::BAD_PRICE;
+    return RejectReason::NONE;
+}
 
-    if (type != OrderType::MARKET && newPrice <= 0.0) {
-        throw std::invalid_argument("Price must positive for non-market orders");
-    }
+RejectReason Order::modify(PxTicks newPrice, int newQuantity) noexcept {
+    if (!active) return RejectReason::INACTIVE_ORDER;
+    if (newQuantity < 0) return RejectReason::BAD_QTY;
+    if (type != OrderType::MARKET && newPrice <= 0) return RejectReason::BAD_PRICE;
 
     price = newPrice;
     quantity = newQuantity;
 
     if (quantity == 0) active = false;
+    return RejectReason::NONE;
 }
 
-void Order::reduceQuantity(int tradedQty) {
-    if (tradedQty <= 0) throw std::invalid_argument("Traded qty must be positive");
-    if (tradedQty > quantity) throw std::invalid_argument("Traded qty exceeds resting qty");
-    modify(price, quantity - tradedQty);
+RejectReason Order::reduceQuantity(int tradedQty) noexcept {
+    if (tradedQty <= 0 || tradedQty > quantity) return RejectReason::BAD_QTY;
+    return modify(price, quantity - tradedQty);
 }
 
 void Order::cancel() {
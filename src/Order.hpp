@@ -1,15 +1,64 @@
 #pragma once 
 
 #include <string>
-#include <atomic>
-#include <stdexcept>
+#include <cstdint>
+#include "Price.hpp"
 
-enum class OrderSide { BUY, SELL };
-enum class OrderType { LIMIT, MARKET, STOP };
+// Underlying values mirror tcx_side / tcx_type in api_c.h so messages can
+// cross the C boundary byte-for-byte.
+enum class OrderSide : std::uint8_t { BUY = 0, SELL = 1 };
+enum class OrderType : std::uint8_t { LIMIT = 1, MARKET = 2, STOP = 3 };
+
+using AccountId = std::uint32_t;
+
+// Order ids are minted by the owning shard when it accepts an order:
+// bits 62..48 carry the shard and bits 47..0 its sequence, so an id routes
+// itself without a lookup. 0 means "not accepted (yet)".
+using OrderId = std::int64_t;
+using ShardId = std::uint16_t;
+constexpr int     ORDER_SEQ_BITS = 48;
+constexpr ShardId MAX_SHARD      = 0x7FFF;
+constexpr OrderId NO_ORDER       = 0;
+
+constexpr OrderId makeOrderId(ShardId shard, std::uint64_t seq) noexcept {
+    return static_cast<OrderId>((static_cast<std::uint64_t>(shard & MAX_SHARD) << ORDER_SEQ_BITS) |
+                                (seq & ((std::uint64_t{1} << ORDER_SEQ_BITS) - 1)));
+}
+constexpr ShardId shardOf(OrderId id) noexcept {
+    return static_cast<ShardId>(static_cast<std::uint64_t>(id) >> ORDER_SEQ_BITS);
+}
+
+enum class RejectReason : std::uint8_t {
+    NONE = 0,
+    NULL_ORDER,
+    EMPTY_SYMBOL,
+    BAD_QTY,
+    BAD_PRICE,
+    QTY_LIMIT,
+    SYMBOL_MISMATCH,
+    UNKNOWN_ORDER,
+    INACTIVE_ORDER,
+    UNKNOWN_ACCOUNT,
+    NOTIONAL_LIMIT,
+    OPEN_ORDER_LIMIT,
+    POSITION_LIMIT,
+    THROTTLED
+};
+
+const char *toString(RejectReason r) noexcept;
 
 class Order{
 public:
-    Order(const std::string &symbol, OrderSide side, OrderType type, double price, int quantity);
+    // Never throws: malformed orders are constructed as-is and caught by
+    // validate() at the engine's entry, which turns them into rejects.
+    // The id stays NO_ORDER until the engine accepts the order; the price
+    // is rounded to the nearest tick.
+    Order(const std::string &symbol, OrderSide side, OrderType type, double price, int quantity,
+          AccountId account = 0);
+    // Rebuilds an order whose id (NO_ORDER if not accepted yet) and price
+    // in ticks are already known.
+    Order(OrderId orderId, const std::string &symbol, OrderSide side, OrderType type, PxTicks price, int quantity,
+          AccountId account = 0);
 
     Order(const Order &) = default;
     Order(Order &&) noexcept = default;
@@ -17,26 +66,33 @@ public:
     Order &operator=(Order &&) noexcept = default;
     ~Order() = default;
 
-    int getOrderId() const;
+    OrderId getOrderId() const;
+    void assignId(OrderId id) noexcept { orderId = id; }
+    // Opaque tag chosen by the client, echoed on the order's ack or reject.
+    std::uint64_t getClientId() const { return clientId; }
+    void setClientId(std::uint64_t id) noexcept { clientId = id; }
     OrderSide getSide() const;
     OrderType getType() const;
-    double getPrice() const;
+    PxTicks getPrice() const;
     int getQuantity() const;
     bool isActive() const;
     const std::string &getSymbol() const;
+    AccountId getAccount() const;
 
-    void modify(double newPrice, int newQuantity);
-    void reduceQuantity(int tradedQty);
+    RejectReason validate() const noexcept;
+    RejectReason modify(PxTicks newPrice, int newQuantity) noexcept;
+    RejectReason reduceQuantity(int tradedQty) noexcept;
 
     void cancel();
 
 private:
-    static std::atomic<int> nextOrderId;
-    int orderId;
+    OrderId orderId;
+    std::uint64_t clientId = 0;
     std::string symbol;
     OrderSide side;
     OrderType type;
-    double price;
+    PxTicks price;
     int quantity;
+    AccountId account;
     bool active;
-};
\ No newline at end of file
+};
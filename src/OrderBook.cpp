@@ -1,58 +1,69 @@
 #include "OrderBook.hpp"
 #include <algorithm>
+#include <cstdlib>
 
-namespace {
-constexpr double BUY_MKT_KEY  =  std::numeric_limits<double>::max();
-constexpr double SELL_MKT_KEY = -std::numeric_limits<double>::max();
-
-inline double keyFor(const std::shared_ptr<Order>& o)
-{
-    if (o->getType() == OrderType::MARKET)
-        return (o->getSide() == OrderSide::BUY) ? BUY_MKT_KEY : SELL_MKT_KEY;
-    return o->getPrice();
+template <typename P>
+bool BasicOrderBook<P>::isMarket(const Order &o) noexcept {
+    if constexpr (P::marketOrders) return o.getType() == OrderType::MARKET;
+    else return false;
 }
+
+template <typename P>
+typename BasicOrderBook<P>::Key BasicOrderBook<P>::keyFor(const Order &o) noexcept {
+    if (isMarket(o))
+        return (o.getSide() == OrderSide::BUY) ? BUY_MKT_KEY : SELL_MKT_KEY;
+    return o.getPrice();
 }
 
-OrderBook::OrderBook(const std::string &symbol) : symbol(symbol) {}
+template <typename P>
+BasicOrderBook<P>::BasicOrderBook(const std::string &symbol, SymbolId symbolId) : symbol(symbol), symbolId(symbolId) {}
 
-int OrderBook::addOrder(const std::shared_ptr<Order> &order) {
-    if (!order || order->getSymbol() != symbol) {
-        throw std::invalid_argument("Order symbol mismatch or null order");
-    }
+template <typename P>
+OrderId BasicOrderBook<P>::addOrder(const std::shared_ptr<Order> &order) noexcept {
+    if (!order || order->getSymbol() != symbol) return -1;
+    if constexpr (!P::marketOrders)
+        if (order->getType() == OrderType::MARKET) return -1;
 
     std::lock_guard lock(mtx);
-    int id = order->getOrderId();
-    ordersById[id] = order;
+    if (order->getOrderId() == NO_ORDER) order->assignId(makeOrderId(0, ++localSeq));
+    OrderId id = order->getOrderId();
+    ordersById.insert(id, order);
     insertOrder(order);
+    indexAccount(order);
     return id;
 }
 
-bool OrderBook::removeOrder(int orderId) {
+template <typename P>
+bool BasicOrderBook<P>::removeOrder(OrderId orderId) noexcept {
     std::lock_guard lock(mtx);
-    auto it = ordersById.find(orderId);
-    if (it == ordersById.end()) return false;
+    auto *o = ordersById.find(orderId);
+    if (!o) return false;
 
-    it->second->cancel();
-    eraseOrder(it->second);
-    ordersById.erase(it);
+    (*o)->cancel();
+    eraseOrder(*o);
+    ordersById.erase(orderId);
     return true;
 }
 
-bool OrderBook::modifyOrder(int orderId, std::optional<double> newPrice, std::optional<int> newQty) {
+template <typename P>
+bool BasicOrderBook<P>::modifyOrder(OrderId orderId, std::optional<PxTicks> newPrice, std::optional<int> newQty) noexcept {
     std::lock_guard lock(mtx);
-    auto it = ordersById.find(orderId);
+    auto *found = ordersById.find(orderId);
 
-    if (it == ordersById.end()) return false;
-    auto &ord = it->second;
+    if (!found) return false;
+    auto ord = *found;
     if (!ord->isActive()) return false;
 
-    eraseOrder(ord);
-    double price = newPrice.value_or(ord->getPrice());
+    PxTicks price = newPrice.value_or(ord->getPrice());
     int qty = newQty.value_or(ord->getQuantity());
+    if (qty < 0) return false;
+    if (qty > 0 && !isMarket(*ord) && price <= 0) return false;
+
+    eraseOrder(ord);
 
     if (qty <= 0) {
         ord->cancel();
-        ordersById.erase(it);
+        ordersById.erase(orderId);
         return true;
     }
 
@@ -61,27 +72,72 @@ bool OrderBook::modifyOrder(int orderId, std::optional<double> newPrice, std::op
     return true;
 }
 
-std::shared_ptr<Order> OrderBook::getBestBid() const
+template <typename P>
+std::vector<CancelledOrder> BasicOrderBook<P>::removeAccountOrders(AccountId account,
+                                                          std::optional<OrderSide> side) noexcept {
+    std::lock_guard lock(mtx);
+    std::vector<CancelledOrder> out;
+    if (account >= byAccount.size()) return out;
+
+    std::vector<Key> buyKeys, sellKeys;
+    auto &orders = byAccount[account];
+    auto keep = orders.begin();
+    for (auto &o : orders) {
+        if (!o->isActive()) continue;
+        if (side && o->getSide() != *side) { *keep++ = std::move(o); continue; }
+
+        bool mkt = isMarket(*o);
+        out.push_back({o->getOrderId(), o->getSide(), mkt ? 0 : o->getPrice(), o->getQuantity()});
+        auto &keys = (o->getSide() == OrderSide::BUY) ? buyKeys : sellKeys;
+        if (keys.empty() || keys.back() != keyFor(*o)) keys.push_back(keyFor(*o));
+        ordersById.erase(o->getOrderId());
+        o->cancel();
+    }
+    orders.erase(keep, orders.end());
+
+    purgeInactive(buyOrders, buyKeys);
+    purgeInactive(sellOrders, sellKeys);
+    return out;
+}
+
+template <typename P>
+template <typename Levels>
+void BasicOrderBook<P>::purgeInactive(Levels &levels, const std::vector<Key> &keys) {
+    for (Key k : keys) {
+        auto it = levels.find(k);
+        if (it == levels.end()) continue;
+        auto &q = it->second;
+        q.erase(std::remove_if(q.begin(), q.end(),
+                               [](const auto &o) { return !o->isActive(); }),
+                q.end());
+        if (q.empty()) levels.erase(it);
+    }
+}
+
+template <typename P>
+std::shared_ptr<Order> BasicOrderBook<P>::getBestBid() const
 {
     std::lock_guard lock(mtx);
     for (const auto& [price, q] : buyOrders)
         for (const auto& o : q)
-            if (o->isActive() && o->getType() != OrderType::MARKET)
+            if (o->isActive() && !isMarket(*o))
                 return o;
     return nullptr;
 }
 
-std::shared_ptr<Order> OrderBook::getBestAsk() const
+template <typename P>
+std::shared_ptr<Order> BasicOrderBook<P>::getBestAsk() const
 {
     std::lock_guard lock(mtx);
     for (const auto& [price, q] : sellOrders)
         for (const auto& o : q)
-            if (o->isActive() && o->getType() != OrderType::MARKET)
+            if (o->isActive() && !isMarket(*o))
                 return o;
     return nullptr;
 }
 
-std::vector<std::shared_ptr<Order>> OrderBook::getBuyOrders() const {
+template <typename P>
+std::vector<std::shared_ptr<Order>> BasicOrderBook<P>::getBuyOrders() const {
     std::lock_guard lock(mtx);
     std::vector<std::shared_ptr<Order>> out;
     for (const auto &[price, queue] : buyOrders) {
@@ -91,7 +147,8 @@ std::vector<std::shared_ptr<Order>> OrderBook::getBuyOrders() const {
     return out;
 }
 
-std::vector<std::shared_ptr<Order>> OrderBook::getSellOrders() const {
+template <typename P>
+std::vector<std::shared_ptr<Order>> BasicOrderBook<P>::getSellOrders() const {
     std::lock_guard lock(mtx);
     std::vector<std::shared_ptr<Order>> out;
     for (const auto &[price, queue] : sellOrders) {
@@ -101,10 +158,8 @@ std::vector<std::shared_ptr<Order>> OrderBook::getSellOrders() const {
     return out;
 }
 
-std::vector<Match> OrderBook::match() {
-    std::lock_guard lock(mtx);
-    std::vector<Match> executions;
-
+template <typename P>
+bool BasicOrderBook<P>::frontPair(std::shared_ptr<Order> &buy, std::shared_ptr<Order> &sell) {
     while (!buyOrders.empty() && !sellOrders.empty()) {
         auto &buyQ = buyOrders.begin()->second;
         auto &sellQ = sellOrders.begin()->second;
@@ -122,57 +177,211 @@ std::vector<Match> OrderBook::match() {
             continue;
         }
 
-        auto buy = buyQ.front();
-        auto sell = sellQ.front();
+        buy = buyQ.front();
+        sell = sellQ.front();
+        return true;
+    }
+    return false;
+}
+
+template <typename P>
+void BasicOrderBook<P>::fillFront(const std::shared_ptr<Order> &buy, const std::shared_ptr<Order> &sell,
+                          PxTicks px, int qty, std::vector<Match> &executions) {
+    buy->reduceQuantity(qty);
+    sell->reduceQuantity(qty);
+
+    Match m{buy->getOrderId(), sell->getOrderId(), px, qty};
+    m.buyAccount  = buy->getAccount();
+    m.sellAccount = sell->getAccount();
+    m.buyLimit    = isMarket(*buy)  ? 0 : buy ->getPrice();
+    m.sellLimit   = isMarket(*sell) ? 0 : sell->getPrice();
+    m.buyDone     = !buy->isActive();
+    m.sellDone    = !sell->isActive();
+    executions.push_back(m);
+
+    if (!buy->isActive()) {
+        auto &buyQ = buyOrders.begin()->second;
+        buyQ.pop_front();
+        ordersById.erase(buy->getOrderId());
+        if (buyQ.empty()) buyOrders.erase(buyOrders.begin());
+    }
+
+    if (!sell->isActive()) {
+        auto &sellQ = sellOrders.begin()->second;
+        sellQ.pop_front();
+        ordersById.erase(sell->getOrderId());
+        if (sellQ.empty()) sellOrders.erase(sellOrders.begin());
+    }
+}
+
+template <typename P>
+std::vector<Match> BasicOrderBook<P>::match() noexcept {
+    std::lock_guard lock(mtx);
+    std::vector<Match> executions;
+    if constexpr (P::callAuction)
+        if (auction) return executions;
 
-        bool crossed = buy->getType() == OrderType::MARKET || sell->getType() == OrderType::MARKET || buy->getPrice() >= sell->getPrice();
-        if (!crossed) break;
+    std::shared_ptr<Order> buy, sell;
+    while (frontPair(buy, sell)) {
+        // market orders sit at the extreme keys, so they always cross
+        if (buyOrders.begin()->first < sellOrders.begin()->first) break;
 
         int qty = std::min(buy->getQuantity(), sell->getQuantity());
-        double px;
-        if      (buy ->getType() == OrderType::MARKET) px = sell->getPrice();
-        else if (sell->getType() == OrderType::MARKET) px = buy ->getPrice();
-        else                                           
-            px = (buy->getPrice() >= sell->getPrice())
-                ? buy ->getPrice()   // buy resting -> trade @ bid 
-                : sell->getPrice();  // sell resting -> trade @ ask 
+        // trade at the resting limit; a market buy takes the ask
+        PxTicks px = isMarket(*buy) ? sell->getPrice() : buy->getPrice();
 
+        fillFront(buy, sell, px, qty, executions);
+    }
 
-        buy->reduceQuantity(qty);
-        sell->reduceQuantity(qty);
+    return executions;
+}
+
+template <typename P>
+void BasicOrderBook<P>::setAuction(bool on) noexcept {
+    std::lock_guard lock(mtx);
+    if constexpr (P::callAuction) auction = on;
+    else (void)on;
+}
 
-        executions.push_back({buy->getOrderId(), sell->getOrderId(), px, qty});
+template <typename P>
+void BasicOrderBook<P>::reserve(std::size_t orders) {
+    std::lock_guard lock(mtx);
+    ordersById.reserve(orders);
+}
 
-        if (!buy->isActive()) {
-            buyQ.pop_front();
-            ordersById.erase(buy->getOrderId());
-            if (buyQ.empty()) buyOrders.erase(buyOrders.begin());
-        }
+template <typename P>
+std::size_t BasicOrderBook<P>::capacity() const noexcept {
+    std::lock_guard lock(mtx);
+    return ordersById.capacity();
+}
+
+template <typename P>
+bool BasicOrderBook<P>::inAuction() const noexcept {
+    std::lock_guard lock(mtx);
+    return P::callAuction && auction;
+}
+
+template <typename P>
+AuctionResult BasicOrderBook<P>::indicative() const noexcept {
+    std::lock_guard lock(mtx);
+    return equilibrium();
+}
 
-        if (!sell->isActive()) {
-            sellQ.pop_front();
-            ordersById.erase(sell->getOrderId());
-            if (sellQ.empty()) sellOrders.erase(sellOrders.begin());
+// Executable volume at p is min(demand at or above p, supply at or below p).
+// Both curves are built in one ascending sweep over the aggregated limit
+// levels of each side; market orders count towards every price.
+template <typename P>
+AuctionResult BasicOrderBook<P>::equilibrium() const noexcept {
+    auto levelQty = [](const auto &q) {
+        long long n = 0;
+        for (const auto &o : q) if (o->isActive()) n += o->getQuantity();
+        return n;
+    };
+
+    long long demand = 0, mktSupply = 0;
+    for (const auto &[k, q] : buyOrders) demand += levelQty(q);
+    auto sit = sellOrders.begin();
+    if (sit != sellOrders.end() && sit->first == SELL_MKT_KEY) { mktSupply = levelQty(sit->second); ++sit; }
+
+    AuctionResult best;
+    long long supply = mktSupply, bestSurplus = 0;
+    auto bit = buyOrders.rbegin();
+    auto bend = buyOrders.rend();
+    if (!buyOrders.empty() && buyOrders.begin()->first == BUY_MKT_KEY) --bend;  // market bids never drop out
+
+    while (bit != bend || sit != sellOrders.end()) {
+        Key p = (sit == sellOrders.end()) ? bit->first
+              : (bit == bend)             ? sit->first
+              : std::min(bit->first, sit->first);
+
+        while (sit != sellOrders.end() && sit->first == p) { supply += levelQty(sit->second); ++sit; }
+
+        long long vol = std::min(demand, supply);
+        long long surplus = demand - supply;
+        if (vol > 0 && (vol > best.volume ||
+                        (vol == best.volume && std::llabs(surplus) < std::llabs(bestSurplus)))) {
+            best = {p, static_cast<int>(vol), static_cast<int>(surplus)};
+            bestSurplus = surplus;
         }
+
+        // bids at p take part at p, but not above it
+        while (bit != bend && bit->first == p) { demand -= levelQty(bit->second); ++bit; }
     }
+    return best;
+}
+
+template <typename P>
+std::vector<Match> BasicOrderBook<P>::uncross() noexcept {
+    std::lock_guard lock(mtx);
+    std::vector<Match> executions;
 
+    AuctionResult eq = equilibrium();
+    int left = eq.volume;
+    std::shared_ptr<Order> buy, sell;
+    while (left > 0 && frontPair(buy, sell)) {
+        int qty = std::min({buy->getQuantity(), sell->getQuantity(), left});
+        fillFront(buy, sell, eq.price, qty, executions);
+        left -= qty;
+    }
     return executions;
 }
 
-const std::string &OrderBook::getSymbol() const { return symbol; }
+template <typename P>
+template <typename Levels>
+int BasicOrderBook<P>::topLevels(const Levels &levels, PriceLevel *out) noexcept {
+    int n = 0;
+    for (const auto &[k, q] : levels) {
+        if (n == BookSnapshot::DEPTH) break;
+        if (k == BUY_MKT_KEY || k == SELL_MKT_KEY) continue;
+        PriceLevel lvl{k, 0, 0};
+        for (const auto &o : q)
+            if (o->isActive()) { lvl.qty += o->getQuantity(); ++lvl.orders; }
+        if (lvl.orders) out[n++] = lvl;
+    }
+    return n;
+}
+
+template <typename P>
+void BasicOrderBook<P>::publish() noexcept {
+    BookSnapshot snap;
+    std::lock_guard lock(mtx);
+    snap.version = ++version;
+    snap.nBids = topLevels(buyOrders, snap.bids);
+    snap.nAsks = topLevels(sellOrders, snap.asks);
+    published.store(snap);
+}
+
+template <typename P>
+const std::string &BasicOrderBook<P>::getSymbol() const { return symbol; }
 
-void OrderBook::insertOrder(const std::shared_ptr<Order>& o)
+template <typename P>
+void BasicOrderBook<P>::insertOrder(const std::shared_ptr<Order>& o)
 {
-    double k = keyFor(o);
+    Key k = keyFor(*o);
     if (o->getSide() == OrderSide::BUY)
         buyOrders[k].push_back(o);
     else
         sellOrders[k].push_back(o);
 }
 
-void OrderBook::eraseOrder(const std::shared_ptr<Order>& o)
+template <typename P>
+void BasicOrderBook<P>::indexAccount(const std::shared_ptr<Order>& o)
 {
-    double k = keyFor(o);
+    AccountId a = o->getAccount();
+    if (a > MAX_INDEXED_ACCOUNT) return;
+    if (a >= byAccount.size()) byAccount.resize(a + 1);
+    auto &orders = byAccount[a];
+    if (orders.size() == orders.capacity())
+        orders.erase(std::remove_if(orders.begin(), orders.end(),
+                                    [](const auto &p) { return !p->isActive(); }),
+                     orders.end());
+    orders.push_back(o);
+}
+
+template <typename P>
+void BasicOrderBook<P>::eraseOrder(const std::shared_ptr<Order>& o)
+{
+    Key k = keyFor(*o);
 
     if (o->getSide() == OrderSide::BUY) {
         auto it = buyOrders.find(k);
@@ -191,13 +400,17 @@ void OrderBook::eraseOrder(const std::shared_ptr<Order>& o)
 }
 
 
-std::shared_ptr<Order> OrderBook::getOrder(int orderId) const
+template <typename P>
+std::shared_ptr<Order> BasicOrderBook<P>::getOrder(OrderId orderId) const
 {
     std::lock_guard lock(mtx);
-    auto it = ordersById.find(orderId);
-    return (it == ordersById.end()) ? nullptr : it->second;
+    auto *o = ordersById.find(orderId);
+    return o ? *o : nullptr;
 }
 
 
 
 
+
+template class BasicOrderBook<DefaultBookPolicy>;
+template class BasicOrderBook<LimitShardPolicy>;
@@ -10,42 +10,162 @@
 #include <limits>
 #include <functional>
 #include "Order.hpp"
+#include "SymbolTable.hpp"
+#include "Seqlock.hpp"
+#include "FlatIdMap.hpp"
+#include "Messages.hpp"
 
 struct Match {
-    int    buyId;
-    int    sellId;
-    double price;
-    int    qty;
+    OrderId buyId;
+    OrderId sellId;
+    PxTicks price;
+    int     qty;
+
+    // Resting state of both sides, for exposure bookkeeping.
+    AccountId buyAccount  = 0;
+    AccountId sellAccount = 0;
+    PxTicks buyLimit  = 0;      // 0 for market orders
+    PxTicks sellLimit = 0;
+    bool    buyDone   = false;  // order left the book with this fill
+    bool    sellDone  = false;
+};
+
+struct CancelledOrder {
+    OrderId   orderId;
+    OrderSide side;
+    PxTicks   limit;            // 0 for market orders
+    int       qty;              // quantity left when cancelled
+};
+
+struct AuctionResult {
+    PxTicks price   = 0;
+    int     volume  = 0;    // 0: nothing to uncross
+    int     surplus = 0;    // demand - supply at price
+};
+
+struct PriceLevel {
+    PxTicks px;
+    int     qty;                // total resting quantity
+    int     orders;
+};
+
+// Top-of-book levels as of the last publish(). Market orders are not shown.
+struct BookSnapshot {
+    static constexpr int DEPTH = 10;
+    std::uint64_t version = 0;  // bumped on every publish
+    int nBids = 0;
+    int nAsks = 0;
+    PriceLevel bids[DEPTH] = {};
+    PriceLevel asks[DEPTH] = {};
+};
+
+// ────────── policies ─────────────────────────────────────────────────────
+// A book policy bundles the compile-time choices of a BasicOrderBook:
+//   Mutex        std::mutex, or NullMutex for a book owned by one thread
+//   marketOrders false drops every market-order branch; addOrder rejects them
+//   callAuction  false drops auction mode; match() never checks for it
+struct NullMutex {
+    void lock() noexcept {}
+    void unlock() noexcept {}
+    bool try_lock() noexcept { return true; }
 };
 
+struct DefaultBookPolicy {
+    using Mutex = std::mutex;
+    static constexpr bool marketOrders = true;
+    static constexpr bool callAuction  = true;
+};
 
-class OrderBook {
+// Limit orders only, no locking: for a shard whose
+// matching thread is the only one that touches the book.
+struct LimitShardPolicy {
+    using Mutex = NullMutex;
+    static constexpr bool marketOrders = false;
+    static constexpr bool callAuction  = false;
+};
+
+template <typename Policy>
+class BasicOrderBook {
 public:
-    explicit OrderBook(const std::string &symbol);
-    int addOrder(const std::shared_ptr<Order> &order);
-    bool removeOrder(int orderId);
-    bool modifyOrder(int orderId, std::optional<double> newPrice = std::nullopt, std::optional<int> newQty = std::nullopt);
+    // Levels are keyed on the exact tick price.
+    using Key = PxTicks;
+
+    explicit BasicOrderBook(const std::string &symbol, SymbolId symbolId = SymbolTable::NONE);
+    // Returns the order id, or -1 for a null order, a symbol mismatch or an
+    // order type the policy does not support. An order without an id (a book
+    // used on its own, outside the engine) gets a book-local one.
+    OrderId addOrder(const std::shared_ptr<Order> &order) noexcept;
+    bool removeOrder(OrderId orderId) noexcept;
+    bool modifyOrder(OrderId orderId, std::optional<PxTicks> newPrice = std::nullopt, std::optional<int> newQty = std::nullopt) noexcept;
+    // Cancels every resting order of an account (optionally one side only)
+    // in a single pass over its index and the price levels it touched.
+    std::vector<CancelledOrder> removeAccountOrders(AccountId account,
+        std::optional<OrderSide> side = std::nullopt) noexcept;
 
     std::shared_ptr<Order> getBestBid() const;
     std::shared_ptr<Order> getBestAsk() const;
-    std::shared_ptr<Order> getOrder(int orderId) const;
+    std::shared_ptr<Order> getOrder(OrderId orderId) const;
     std::vector<std::shared_ptr<Order>> getBuyOrders() const;
     std::vector<std::shared_ptr<Order>> getSellOrders() const;
 
-    std::vector<Match> match();
+    std::vector<Match> match() noexcept;
+
+    // In auction mode match() does nothing and orders accumulate; uncross()
+    // then executes everything it can at the single price that maximises
+    // volume (ties: smallest surplus, then lowest price). The mode is left
+    // unchanged, so repeated uncross() calls give periodic batch auctions.
+    void setAuction(bool on) noexcept;
+    bool inAuction() const noexcept;
+    AuctionResult indicative() const noexcept;
+    std::vector<Match> uncross() noexcept;
+
+    // The matching thread publishes after each complete operation; snapshot()
+    // can then be read from any thread without touching the book lock.
+    void publish() noexcept;
+    BookSnapshot snapshot() const noexcept { return published.load(); }
+
+    // Sizes the order index for `orders` resting orders, so it does not
+    // rehash on the matching thread until there are more.
+    void reserve(std::size_t orders);
+    std::size_t capacity() const noexcept;
+
     const std::string &getSymbol() const;
+    SymbolId getSymbolId() const { return symbolId; }
 
 private:
-    static constexpr double BUY_MKT_KEY  =  std::numeric_limits<double>::max();
-    static constexpr double SELL_MKT_KEY = -std::numeric_limits<double>::max();
+    static constexpr Key BUY_MKT_KEY  = std::numeric_limits<Key>::max();
+    static constexpr Key SELL_MKT_KEY = std::numeric_limits<Key>::lowest();
+    static bool isMarket(const Order &o) noexcept;
+    static Key keyFor(const Order &o) noexcept;
     void insertOrder(const std::shared_ptr<Order> &o);
     void eraseOrder(const std::shared_ptr<Order> &o);
+    void indexAccount(const std::shared_ptr<Order> &o);
+    bool frontPair(std::shared_ptr<Order> &buy, std::shared_ptr<Order> &sell);
+    void fillFront(const std::shared_ptr<Order> &buy, const std::shared_ptr<Order> &sell,
+                   PxTicks px, int qty, std::vector<Match> &executions);
+    AuctionResult equilibrium() const noexcept;
+    template <typename Levels> static int topLevels(const Levels &levels, PriceLevel *out) noexcept;
+    template <typename Levels> void purgeInactive(Levels &levels, const std::vector<Key> &keys);
 
     std::string symbol;
-    std::map<int, std::shared_ptr<Order>> ordersById;
+    SymbolId symbolId;
+    FlatIdMap<OrderId, std::shared_ptr<Order>> ordersById;
+    std::uint64_t localSeq = 0;
 
-    std::map<double, std::deque<std::shared_ptr<Order>>, std::greater<>> buyOrders;
-    std::map<double, std::deque<std::shared_ptr<Order>>, std::less<>> sellOrders;
-    mutable std::mutex mtx;
+    std::map<Key, std::deque<std::shared_ptr<Order>>, std::greater<>> buyOrders;
+    std::map<Key, std::deque<std::shared_ptr<Order>>, std::less<>> sellOrders;
+    static constexpr AccountId MAX_INDEXED_ACCOUNT = 0xFFFF;
+    // Orders per account, indexed by AccountId. Filled and cancelled entries
+    // are dropped lazily, when the vector would otherwise grow.
+    std::vector<std::vector<std::shared_ptr<Order>>> byAccount;
+    bool auction = false;
+    mutable typename Policy::Mutex mtx;
+    std::uint64_t version = 0;
+    Seqlock<BookSnapshot> published;
 };
 
+// Instantiated in OrderBook.cpp; add new policies there.
+extern template class BasicOrderBook<DefaultBookPolicy>;
+extern template class BasicOrderBook<LimitShardPolicy>;
+
+using OrderBook = BasicOrderBook<DefaultBookPolicy>;
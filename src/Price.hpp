@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Fixed-point price used everywhere inside the engine: books are keyed on
+// it, events carry it and the C API exchanges it. 1 tick = 1 / PX_SCALE.
+// Doubles are converted once, where they enter or leave (order entry,
+// display, the Python wrapper).
+using PxTicks = std::int64_t;
+constexpr PxTicks PX_SCALE = 10'000;
+
+inline PxTicks toTicks(double px) noexcept { return std::llround(px * PX_SCALE); }
+inline double fromTicks(PxTicks t) noexcept { return static_cast<double>(t) / PX_SCALE; }
+
+// A symbol only trades at multiples of its tick size (in ticks); 1 allows
+// every representable price.
+constexpr bool onTick(PxTicks px, PxTicks tickSize) noexcept {
+    return tickSize <= 1 || px % tickSize == 0;
+}
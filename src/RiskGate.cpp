@@ -0,0 +1,142 @@
+#include "RiskGate.hpp"
+#include <new>
+
+namespace {
+constexpr auto RLX = std::memory_order_relaxed;
+
+// Single-writer update: no read-modify-write needed, readers see either value.
+template <typename T>
+inline void bump(std::atomic<T> &a, T delta) noexcept {
+    a.store(a.load(RLX) + delta, RLX);
+}
+
+inline double notional(PxTicks price, int qty) noexcept { return fromTicks(price) * qty; }
+}
+
+RiskGate::RiskGate(AccountId maxAccounts, SymbolId maxSymbols)
+    : maxAccounts_(maxAccounts),
+      maxSymbols_(maxSymbols),
+      accounts_(std::make_unique<Account[]>(maxAccounts)) {}
+
+RiskGate::~RiskGate() {
+    for (AccountId i = 0; i < maxAccounts_; ++i)
+        delete[] accounts_[i].symbols.load(RLX);
+}
+
+void RiskGate::setLimits(AccountId account, const RiskLimits &l) noexcept {
+    if (account >= maxAccounts_) return;
+    Account &a = accounts_[account];
+    a.maxOrderQty.store(l.maxOrderQty, RLX);
+    a.maxNotional.store(l.maxNotional, RLX);
+    a.maxOpenOrders.store(l.maxOpenOrders, RLX);
+    a.maxPosition.store(l.maxPosition, RLX);
+}
+
+RiskLimits RiskGate::limits(AccountId account) const noexcept {
+    if (account >= maxAccounts_) return {};
+    const Account &a = accounts_[account];
+    return {a.maxOrderQty.load(RLX), a.maxNotional.load(RLX),
+            a.maxOpenOrders.load(RLX), a.maxPosition.load(RLX)};
+}
+
+RiskGate::SymbolExposure *RiskGate::symbolsFor(Account &a) noexcept {
+    auto *s = a.symbols.load(std::memory_order_acquire);
+    if (!s) {
+        s = new (std::nothrow) SymbolExposure[maxSymbols_];
+        a.symbols.store(s, std::memory_order_release);
+    }
+    return s;
+}
+
+const RiskGate::SymbolExposure *RiskGate::symbolsFor(const Account &a) const noexcept {
+    return a.symbols.load(std::memory_order_acquire);
+}
+
+RejectReason RiskGate::checkDelta(const Account &a, SymbolId symbol, OrderSide side,
+                                  int qty, double notionalDelta, int qtyDelta,
+                                  int openOrdersDelta) const noexcept {
+    if (qty > a.maxOrderQty.load(RLX)) return RejectReason::QTY_LIMIT;
+    if (a.openOrders.load(RLX) + openOrdersDelta > a.maxOpenOrders.load(RLX))
+        return RejectReason::OPEN_ORDER_LIMIT;
+    if (a.openNotional.load(RLX) + notionalDelta > a.maxNotional.load(RLX))
+        return RejectReason::NOTIONAL_LIMIT;
+
+    std::int64_t pos = 0, open = 0;
+    if (const auto *s = symbolsFor(a); s && symbol < maxSymbols_) {
+        pos  = s[symbol].position.load(RLX);
+        open = (side == OrderSide::BUY) ? s[symbol].openBuy.load(RLX)
+                                        : s[symbol].openSell.load(RLX);
+    }
+    // worst case: every open order on this side fills
+    std::int64_t worst = (side == OrderSide::BUY) ?  pos + open + qtyDelta
+                                                  : -pos + open + qtyDelta;
+    if (worst > a.maxPosition.load(RLX)) return RejectReason::POSITION_LIMIT;
+    return RejectReason::NONE;
+}
+
+RejectReason RiskGate::check(AccountId account, SymbolId symbol, OrderSide side,
+                             PxTicks price, int qty) const noexcept {
+    if (account >= maxAccounts_) return RejectReason::UNKNOWN_ACCOUNT;
+    return checkDelta(accounts_[account], symbol, side, qty,
+                      notional(price, qty), qty, 1);
+}
+
+RejectReason RiskGate::checkReplace(AccountId account, SymbolId symbol, OrderSide side,
+                                    PxTicks oldPrice, int oldQty,
+                                    PxTicks newPrice, int newQty) const noexcept {
+    if (account >= maxAccounts_) return RejectReason::UNKNOWN_ACCOUNT;
+    return checkDelta(accounts_[account], symbol, side, newQty,
+                      notional(newPrice, newQty) - notional(oldPrice, oldQty),
+                      newQty - oldQty, 0);
+}
+
+void RiskGate::onAccept(AccountId account, SymbolId symbol, OrderSide side,
+                        PxTicks price, int qty) noexcept {
+    if (account >= maxAccounts_) return;
+    Account &a = accounts_[account];
+    bump(a.openOrders, 1);
+    bump(a.openNotional, notional(price, qty));
+    if (auto *s = symbolsFor(a); s && symbol < maxSymbols_)
+        bump(side == OrderSide::BUY ? s[symbol].openBuy : s[symbol].openSell,
+             std::int64_t{qty});
+}
+
+void RiskGate::onFill(AccountId account, SymbolId symbol, OrderSide side,
+                      PxTicks price, int qty, bool done) noexcept {
+    if (account >= maxAccounts_) return;
+    Account &a = accounts_[account];
+    if (done) bump(a.openOrders, -1);
+    bump(a.openNotional, -notional(price, qty));
+    if (auto *s = symbolsFor(a); s && symbol < maxSymbols_) {
+        if (side == OrderSide::BUY) {
+            bump(s[symbol].openBuy,  -std::int64_t{qty});
+            bump(s[symbol].position,  std::int64_t{qty});
+        } else {
+            bump(s[symbol].openSell, -std::int64_t{qty});
+            bump(s[symbol].position, -std::int64_t{qty});
+        }
+    }
+}
+
+void RiskGate::onCancel(AccountId account, SymbolId symbol, OrderSide side,
+                        PxTicks price, int qty) noexcept {
+    if (account >= maxAccounts_) return;
+    Account &a = accounts_[account];
+    bump(a.openOrders, -1);
+    bump(a.openNotional, -notional(price, qty));
+    if (auto *s = symbolsFor(a); s && symbol < maxSymbols_)
+        bump(side == OrderSide::BUY ? s[symbol].openBuy : s[symbol].openSell,
+             -std::int64_t{qty});
+}
+
+Exposure RiskGate::exposure(AccountId account) const noexcept {
+    if (account >= maxAccounts_) return {0.0, 0};
+    const Account &a = accounts_[account];
+    return {a.openNotional.load(RLX), a.openOrders.load(RLX)};
+}
+
+std::int64_t RiskGate::position(AccountId account, SymbolId symbol) const noexcept {
+    if (account >= maxAccounts_ || symbol >= maxSymbols_) return 0;
+    const auto *s = symbolsFor(accounts_[account]);
+    return s ? s[symbol].position.load(RLX) : 0;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include "Order.hpp"
+#include "SymbolTable.hpp"
+
+struct RiskLimits {
+    int          maxOrderQty   = std::numeric_limits<int>::max();
+    double       maxNotional   = std::numeric_limits<double>::max();   // open, at limit prices
+    int          maxOpenOrders = std::numeric_limits<int>::max();
+    std::int64_t maxPosition   = std::numeric_limits<std::int64_t>::max();  // per symbol, absolute
+};
+
+struct Exposure {
+    double       openNotional;
+    int          openOrders;
+};
+
+// Pre-trade limits and exposure counters per account, indexed directly by
+// AccountId and SymbolId. Counters are only written by the matching thread
+// (plain relaxed load/store pairs, no RMW or locks) and can be read from
+// any thread; limits can be changed from any thread at any time.
+//
+// Market orders carry no limit price, so they count towards open orders,
+// quantity and position but not towards open notional.
+class RiskGate {
+public:
+    static constexpr AccountId DEFAULT_ACCOUNTS = 256;
+
+    explicit RiskGate(AccountId maxAccounts = DEFAULT_ACCOUNTS,
+                      SymbolId maxSymbols = SymbolTable::DEFAULT_CAPACITY);
+    ~RiskGate();
+
+    void setLimits(AccountId account, const RiskLimits &limits) noexcept;
+    RiskLimits limits(AccountId account) const noexcept;
+
+    RejectReason check(AccountId account, SymbolId symbol, OrderSide side,
+                       PxTicks price, int qty) const noexcept;
+    // Same as check(), for an order resting with oldQty @ oldPrice being replaced.
+    RejectReason checkReplace(AccountId account, SymbolId symbol, OrderSide side,
+                              PxTicks oldPrice, int oldQty,
+                              PxTicks newPrice, int newQty) const noexcept;
+
+    void onAccept(AccountId account, SymbolId symbol, OrderSide side, PxTicks price, int qty) noexcept;
+    void onFill  (AccountId account, SymbolId symbol, OrderSide side, PxTicks price, int qty,
+                  bool done) noexcept;
+    void onCancel(AccountId account, SymbolId symbol, OrderSide side, PxTicks price, int qty) noexcept;
+
+    Exposure     exposure(AccountId account) const noexcept;
+    std::int64_t position(AccountId account, SymbolId symbol) const noexcept;
+
+    AccountId maxAccounts() const noexcept { return maxAccounts_; }
+
+private:
+    struct SymbolExposure {
+        std::atomic<std::int64_t> position{0};
+        std::atomic<std::int64_t> openBuy{0};
+        std::atomic<std::int64_t> openSell{0};
+    };
+
+    struct alignas(64) Account {
+        std::atomic<int>          maxOrderQty{std::numeric_limits<int>::max()};
+        std::atomic<double>       maxNotional{std::numeric_limits<double>::max()};
+        std::atomic<int>          maxOpenOrders{std::numeric_limits<int>::max()};
+        std::atomic<std::int64_t> maxPosition{std::numeric_limits<std::int64_t>::max()};
+
+        std::atomic<double>       openNotional{0.0};
+        std::atomic<int>          openOrders{0};
+        std::atomic<SymbolExposure*> symbols{nullptr};   // allocated on first accept
+    };
+
+    SymbolExposure *symbolsFor(Account &a) noexcept;
+    const SymbolExposure *symbolsFor(const Account &a) const noexcept;
+    RejectReason checkDelta(const Account &a, SymbolId symbol, OrderSide side,
+                            int qty, double notionalDelta, int qtyDelta,
+                            int openOrdersDelta) const noexcept;
+
+    AccountId maxAccounts_;
+    SymbolId  maxSymbols_;
+    std::unique_ptr<Account[]> accounts_;
+};
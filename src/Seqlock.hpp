@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer seqlock. The writer never waits; readers copy the value and
+// retry if a write overlapped the copy. The payload is stored as relaxed
+// atomic words so a torn read is a retry rather than a data race.
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock payload must be trivially copyable");
+    static_assert(sizeof(T) % sizeof(std::uint64_t) == 0, "Seqlock payload must be a whole number of words");
+    static constexpr std::size_t WORDS = sizeof(T) / sizeof(std::uint64_t);
+
+public:
+    Seqlock() noexcept { store(T{}); }
+
+    // Writers must be serialised by the caller.
+    void store(const T &value) noexcept {
+        std::uint64_t w[WORDS];
+        std::memcpy(w, &value, sizeof(T));
+        std::uint64_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i) data_[i].store(w[i], std::memory_order_relaxed);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    T load() const noexcept {
+        std::uint64_t w[WORDS];
+        std::uint64_t s0, s1;
+        do {
+            s0 = seq_.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < WORDS; ++i) w[i] = data_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            s1 = seq_.load(std::memory_order_relaxed);
+        } while ((s0 & 1) || s0 != s1);
+        T out;
+        std::memcpy(&out, w, sizeof(T));
+        return out;
+    }
+
+private:
+    alignas(64) std::atomic<std::uint64_t> seq_{0};
+    std::atomic<std::uint64_t> data_[WORDS];
+};
@@ -0,0 +1,127 @@
+#include "ShmClient.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+
+#include "ThreadConfig.hpp"
+
+namespace {
+constexpr auto INTERN_TIMEOUT = std::chrono::seconds(1);
+
+constexpr std::uint32_t raw(ShmSlotState s) { return static_cast<std::uint32_t>(s); }
+}
+
+std::unique_ptr<ShmClient> ShmClient::connect(const std::string& name, AccountId account,
+                                              bool cancelOnDisconnect, int timeoutMs)
+{
+    ShmMapping map = ShmMapping::open(name, sizeof(ShmRegion), false);
+    if (!map) return nullptr;
+    auto* r = static_cast<ShmRegion*>(map.data());
+    if (r->magic.load(std::memory_order_acquire) != SHM_MAGIC || r->version != SHM_VERSION)
+        return nullptr;
+
+    for (std::uint32_t i = 0; i < SHM_MAX_CLIENTS; ++i) {
+        ShmClientSlot& c = r->clients[i];
+        std::uint32_t expected = raw(ShmSlotState::FREE);
+        if (!c.state.compare_exchange_strong(expected, shmReservedBy(static_cast<std::int32_t>(getpid())),
+                                             std::memory_order_acquire))
+            continue;
+
+        c.account = account;
+        c.pid = static_cast<std::int32_t>(getpid());
+        c.cancelOnDisconnect = cancelOnDisconnect ? 1 : 0;
+        c.internDone.store(c.internReq.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        c.state.store(raw(ShmSlotState::CLAIMED), std::memory_order_release);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (c.state.load(std::memory_order_acquire) != raw(ShmSlotState::ACTIVE)) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                expected = raw(ShmSlotState::CLAIMED);
+                if (c.state.compare_exchange_strong(expected, raw(ShmSlotState::FREE)))
+                    return nullptr;
+                break;   // the gateway won the race; the slot is ours after all
+            }
+            std::this_thread::yield();
+        }
+        return std::unique_ptr<ShmClient>(new ShmClient(std::move(map), i));
+    }
+    return nullptr;
+}
+
+ShmClient::ShmClient(ShmMapping map, std::uint32_t slot)
+    : map_(std::move(map)), region_(static_cast<ShmRegion*>(map_.data())), slot_(slot),
+      cursor_(region_->events.head())
+{
+    refreshSymbols();
+}
+
+ShmClient::~ShmClient()
+{
+    region_->clients[slot_].state.store(raw(ShmSlotState::CLOSING), std::memory_order_release);
+}
+
+bool ShmClient::connected() const noexcept
+{
+    return region_->magic.load(std::memory_order_acquire) == SHM_MAGIC;
+}
+
+std::uint64_t ShmClient::send(InboundMsg m)
+{
+    const bool echoed = m.type == InboundType::NEW_ORDER || m.type == InboundType::BOOK_SNAPSHOT;
+    if (echoed) m.clientId = shmClientId(slot_, m.clientId ? m.clientId : ++nextClientId_);
+
+    auto& ring = region_->clients[slot_].requests;
+    while (!ring.tryPush(m)) {
+        if (!connected()) return 0;
+        cpuRelax();
+    }
+    return echoed ? m.clientId : 0;
+}
+
+bool ShmClient::next(OutboundMsg& out)
+{
+    for (;;) {
+        std::uint64_t at = cursor_;
+        switch (region_->events.read(cursor_, out)) {
+        case BroadcastRing<OutboundMsg, SHM_EVENT_RING>::Read::OK:     return true;
+        case BroadcastRing<OutboundMsg, SHM_EVENT_RING>::Read::EMPTY:  return false;
+        case BroadcastRing<OutboundMsg, SHM_EVENT_RING>::Read::LAPPED: lost_ += cursor_ - at; break;
+        }
+    }
+}
+
+void ShmClient::refreshSymbols()
+{
+    SymbolId n = region_->symbolCount.load(std::memory_order_acquire);
+    for (; knownSymbols_ < n; ++knownSymbols_)
+        symbolIds_.emplace(region_->symbols[knownSymbols_], knownSymbols_);
+}
+
+SymbolId ShmClient::symbolId(const std::string& symbol)
+{
+    if (symbol.empty() || symbol.size() >= SHM_SYMBOL_LEN) return SymbolTable::NONE;
+    refreshSymbols();
+    if (auto it = symbolIds_.find(symbol); it != symbolIds_.end()) return it->second;
+
+    ShmClientSlot& c = region_->clients[slot_];
+    std::memset(c.internName, 0, sizeof(c.internName));
+    std::memcpy(c.internName, symbol.data(), symbol.size());
+    std::uint32_t req = c.internReq.load(std::memory_order_relaxed) + 1;
+    c.internReq.store(req, std::memory_order_release);
+
+    auto deadline = std::chrono::steady_clock::now() + INTERN_TIMEOUT;
+    while (c.internDone.load(std::memory_order_acquire) != req) {
+        if (!connected() || std::chrono::steady_clock::now() >= deadline) return SymbolTable::NONE;
+        std::this_thread::yield();
+    }
+    refreshSymbols();
+    return c.internId;
+}
+
+const char* ShmClient::symbolName(SymbolId id) const noexcept
+{
+    if (id >= region_->symbolCount.load(std::memory_order_acquire)) return "";
+    return region_->symbols[id];
+}
@@ -0,0 +1,159 @@
+#include "ShmGateway.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <signal.h>
+#include <unistd.h>
+
+namespace {
+constexpr int  REQUEST_BATCH = 64;           // per slot per pass, keeps slots fair
+constexpr auto LIVENESS_PERIOD = std::chrono::milliseconds(100);
+constexpr auto IDLE_NAP = std::chrono::microseconds(20);
+
+bool processGone(std::int32_t pid)
+{
+    return pid > 0 && kill(pid, 0) != 0 && errno == ESRCH;
+}
+}
+
+std::unique_ptr<ShmGateway> ShmGateway::open(EngineRunner& runner, const std::string& name,
+                                             const ThreadConfig& cfg)
+{
+    ShmMapping map = ShmMapping::open(name, sizeof(ShmRegion), true);
+    if (!map) return nullptr;
+    return std::unique_ptr<ShmGateway>(new ShmGateway(runner, std::move(map), cfg));
+}
+
+ShmGateway::ShmGateway(EngineRunner& runner, ShmMapping map, const ThreadConfig& cfg)
+    : runner_(runner), map_(std::move(map)),
+      region_(new (map_.data()) ShmRegion()), busyPoll_(cfg.busyPoll)
+{
+    region_->serverPid = static_cast<std::int32_t>(getpid());
+    mirrorSymbols();
+    region_->magic.store(SHM_MAGIC, std::memory_order_release);
+    thread_ = std::thread([this, cfg]{
+        applyThreadConfig(cfg);
+        loop();
+    });
+}
+
+ShmGateway::~ShmGateway()
+{
+    running_.store(false);
+    if (thread_.joinable()) thread_.join();
+    region_->magic.store(0, std::memory_order_release);   // clients see the engine go away
+}
+
+std::uint32_t ShmGateway::clients() const noexcept
+{
+    std::uint32_t n = 0;
+    for (const auto& c : region_->clients)
+        n += c.state.load(std::memory_order_acquire) == static_cast<std::uint32_t>(ShmSlotState::ACTIVE);
+    return n;
+}
+
+void ShmGateway::loop()
+{
+    auto lastCheck = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_relaxed)) {
+        bool busy = false;
+
+        auto now = std::chrono::steady_clock::now();
+        bool checkLiveness = now - lastCheck >= LIVENESS_PERIOD;
+        if (checkLiveness) lastCheck = now;
+
+        for (std::uint32_t i = 0; i < SHM_MAX_CLIENTS; ++i) busy |= serviceSlot(i, checkLiveness);
+
+        OutboundMsg ev;
+        while (runner_.poll(ev)) {
+            region_->events.publish(ev);
+            busy = true;
+        }
+        mirrorSymbols();
+
+        if (busy) continue;
+        if (busyPoll_) cpuRelax();
+        else std::this_thread::sleep_for(IDLE_NAP);
+    }
+}
+
+bool ShmGateway::serviceSlot(std::uint32_t i, bool checkLiveness)
+{
+    ShmClientSlot& c = region_->clients[i];
+    std::uint32_t word = c.state.load(std::memory_order_acquire);
+    auto st = static_cast<ShmSlotState>(word & SHM_STATE_MASK);
+
+    switch (st) {
+    case ShmSlotState::FREE:
+        return false;
+    case ShmSlotState::RESERVED:
+        // the client died before it could claim the slot
+        if (!checkLiveness || !processGone(static_cast<std::int32_t>(word >> 8))) return false;
+        return c.state.compare_exchange_strong(word, static_cast<std::uint32_t>(ShmSlotState::FREE),
+                                               std::memory_order_acq_rel);
+    case ShmSlotState::CLAIMED: {
+        sessions_[i] = runner_.openSession(c.account, c.cancelOnDisconnect != 0);
+        // the client may have given up waiting and released the slot meanwhile
+        auto expected = static_cast<std::uint32_t>(ShmSlotState::CLAIMED);
+        if (!c.state.compare_exchange_strong(expected, static_cast<std::uint32_t>(ShmSlotState::ACTIVE),
+                                             std::memory_order_acq_rel))
+            runner_.closeSession(sessions_[i]);
+        return true;
+    }
+    case ShmSlotState::ACTIVE:
+    case ShmSlotState::CLOSING:
+        break;
+    }
+
+    // what the session has no credit for stays in the ring and paces the client
+    InboundMsg batch[REQUEST_BATCH];
+    const int credit = static_cast<int>(std::min<std::size_t>(REQUEST_BATCH, runner_.credits(sessions_[i])));
+    int n = 0, popped = 0;
+    for (; popped < credit && c.requests.tryPop(batch[n]); ++popped) {
+        InboundMsg& m = batch[n];
+        // auctions are run by the venue, not by its clients; unknown types are dropped too
+        if (m.type > InboundType::BOOK_SNAPSHOT || m.type == InboundType::AUCTION_START ||
+            m.type == InboundType::AUCTION_UNCROSS) continue;
+        // a client trades only for the account it connected with, and only its own orders
+        m.account = c.account;
+        if (m.type == InboundType::CANCEL || m.type == InboundType::MODIFY) m.flags |= IN_OWNER;
+        if (m.type == InboundType::NEW_ORDER || m.type == InboundType::BOOK_SNAPSHOT)
+            m.clientId = shmClientId(i, m.clientId);
+        ++n;
+    }
+    runner_.push(batch, static_cast<std::size_t>(n), sessions_[i]);
+    bool busy = popped > 0;
+
+    std::uint32_t req = c.internReq.load(std::memory_order_acquire);
+    if (req != c.internDone.load(std::memory_order_relaxed)) {
+        char name[SHM_SYMBOL_LEN];
+        std::memcpy(name, c.internName, sizeof(name));
+        name[SHM_SYMBOL_LEN - 1] = '\0';
+        c.internId = runner_.engine().symbols().intern(name);
+        mirrorSymbols();
+        c.internDone.store(req, std::memory_order_release);
+        busy = true;
+    }
+
+    if (st == ShmSlotState::ACTIVE && checkLiveness && processGone(c.pid)) st = ShmSlotState::CLOSING;
+    if (st == ShmSlotState::CLOSING && c.requests.empty()) {
+        runner_.closeSession(sessions_[i]);
+        c.state.store(static_cast<std::uint32_t>(ShmSlotState::FREE), std::memory_order_release);
+        busy = true;
+    }
+    return busy;
+}
+
+void ShmGateway::mirrorSymbols()
+{
+    const SymbolTable& syms = runner_.engine().symbols();
+    SymbolId n   = std::min<SymbolId>(syms.size(), SymbolTable::DEFAULT_CAPACITY);
+    SymbolId cur = region_->symbolCount.load(std::memory_order_relaxed);
+    if (cur >= n) return;
+    for (; cur < n; ++cur)
+        std::strncpy(region_->symbols[cur], syms.name(cur).c_str(), SHM_SYMBOL_LEN - 1);
+    region_->symbolCount.store(n, std::memory_order_release);
+}
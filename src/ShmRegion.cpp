@@ -0,0 +1,63 @@
+#include "ShmRegion.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+static std::string shmPath(const std::string &name)
+{
+    return (!name.empty() && name[0] == '/') ? name : "/" + name;
+}
+
+ShmMapping ShmMapping::open(const std::string &name, std::size_t size, bool create)
+{
+    ShmMapping m;
+    const std::string path = shmPath(name);
+    if (create) shm_unlink(path.c_str());      // a stale segment from a crashed engine
+
+    int fd = shm_open(path.c_str(), create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR, 0600);
+    if (fd < 0) return m;
+
+    struct stat st{};
+    bool ok = create ? ftruncate(fd, static_cast<off_t>(size)) == 0
+                     : fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= size;
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;                     // no page faults on the hot path
+#endif
+    void *p = ok ? mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (p == MAP_FAILED) {
+        if (create) shm_unlink(path.c_str());
+        return m;
+    }
+    m.name_  = path;
+    m.addr_  = p;
+    m.size_  = size;
+    m.owner_ = create;
+    return m;
+}
+
+ShmMapping::~ShmMapping()
+{
+    if (!addr_) return;
+    munmap(addr_, size_);
+    if (owner_) shm_unlink(name_.c_str());
+}
+
+ShmMapping::ShmMapping(ShmMapping &&o) noexcept
+    : name_(std::move(o.name_)), addr_(std::exchange(o.addr_, nullptr)),
+      size_(o.size_), owner_(o.owner_) {}
+
+ShmMapping &ShmMapping::operator=(ShmMapping &&o) noexcept
+{
+    ShmMapping tmp(std::move(o));
+    std::swap(name_,  tmp.name_);
+    std::swap(addr_,  tmp.addr_);
+    std::swap(size_,  tmp.size_);
+    std::swap(owner_, tmp.owner_);
+    return *this;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Bounded single-producer / single-consumer ring. All state lives inline, so
+// a ring can be placed in memory shared between processes. Each side keeps a
+// cached copy of the other side's index and only reloads it when the ring
+// looks full (producer) or empty (consumer).
+template <typename T, std::size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing payload must be trivially copyable");
+    static constexpr std::uint64_t MASK = N - 1;
+
+public:
+    static constexpr std::size_t CAPACITY = N;
+
+    // producer side
+    bool tryPush(const T &value) noexcept {
+        std::uint64_t t = tail_.load(std::memory_order_relaxed);
+        if (t - headCache_ == N) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (t - headCache_ == N) return false;
+        }
+        buf_[t & MASK] = value;
+        tail_.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side
+    bool tryPop(T &out) noexcept {
+        std::uint64_t h = head_.load(std::memory_order_relaxed);
+        if (h == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (h == tailCache_) return false;
+        }
+        out = buf_[h & MASK];
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+    // exact on either side for its own end, a lower bound for the other's
+    std::size_t size() const noexcept {
+        const std::uint64_t h = head_.load(std::memory_order_acquire);
+        return static_cast<std::size_t>(tail_.load(std::memory_order_acquire) - h);
+    }
+
+private:
+    alignas(64) std::atomic<std::uint64_t> tail_{0};
+    std::uint64_t headCache_ = 0;                     // producer's view of head_
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+    std::uint64_t tailCache_ = 0;                     // consumer's view of tail_
+    alignas(64) T buf_[N]{};
+};
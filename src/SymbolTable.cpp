@@ -0,0 +1,41 @@
+#include "SymbolTable.hpp"
+
+SymbolTable::SymbolTable(SymbolId capacity)
+    : capacity_(capacity < 2 ? 2 : capacity),
+      names_(std::make_unique<std::string[]>(capacity_)),
+      tickSizes_(std::make_unique<std::atomic<PxTicks>[]>(capacity_)) {
+    for (SymbolId i = 0; i < capacity_; ++i) tickSizes_[i].store(1, std::memory_order_relaxed);
+}
+
+SymbolId SymbolTable::intern(const std::string &symbol) {
+    if (symbol.empty()) return NONE;
+
+    std::lock_guard lock(mtx_);
+    auto it = ids_.find(symbol);
+    if (it != ids_.end()) return it->second;
+
+    SymbolId id = count_.load(std::memory_order_relaxed);
+    if (id >= capacity_) return NONE;
+
+    names_[id] = symbol;
+    ids_.emplace(symbol, id);
+    count_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+SymbolId SymbolTable::find(const std::string &symbol) const {
+    std::lock_guard lock(mtx_);
+    auto it = ids_.find(symbol);
+    return (it == ids_.end()) ? NONE : it->second;
+}
+
+const std::string &SymbolTable::name(SymbolId id) const noexcept {
+    if (id >= count_.load(std::memory_order_acquire)) return names_[NONE];
+    return names_[id];
+}
+
+bool SymbolTable::setTickSize(SymbolId id, PxTicks tickSize) noexcept {
+    if (id == NONE || id >= count_.load(std::memory_order_acquire) || tickSize <= 0) return false;
+    tickSizes_[id].store(tickSize, std::memory_order_relaxed);
+    return true;
+}
@@ -0,0 +1,323 @@
+#include "Tape.hpp"
+#include "SymbolTable.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+
+// research/py/tcx/tape.py reads these layouts too
+static_assert(offsetof(TapeMeta, trades) == 32 && offsetof(TapeMeta, names) == 48);
+static_assert(sizeof(TapeBlock) == 16 && std::atomic<std::uint64_t>::is_always_lock_free);
+
+namespace {
+constexpr std::int64_t DAY_NS = 86'400'000'000'000;
+
+const char *const TRADE_COLS[]   = {"ts", "sym", "px", "qty", "buy", "sell"};
+const std::size_t TRADE_WIDTHS[] = {8, 4, 8, 4, 8, 8};
+const char *const QUOTE_COLS[]   = {"ts", "sym", "bid", "ask", "bidqty", "askqty"};
+const std::size_t QUOTE_WIDTHS[] = {8, 4, 8, 8, 4, 4};
+
+template <typename T> T *col(const TapeFile &f) { return static_cast<T *>(f.data()); }
+
+std::string dayName(std::int64_t dayStartNs)
+{
+    const std::time_t t = static_cast<std::time_t>(dayStartNs / 1'000'000'000);
+    std::tm tm{};
+    gmtime_r(&t, &tm);
+    char buf[16];
+    std::strftime(buf, sizeof(buf), "%Y%m%d", &tm);
+    return buf;
+}
+
+std::size_t indexBytes(std::uint64_t rows)
+{
+    return (rows + TAPE_BLOCK - 1) / TAPE_BLOCK * sizeof(TapeBlock);
+}
+
+// First row in [0, n) with ts >= t; the index narrows it to one block.
+std::size_t lowerBound(const TapeFile &idx, const std::int64_t *ts, std::size_t n, std::int64_t t)
+{
+    const auto *blocks = col<const TapeBlock>(idx);
+    const std::size_t nb = (n + TAPE_BLOCK - 1) / TAPE_BLOCK;
+    const std::size_t k = std::partition_point(blocks, blocks + nb,
+                              [t](const TapeBlock &b){ return b.firstTs < t; }) - blocks;
+    const std::size_t lo = k ? (k - 1) * TAPE_BLOCK : 0;
+    const std::size_t hi = std::min<std::size_t>(k * TAPE_BLOCK, n);
+    return std::lower_bound(ts + lo, ts + hi, t) - ts;
+}
+}
+
+// ────────── TapeFile ─────────────────────────────────────────────────────
+TapeFile TapeFile::open(const std::string &path, bool writable, std::size_t minSize)
+{
+    TapeFile f;
+    f.fd_ = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (f.fd_ < 0) return f;
+    f.writable_ = writable;
+
+    struct stat st{};
+    if (fstat(f.fd_, &st) != 0) return f;
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    if (writable && size < minSize) {
+        if (ftruncate(f.fd_, static_cast<off_t>(minSize)) != 0) return f;
+        size = minSize;
+    }
+    if (size == 0) return f;
+    void *p = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, f.fd_, 0);
+    if (p == MAP_FAILED) return f;
+    f.addr_ = p;
+    f.size_ = size;
+    return f;
+}
+
+bool TapeFile::grow(std::size_t size)
+{
+    if (!writable_ || fd_ < 0) return false;
+    if (size <= size_) return true;
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) return false;
+    void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) return false;
+    if (addr_) munmap(addr_, size_);
+    addr_ = p;
+    size_ = size;
+    return true;
+}
+
+TapeFile::~TapeFile()
+{
+    if (addr_) munmap(addr_, size_);
+    if (fd_ >= 0) ::close(fd_);
+}
+
+TapeFile::TapeFile(TapeFile &&o) noexcept
+    : fd_(std::exchange(o.fd_, -1)), addr_(std::exchange(o.addr_, nullptr)),
+      size_(std::exchange(o.size_, 0)), writable_(o.writable_) {}
+
+TapeFile &TapeFile::operator=(TapeFile &&o) noexcept
+{
+    TapeFile tmp(std::move(o));
+    std::swap(fd_,       tmp.fd_);
+    std::swap(addr_,     tmp.addr_);
+    std::swap(size_,     tmp.size_);
+    std::swap(writable_, tmp.writable_);
+    return *this;
+}
+
+// ────────── TapeWriter ───────────────────────────────────────────────────
+TapeWriter::TapeWriter(std::string root, const SymbolTable &symbols)
+    : root_(std::move(root)), symbols_(symbols), lastQuote_(TAPE_SYMBOLS) {}
+
+std::unique_ptr<TapeWriter> TapeWriter::open(const std::string &root, const SymbolTable &symbols)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(root, ec);
+    if (ec || !std::filesystem::is_directory(root)) return nullptr;
+    return std::unique_ptr<TapeWriter>(new TapeWriter(root, symbols));
+}
+
+bool TapeWriter::openDay(std::int64_t ts) noexcept
+{
+    const std::int64_t start = ts - ts % DAY_NS;
+    try {
+        dir_ = root_ + "/" + dayName(start);
+        std::error_code ec;
+        std::filesystem::create_directories(dir_, ec);
+        if (ec) return false;
+
+        meta_ = TapeFile::open(dir_ + "/meta", true, sizeof(TapeMeta));
+        if (!meta_) return false;
+        auto *m = col<TapeMeta>(meta_);
+        if (m->magic == 0) {
+            m->version    = TAPE_VERSION;
+            m->symbols    = TAPE_SYMBOLS;
+            m->pxScale    = PX_SCALE;
+            m->dayStartNs = start;
+            m->magic      = TAPE_MAGIC;
+        }
+        else if (m->magic != TAPE_MAGIC || m->version != TAPE_VERSION) return false;
+
+        // reopening a day appends after the rows already there
+        if (!openTable(trades_, "trades", TRADE_COLS, TRADE_WIDTHS, m->trades.load(std::memory_order_relaxed)) ||
+            !openTable(quotes_, "quotes", QUOTE_COLS, QUOTE_WIDTHS, m->quotes.load(std::memory_order_relaxed)))
+            return false;
+    }
+    catch (...) { return false; }
+
+    std::fill(lastQuote_.begin(), lastQuote_.end(), Quote{});
+    dayEndNs_ = start + DAY_NS;
+    return true;
+}
+
+template <std::size_t N>
+bool TapeWriter::openTable(Table<N> &t, const char *name, const char *const *cols,
+                           const std::size_t *widths, std::uint64_t count) noexcept
+{
+    t.rows = INITIAL_ROWS;
+    while (t.rows <= count) t.rows *= 2;
+    try {
+        const std::string base = dir_ + "/" + name + ".";
+        for (std::size_t c = 0; c < N; ++c) {
+            t.cols[c] = TapeFile::open(base + cols[c], true, t.rows * widths[c]);
+            if (!t.cols[c]) return false;
+        }
+        t.idx = TapeFile::open(base + "idx", true, indexBytes(t.rows));
+        if (!t.idx) return false;
+    }
+    catch (...) { return false; }
+    t.lastTs = count ? col<std::int64_t>(t.cols[0])[count - 1] : 0;
+    return true;
+}
+
+template <std::size_t N>
+bool TapeWriter::reserve(Table<N> &t, const std::size_t *widths, std::uint64_t row) noexcept
+{
+    if (row < t.rows) return true;
+    const std::uint64_t rows = t.rows * 2;
+    for (std::size_t c = 0; c < N; ++c)
+        if (!t.cols[c].grow(rows * widths[c])) return ok_ = false;
+    if (!t.idx.grow(indexBytes(rows))) return ok_ = false;
+    t.rows = rows;
+    return true;
+}
+
+template <std::size_t N>
+std::int64_t TapeWriter::begin(Table<N> &t, std::int64_t ts, SymbolId sym, std::uint64_t row) noexcept
+{
+    ts = std::max(ts, t.lastTs);
+    t.lastTs = ts;
+    TapeBlock &b = col<TapeBlock>(t.idx)[row / TAPE_BLOCK];
+    const std::uint64_t bit = 1ULL << (sym % 64);
+    if (row % TAPE_BLOCK == 0) {
+        b.firstTs = ts;
+        b.symbols.store(bit, std::memory_order_relaxed);
+    }
+    else b.symbols.store(b.symbols.load(std::memory_order_relaxed) | bit, std::memory_order_relaxed);
+    name(sym);
+    return ts;
+}
+
+void TapeWriter::name(SymbolId sym) noexcept
+{
+    if (sym >= TAPE_SYMBOLS) return;
+    char *slot = col<TapeMeta>(meta_)->names[sym];
+    if (slot[0]) return;
+    const std::string &n = symbols_.name(sym);
+    std::memcpy(slot, n.data(), std::min(n.size(), TAPE_SYMBOL_LEN - 1));
+}
+
+void TapeWriter::trade(std::int64_t ts, SymbolId sym, PxTicks px, int qty,
+                       OrderId buyId, OrderId sellId) noexcept
+{
+    if (!ok_) return;
+    if (ts >= dayEndNs_ && !openDay(ts)) { ok_ = false; return; }
+    auto *m = col<TapeMeta>(meta_);
+    const std::uint64_t row = m->trades.load(std::memory_order_relaxed);
+    if (!reserve(trades_, TRADE_WIDTHS, row)) return;
+
+    const auto &c = trades_.cols;
+    col<std::int64_t>(c[0])[row]  = begin(trades_, ts, sym, row);
+    col<std::uint32_t>(c[1])[row] = sym;
+    col<std::int64_t>(c[2])[row]  = px;
+    col<std::int32_t>(c[3])[row]  = qty;
+    col<std::int64_t>(c[4])[row]  = buyId;
+    col<std::int64_t>(c[5])[row]  = sellId;
+    m->trades.store(row + 1, std::memory_order_release);
+}
+
+void TapeWriter::quote(std::int64_t ts, SymbolId sym, PxTicks bidPx, PxTicks askPx,
+                       int bidQty, int askQty) noexcept
+{
+    if (!ok_) return;
+    if (ts >= dayEndNs_ && !openDay(ts)) { ok_ = false; return; }
+    if (sym < TAPE_SYMBOLS) {                   // only changes are recorded
+        const Quote q{bidPx, askPx, bidQty, askQty};
+        if (lastQuote_[sym] == q) return;
+        lastQuote_[sym] = q;
+    }
+
+    auto *m = col<TapeMeta>(meta_);
+    const std::uint64_t row = m->quotes.load(std::memory_order_relaxed);
+    if (!reserve(quotes_, QUOTE_WIDTHS, row)) return;
+
+    const auto &c = quotes_.cols;
+    col<std::int64_t>(c[0])[row]  = begin(quotes_, ts, sym, row);
+    col<std::uint32_t>(c[1])[row] = sym;
+    col<std::int64_t>(c[2])[row]  = bidPx;
+    col<std::int64_t>(c[3])[row]  = askPx;
+    col<std::int32_t>(c[4])[row]  = bidQty;
+    col<std::int32_t>(c[5])[row]  = askQty;
+    m->quotes.store(row + 1, std::memory_order_release);
+}
+
+// ────────── TapeReader ───────────────────────────────────────────────────
+bool TapeReader::open(const std::string &dayDir)
+{
+    dir_ = dayDir;
+    return refresh();
+}
+
+bool TapeReader::refresh()
+{
+    meta_ = TapeFile::open(dir_ + "/meta", false);
+    if (!meta_ || meta_.size() < sizeof(TapeMeta)) return false;
+    const TapeMeta &m = meta();
+    if (m.magic != TAPE_MAGIC || m.version != TAPE_VERSION) return false;
+
+    // counts first: the files are always grown before rows are counted
+    const std::uint64_t nt = m.trades.load(std::memory_order_acquire);
+    const std::uint64_t nq = m.quotes.load(std::memory_order_acquire);
+
+    auto load = [this](const char *table, const char *const *cols, const std::size_t *widths,
+                       TapeFile *files, TapeFile &idx, std::uint64_t n) {
+        const std::string base = dir_ + "/" + table + ".";
+        for (std::size_t c = 0; c < 6; ++c) {
+            files[c] = TapeFile::open(base + cols[c], false);
+            if (!files[c] || files[c].size() < n * widths[c]) return false;
+        }
+        idx = TapeFile::open(base + "idx", false);
+        return idx && idx.size() >= indexBytes(n);
+    };
+    if (!load("trades", TRADE_COLS, TRADE_WIDTHS, tradeCols_, tradeIdx_, nt) ||
+        !load("quotes", QUOTE_COLS, QUOTE_WIDTHS, quoteCols_, quoteIdx_, nq))
+        return false;
+
+    const auto &t = tradeCols_;
+    trades_ = {col<const std::int64_t>(t[0]), col<const std::uint32_t>(t[1]),
+               col<const PxTicks>(t[2]), col<const std::int32_t>(t[3]),
+               col<const OrderId>(t[4]), col<const OrderId>(t[5]), nt};
+    const auto &q = quoteCols_;
+    quotes_ = {col<const std::int64_t>(q[0]), col<const std::uint32_t>(q[1]),
+               col<const PxTicks>(q[2]), col<const PxTicks>(q[3]),
+               col<const std::int32_t>(q[4]), col<const std::int32_t>(q[5]), nq};
+    return true;
+}
+
+SymbolId TapeReader::symbol(const std::string &name) const noexcept
+{
+    if (name.empty() || name.size() >= TAPE_SYMBOL_LEN) return SymbolTable::NONE;
+    const TapeMeta &m = meta();
+    for (std::uint32_t i = 1; i < m.symbols && i < TAPE_SYMBOLS; ++i)
+        if (!std::strncmp(m.names[i], name.c_str(), TAPE_SYMBOL_LEN)) return i;
+    return SymbolTable::NONE;
+}
+
+std::pair<std::size_t, std::size_t> TapeReader::tradeRange(std::int64_t from, std::int64_t to) const noexcept
+{
+    if (to <= from) return {0, 0};
+    return {lowerBound(tradeIdx_, trades_.ts, trades_.n, from),
+            lowerBound(tradeIdx_, trades_.ts, trades_.n, to)};
+}
+
+std::pair<std::size_t, std::size_t> TapeReader::quoteRange(std::int64_t from, std::int64_t to) const noexcept
+{
+    if (to <= from) return {0, 0};
+    return {lowerBound(quoteIdx_, quotes_.ts, quotes_.n, from),
+            lowerBound(quoteIdx_, quotes_.ts, quotes_.n, to)};
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Messages.hpp"
+
+// Trade and quote tape, one directory per UTC day under a root:
+//
+//   <root>/<YYYYMMDD>/meta            TapeMeta
+//   <root>/<YYYYMMDD>/trades.<col>    ts sym px qty buy sell
+//   <root>/<YYYYMMDD>/quotes.<col>    ts sym bid ask bidqty askqty
+//   <root>/<YYYYMMDD>/trades.idx      TapeBlock per TAPE_BLOCK rows
+//   <root>/<YYYYMMDD>/quotes.idx
+//
+// Every column is a flat native-endian array (ts, px, ids: int64; sym:
+// uint32; qty: int32) whose row order is timestamp order, so a reader can
+// mmap it and binary-search ts. Files are grown in steps and may be longer
+// than the data; a row exists once the table's count in meta covers it.
+// Prices are fixed-point ticks, see meta.pxScale.
+constexpr std::uint64_t TAPE_MAGIC      = 0x3145504154584354ULL;   // "TCXTAPE1"
+constexpr std::uint32_t TAPE_VERSION    = 1;
+constexpr std::uint32_t TAPE_SYMBOLS    = 4096;   // ids at or above have no name
+constexpr std::size_t   TAPE_SYMBOL_LEN = 32;
+constexpr std::uint64_t TAPE_BLOCK      = 4096;   // rows per index entry
+
+struct TapeMeta {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t symbols;                  // entries in names
+    std::int64_t  pxScale;
+    std::int64_t  dayStartNs;
+    std::atomic<std::uint64_t> trades;      // rows written
+    std::atomic<std::uint64_t> quotes;
+    char          names[TAPE_SYMBOLS][TAPE_SYMBOL_LEN];
+};
+
+// Index entry of rows [k * TAPE_BLOCK, (k + 1) * TAPE_BLOCK): the first
+// row's ts and bit (sym % 64) set for every symbol in the block, so symbol
+// scans skip blocks that cannot contain it.
+struct TapeBlock {
+    std::int64_t firstTs;
+    std::atomic<std::uint64_t> symbols;
+};
+
+// A regular file mapped whole; grow() extends it and maps it again.
+class TapeFile {
+public:
+    TapeFile() = default;
+    ~TapeFile();
+    TapeFile(TapeFile &&o) noexcept;
+    TapeFile &operator=(TapeFile &&o) noexcept;
+    TapeFile(const TapeFile &) = delete;
+    TapeFile &operator=(const TapeFile &) = delete;
+
+    // writable files are created if missing and grown to at least minSize;
+    // read-only ones are mapped at their current size.
+    static TapeFile open(const std::string &path, bool writable, std::size_t minSize = 0);
+    bool grow(std::size_t size);
+
+    void *data() const noexcept { return addr_; }
+    std::size_t size() const noexcept { return size_; }
+    explicit operator bool() const noexcept { return addr_ != nullptr; }
+
+private:
+    int fd_ = -1;
+    void *addr_ = nullptr;
+    std::size_t size_ = 0;
+    bool writable_ = false;
+};
+
+class SymbolTable;
+
+// Appends from the matching thread: each row is a handful of stores into
+// mapped memory, with an ftruncate + remap every time a table doubles.
+// Timestamps are clamped so each table stays in order, and a row whose day
+// is past the current one starts the next day's directory.
+class TapeWriter {
+public:
+    static constexpr std::uint64_t INITIAL_ROWS = 1 << 16;
+
+    // Returns null if the root cannot be created. The symbol table names
+    // symbols as they first appear.
+    static std::unique_ptr<TapeWriter> open(const std::string &root, const SymbolTable &symbols);
+
+    void trade(std::int64_t tsNs, SymbolId sym, PxTicks px, int qty, OrderId buyId, OrderId sellId) noexcept;
+    void quote(std::int64_t tsNs, SymbolId sym, PxTicks bidPx, PxTicks askPx,
+               int bidQty, int askQty) noexcept;
+
+    // Unchanged quotes of a symbol are not recorded again.
+    // False once a file could not be opened or grown; later rows are dropped.
+    bool ok() const noexcept { return ok_; }
+    std::string dayDir() const { return dir_; }
+
+private:
+    template <std::size_t N> struct Table {
+        TapeFile cols[N];
+        TapeFile idx;
+        std::uint64_t rows = 0;         // capacity of every column
+        std::int64_t lastTs = 0;
+    };
+    struct Quote {
+        PxTicks bidPx, askPx;
+        int bidQty, askQty;
+        bool operator==(const Quote &o) const noexcept {
+            return bidPx == o.bidPx && askPx == o.askPx && bidQty == o.bidQty && askQty == o.askQty;
+        }
+    };
+
+    TapeWriter(std::string root, const SymbolTable &symbols);
+    bool openDay(std::int64_t tsNs) noexcept;
+    template <std::size_t N>
+    bool openTable(Table<N> &t, const char *name, const char *const *cols,
+                   const std::size_t *widths, std::uint64_t count) noexcept;
+    template <std::size_t N>
+    bool reserve(Table<N> &t, const std::size_t *widths, std::uint64_t row) noexcept;
+    template <std::size_t N>
+    std::int64_t begin(Table<N> &t, std::int64_t tsNs, SymbolId sym, std::uint64_t row) noexcept;
+    void name(SymbolId sym) noexcept;
+
+    std::string root_;
+    std::string dir_;
+    const SymbolTable &symbols_;
+    std::int64_t dayEndNs_ = 0;         // 0: no day open
+    bool ok_ = true;
+    TapeFile meta_;
+    Table<6> trades_;
+    Table<6> quotes_;
+    std::vector<Quote> lastQuote_;      // per SymbolId, reset each day
+};
+
+// Read-only view of one day's directory, usable while a writer appends to
+// it; refresh() picks up the rows written since.
+class TapeReader {
+public:
+    struct Trades {
+        const std::int64_t *ts; const std::uint32_t *sym; const PxTicks *px;
+        const std::int32_t *qty; const OrderId *buyId; const OrderId *sellId;
+        std::size_t n;
+    };
+    struct Quotes {
+        const std::int64_t *ts; const std::uint32_t *sym; const PxTicks *bidPx;
+        const PxTicks *askPx; const std::int32_t *bidQty; const std::int32_t *askQty;
+        std::size_t n;
+    };
+
+    bool open(const std::string &dayDir);
+    bool refresh();
+
+    const TapeMeta &meta() const noexcept { return *static_cast<const TapeMeta *>(meta_.data()); }
+    const Trades &trades() const noexcept { return trades_; }
+    const Quotes &quotes() const noexcept { return quotes_; }
+    // SymbolTable::NONE if the day never saw the symbol.
+    SymbolId symbol(const std::string &name) const noexcept;
+
+    // Rows [first, second) with from <= ts < to.
+    std::pair<std::size_t, std::size_t> tradeRange(std::int64_t from, std::int64_t to) const noexcept;
+    std::pair<std::size_t, std::size_t> quoteRange(std::int64_t from, std::int64_t to) const noexcept;
+
+    // Calls fn(row) for the symbol's rows in [from, to), skipping index
+    // blocks the symbol does not appear in.
+    template <typename Fn>
+    void forEachTrade(SymbolId sym, std::int64_t from, std::int64_t to, Fn &&fn) const {
+        scan(tradeIdx_, trades_.sym, tradeRange(from, to), sym, fn);
+    }
+    template <typename Fn>
+    void forEachQuote(SymbolId sym, std::int64_t from, std::int64_t to, Fn &&fn) const {
+        scan(quoteIdx_, quotes_.sym, quoteRange(from, to), sym, fn);
+    }
+
+private:
+    template <typename Fn>
+    static void scan(const TapeFile &idx, const std::uint32_t *syms,
+                     std::pair<std::size_t, std::size_t> rows, SymbolId sym, Fn &fn) {
+        const auto *blocks = static_cast<const TapeBlock *>(idx.data());
+        const std::uint64_t bit = 1ULL << (sym % 64);
+        for (std::size_t r = rows.first; r < rows.second;) {
+            const std::size_t end = std::min<std::size_t>(rows.second, (r / TAPE_BLOCK + 1) * TAPE_BLOCK);
+            if (blocks[r / TAPE_BLOCK].symbols.load(std::memory_order_relaxed) & bit)
+                for (; r < end; ++r) if (syms[r] == sym) fn(r);
+            r = end;
+        }
+    }
+
+    std::string dir_;
+    TapeFile meta_;
+    TapeFile tradeCols_[6], quoteCols_[6];
+    TapeFile tradeIdx_, quoteIdx_;
+    Trades trades_{};
+    Quotes quotes_{};
+};
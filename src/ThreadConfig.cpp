@@ -0,0 +1,71 @@
+#include "ThreadConfig.hpp"
+
+#include <sys/mman.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+#ifdef __linux__
+namespace {
+bool pin(const std::vector<int>& cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool fifo(int priority)
+{
+    sched_param sp{};
+    sp.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) == 0;
+}
+
+// set_mempolicy(2) directly, so the core library needs no libnuma.
+bool preferNode(int node)
+{
+    constexpr int BITS = 8 * sizeof(unsigned long);
+    unsigned long mask[1024 / BITS] = {};
+    if (node >= 1024) return false;
+    mask[node / BITS] = 1UL << (node % BITS);
+    return syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, 1024UL + 1) == 0;
+}
+}
+
+bool applyThreadConfig(const ThreadConfig& cfg) noexcept
+{
+    bool ok = true;
+    if (!cfg.cpus.empty())   ok &= pin(cfg.cpus);
+    if (cfg.numaNode >= 0)   ok &= preferNode(cfg.numaNode);
+    if (cfg.fifoPriority > 0) ok &= fifo(cfg.fifoPriority);
+    return ok;
+}
+#else
+// No affinity or memory-policy API we rely on elsewhere; scheduling is left
+// to the OS.
+bool applyThreadConfig(const ThreadConfig& cfg) noexcept
+{
+    return cfg.cpus.empty() && cfg.numaNode < 0 && cfg.fifoPriority <= 0;
+}
+#endif
+
+bool lockProcessMemory() noexcept
+{
+    return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+}
+
+void prefaultStack(std::size_t bytes) noexcept
+{
+    constexpr std::size_t CHUNK = 16 * 1024;
+    volatile char chunk[CHUNK];
+    for (std::size_t i = 0; i < CHUNK; i += 4096) chunk[i] = 0;
+    if (bytes > CHUNK) prefaultStack(bytes - CHUNK);
+    static_cast<void>(chunk[0]);    // keeps the frame live: no tail call
+}
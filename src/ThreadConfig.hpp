@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Placement and scheduling of one engine thread. The defaults leave the
+// thread as the OS started it.
+struct ThreadConfig {
+    std::vector<int> cpus;      // pin to these CPUs; empty = any
+    int  fifoPriority = 0;      // > 0: SCHED_FIFO at this priority
+    int  numaNode     = -1;     // >= 0: allocate from this node. Otherwise the
+                                // kernel's first-touch policy applies, which
+                                // is already node-local once the thread is pinned.
+    bool busyPoll     = false;  // spin on the inbound queue instead of sleeping
+};
+
+// Applies cfg to the calling thread. Best effort: settings the platform or
+// the process's privileges refuse are skipped and false is returned.
+bool applyThreadConfig(const ThreadConfig& cfg) noexcept;
+
+// mlockall(MCL_CURRENT | MCL_FUTURE); false if refused (e.g. RLIMIT_MEMLOCK).
+bool lockProcessMemory() noexcept;
+// Touches the next `bytes` of the calling thread's stack so the first deep
+// call chain does not page-fault.
+void prefaultStack(std::size_t bytes = 256 * 1024) noexcept;
+
+inline void cpuRelax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
@@ -0,0 +1,113 @@
+#include "TradeStats.hpp"
+#include <algorithm>
+#include <chrono>
+#include <new>
+
+TradeStats::TradeStats(SymbolId maxSymbols)
+    : maxSymbols_(maxSymbols),
+      slots_(std::make_unique<std::atomic<Slot*>[]>(maxSymbols))
+{
+    open_.reserve(64);
+}
+
+TradeStats::~TradeStats()
+{
+    for (SymbolId i = 0; i < maxSymbols_; ++i)
+        delete slots_[i].load(std::memory_order_relaxed);
+}
+
+std::int64_t TradeStats::nowNs() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+TradeStats::Slot* TradeStats::slotFor(SymbolId sym) noexcept
+{
+    if (sym >= maxSymbols_) return nullptr;
+    auto* s = slots_[sym].load(std::memory_order_acquire);
+    if (!s) {
+        s = new (std::nothrow) Slot;
+        slots_[sym].store(s, std::memory_order_release);
+    }
+    return s;
+}
+
+void TradeStats::onTrade(SymbolId sym, PxTicks px, int qty, std::int64_t ts) noexcept
+{
+    Slot* s = slotFor(sym);
+    if (!s) return;
+    Summary& st = s->cur;
+
+    if (st.trades == 0) st.open = st.high = st.low = px;
+    st.high = std::max(st.high, px);
+    st.low  = std::min(st.low, px);
+    st.last = px;
+    st.lastQty = qty;
+    st.lastNs = ts;
+    st.notional += static_cast<double>(px) * qty;
+    st.volume += qty;
+    ++st.trades;
+
+    const std::int64_t iv = barNs_.load(std::memory_order_relaxed);
+    if (iv <= 0) return;
+    const std::int64_t start = ts - ts % iv;
+    Bar& b = st.bar;
+    if (b.trades && b.startNs != start) {
+        if (barCb_) barCb_(sym, b);
+        b.trades = 0;                       // stays in open_
+    }
+    else if (!b.trades) open_.push_back(sym);
+
+    if (b.trades == 0) b = {start, px, px, px, px, 0.0, 0, 0};
+    b.high = std::max(b.high, px);
+    b.low  = std::min(b.low, px);
+    b.close = px;
+    b.notional += static_cast<double>(px) * qty;
+    b.volume += qty;
+    ++b.trades;
+}
+
+void TradeStats::publish(SymbolId sym) noexcept
+{
+    if (sym >= maxSymbols_) return;
+    if (Slot* s = slots_[sym].load(std::memory_order_relaxed)) s->published.store(s->cur);
+}
+
+void TradeStats::closeBar(SymbolId sym, Slot& s) noexcept
+{
+    if (barCb_) barCb_(sym, s.cur.bar);
+    s.cur.bar.trades = 0;
+    s.published.store(s.cur);
+}
+
+void TradeStats::closeBars(std::int64_t now) noexcept
+{
+    const std::int64_t iv = barNs_.load(std::memory_order_relaxed);
+    std::size_t keep = 0;
+    for (SymbolId sym : open_) {
+        Slot& s = *slots_[sym].load(std::memory_order_relaxed);
+        if (iv <= 0 || s.cur.bar.startNs + iv <= now) closeBar(sym, s);
+        else open_[keep++] = sym;
+    }
+    open_.resize(keep);
+}
+
+std::int64_t TradeStats::nextCloseNs() const noexcept
+{
+    if (open_.empty()) return 0;
+    const std::int64_t iv = barNs_.load(std::memory_order_relaxed);
+    std::int64_t first = slots_[open_.front()].load(std::memory_order_relaxed)->cur.bar.startNs;
+    for (SymbolId sym : open_)
+        first = std::min(first, slots_[sym].load(std::memory_order_relaxed)->cur.bar.startNs);
+    return first + std::max<std::int64_t>(iv, 0);
+}
+
+bool TradeStats::summary(SymbolId sym, Summary& out) const noexcept
+{
+    if (sym >= maxSymbols_) return false;
+    const Slot* s = slots_[sym].load(std::memory_order_acquire);
+    if (!s) return false;
+    out = s->published.load();
+    return out.trades != 0;
+}
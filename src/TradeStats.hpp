@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Price.hpp"
+#include "Seqlock.hpp"
+#include "SymbolTable.hpp"
+
+// Running trade statistics per symbol, updated in O(1) per fill by the
+// matching thread and published through a seqlock, so any thread can read
+// a consistent summary without touching the matching path.
+//
+// Bars are aligned to multiples of the interval on the wall clock and only
+// exist for intervals that traded. A bar closes when the first trade of a
+// later interval arrives or when closeBars() passes its end, whichever
+// comes first; closed bars go to the bar handler.
+class TradeStats {
+public:
+    struct Bar {
+        std::int64_t  startNs;      // covers [startNs, startNs + interval)
+        PxTicks       open, high, low, close;
+        double        notional;     // in ticks
+        std::int64_t  volume;
+        std::uint64_t trades;       // 0: no bar open
+        PxTicks vwap() const noexcept { return volume ? std::llround(notional / volume) : 0; }
+    };
+
+    struct Summary {
+        PxTicks       last;
+        std::int64_t  lastQty;
+        std::int64_t  lastNs;
+        PxTicks       open, high, low;  // since the first trade
+        double        notional;         // in ticks
+        std::int64_t  volume;
+        std::uint64_t trades;
+        Bar           bar;              // the bar still open, if any
+        PxTicks vwap() const noexcept { return volume ? std::llround(notional / volume) : 0; }
+    };
+
+    using BarHandler = std::function<void(SymbolId, const Bar&)>;
+
+    static constexpr std::int64_t DEFAULT_BAR_NS = 60'000'000'000;
+
+    explicit TradeStats(SymbolId maxSymbols = SymbolTable::DEFAULT_CAPACITY);
+    ~TradeStats();
+    TradeStats(const TradeStats&) = delete;
+    TradeStats& operator=(const TradeStats&) = delete;
+
+    static std::int64_t nowNs() noexcept;
+
+    // Any thread. 0 turns bars off; the open ones close on the next
+    // closeBars(). A change takes effect at the next trade of each symbol.
+    void setBarInterval(std::int64_t ns) noexcept { barNs_.store(ns, std::memory_order_relaxed); }
+    std::int64_t barInterval() const noexcept { return barNs_.load(std::memory_order_relaxed); }
+
+    // Matching thread only. Set before trading starts; runs inline.
+    void setBarHandler(BarHandler cb) { barCb_ = std::move(cb); }
+    void onTrade(SymbolId symbol, PxTicks px, int qty, std::int64_t tsNs) noexcept;
+    // Makes the symbol's updates since the last publish visible to readers.
+    void publish(SymbolId symbol) noexcept;
+    // Closes every bar whose interval ended at or before nowNs.
+    void closeBars(std::int64_t nowNs) noexcept;
+    // End of the earliest open bar, 0 if none is open.
+    std::int64_t nextCloseNs() const noexcept;
+
+    // Any thread; false until the symbol has traded.
+    bool summary(SymbolId symbol, Summary& out) const noexcept;
+
+private:
+    struct Slot {
+        Summary cur{};
+        Seqlock<Summary> published;
+    };
+
+    Slot* slotFor(SymbolId symbol) noexcept;
+    void closeBar(SymbolId symbol, Slot& s) noexcept;
+
+    SymbolId maxSymbols_;
+    std::unique_ptr<std::atomic<Slot*>[]> slots_;   // allocated on first trade
+    std::vector<SymbolId> open_;                    // symbols with an open bar
+    std::atomic<std::int64_t> barNs_{DEFAULT_BAR_NS};
+    BarHandler barCb_ {nullptr};
+};
@@ -1,18 +1,85 @@
 #include "api_c.h"
 #include "EngineRunner.hpp"
+#include <cstddef>
 #include <memory>
 #include <mutex>
 #include <vector>
 #include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <poll.h>
 
 struct CEngine {
+    CEngine() = default;
+    CEngine(const ThreadConfig& worker, PrewarmConfig prewarm)
+        : runner(worker, std::move(prewarm)) {}
     EngineRunner runner;
     std::vector<OutboundMsg> buf;
+    std::size_t head = 0;
+    std::atomic<std::uint64_t> nextClientId{0};   // per handle, for untagged orders
 };
 
-struct DepthLevel { double px; int qty; };
+static_assert(TCX_REJ_THROTTLED == static_cast<int>(RejectReason::THROTTLED),
+              "tcx_reject_reason out of sync with RejectReason");
+static_assert(TCX_NO_SESSION == NO_SESSION, "TCX_NO_SESSION out of sync with NO_SESSION");
+static_assert(TCX_OVERFLOW_BLOCK    == static_cast<int>(Overflow::BLOCK) &&
+              TCX_OVERFLOW_REJECT   == static_cast<int>(Overflow::REJECT) &&
+              TCX_OVERFLOW_CONFLATE == static_cast<int>(Overflow::CONFLATE),
+              "tcx_overflow out of sync with Overflow");
+static_assert(TCX_PX_SCALE == PX_SCALE, "TCX_PX_SCALE out of sync with PX_SCALE");
+static_assert(TCX_LIMIT  == static_cast<int>(OrderType::LIMIT) &&
+              TCX_MARKET == static_cast<int>(OrderType::MARKET) &&
+              TCX_STOP   == static_cast<int>(OrderType::STOP) &&
+              TCX_SELL   == static_cast<int>(OrderSide::SELL),
+              "tcx_type / tcx_side out of sync with OrderType / OrderSide");
+
+// Messages cross the C boundary by memcpy, so the layouts must match.
+static_assert(sizeof(tcx_msg) == sizeof(InboundMsg));
+static_assert(offsetof(tcx_msg, symbolId) == offsetof(InboundMsg, symbolId));
+static_assert(offsetof(tcx_msg, px)       == offsetof(InboundMsg, px));
+static_assert(offsetof(tcx_msg, orderId)  == offsetof(InboundMsg, orderId));
+static_assert(offsetof(tcx_msg, qty)      == offsetof(InboundMsg, qty));
+static_assert(offsetof(tcx_msg, account)  == offsetof(InboundMsg, account));
+static_assert(offsetof(tcx_msg, clientId) == offsetof(InboundMsg, clientId));
+static_assert(sizeof(tcx_evt) == sizeof(OutboundMsg));
+static_assert(offsetof(tcx_evt, symbolId)       == offsetof(OutboundMsg, symbolId));
+static_assert(offsetof(tcx_evt, trade.px)       == offsetof(OutboundMsg, trade.px));
+static_assert(offsetof(tcx_evt, trade.qty)      == offsetof(OutboundMsg, trade.qty));
+static_assert(offsetof(tcx_evt, tob.askQty)     == offsetof(OutboundMsg, tob.askQty));
+static_assert(offsetof(tcx_evt, trade.sellId)   == offsetof(OutboundMsg, trade.sellId));
+static_assert(offsetof(tcx_evt, reject.reason)  == offsetof(OutboundMsg, reject.reason));
+static_assert(offsetof(tcx_evt, ack.clientId)   == offsetof(OutboundMsg, ack.clientId));
+static_assert(offsetof(tcx_evt, massCancel.count) == offsetof(OutboundMsg, massCancel.count));
+static_assert(offsetof(tcx_evt, l3.clientId)    == offsetof(OutboundMsg, l3.clientId));
+static_assert(offsetof(tcx_evt, l3.side)        == offsetof(OutboundMsg, l3.side));
+static_assert(offsetof(tcx_evt, l3.kind)        == offsetof(OutboundMsg, l3.kind));
+static_assert(offsetof(tcx_evt, bar.volume)     == offsetof(OutboundMsg, bar.volume));
+static_assert(TCX_EVT_BAR == static_cast<int>(OutboundType::BAR),
+              "tcx_evt_type out of sync with OutboundType");
+static_assert(TCX_L3_SNAPSHOT_END == static_cast<int>(L3Kind::SNAPSHOT_END),
+              "tcx_l3_kind out of sync with L3Kind");
 
 tcx_engine tcx_create_engine() { return new CEngine();  }
+tcx_engine tcx_create_engine_cfg(const tcx_thread_cfg* c, const tcx_prewarm_cfg* w)
+{
+    ThreadConfig cfg;
+    if (c) {
+        if (c->cpus) cfg.cpus.assign(c->cpus, c->cpus + c->nCpus);
+        cfg.fifoPriority = c->fifoPriority;
+        cfg.numaNode     = c->numaNode;
+        cfg.busyPoll     = c->busyPoll != 0;
+    }
+    PrewarmConfig warm;
+    if (w) {
+        for (int i = 0; i < w->nSymbols; ++i) warm.symbols.emplace_back(w->symbols[i]);
+        if (w->ordersPerBook > 0) warm.ordersPerBook = w->ordersPerBook;
+        if (w->warmupRounds >= 0) warm.warmupRounds = w->warmupRounds;
+        warm.lockMemory = w->lockMemory != 0;
+    }
+    return new CEngine(cfg, std::move(warm));
+}
 void       tcx_destroy_engine(tcx_engine h){ delete (CEngine*)h; }
 
 static std::shared_ptr<Order> makeShared(const char* s,
@@ -20,7 +87,7 @@ static std::shared_ptr<Order> makeShared(const char* s,
                                          double px, int qty)
 {
     return std::make_shared<Order>(
-        s,
+        s ? s : "",
         sd==TCX_BUY ? OrderSide::BUY : OrderSide::SELL,
         tp==TCX_LIMIT ? OrderType::LIMIT :
         tp==TCX_MARKET? OrderType::MARKET : OrderType::STOP,
@@ -33,85 +100,343 @@ tcx_order tcx_order_new(const char* sym,
     return new std::shared_ptr<Order>(makeShared(sym,sd,tp,px,qty));
 }
 void tcx_order_free(tcx_order p) { delete (std::shared_ptr<Order>*)p; }
+void tcx_order_set_account(tcx_order p, uint32_t account)
+{
+    auto& sp = *(std::shared_ptr<Order>*)p;
+    auto rebuilt = std::make_shared<Order>(sp->getOrderId(), sp->getSymbol(), sp->getSide(),
+                                           sp->getType(), sp->getPrice(), sp->getQuantity(), account);
+    rebuilt->setClientId(sp->getClientId());
+    sp = std::move(rebuilt);
+}
+void tcx_order_set_client_id(tcx_order p, uint64_t clientId)
+{
+    (*(std::shared_ptr<Order>*)p)->setClientId(clientId);
+}
 
-int tcx_submit(tcx_engine h, tcx_order o)
+uint32_t tcx_symbol_id(tcx_engine h, const char* sym)
+{
+    return sym ? ((CEngine*)h)->runner.engine().symbols().intern(sym) : 0;
+}
+const char* tcx_symbol_name(tcx_engine h, uint32_t id)
+{
+    return ((CEngine*)h)->runner.engine().symbols().name(id).c_str();
+}
+int tcx_set_tick_size(tcx_engine h, uint32_t id, int64_t tickSize)
+{
+    return ((CEngine*)h)->runner.engine().symbols().setTickSize(id, tickSize) ? 0 : -1;
+}
+int64_t tcx_tick_size(tcx_engine h, uint32_t id)
+{
+    return ((CEngine*)h)->runner.engine().symbols().tickSize(id);
+}
+
+uint64_t tcx_submit(tcx_engine h, tcx_order o)
 {
     auto  eng  = (CEngine*)h;
-    auto* sptr = (std::shared_ptr<Order>*)o;
-    int   id   = (*sptr)->getOrderId();
-    eng->runner.push(NewOrderMsg{*sptr});
+    auto& ord  = **(std::shared_ptr<Order>*)o;
+    if (ord.getClientId() == 0) ord.setClientId(++eng->nextClientId);
+    SymbolId sym = eng->runner.engine().symbols().intern(ord.getSymbol());
+    eng->runner.push(InboundMsg::newOrder(sym, ord));
+    return ord.getClientId();
+}
+int tcx_cancel(tcx_engine h, int64_t id)
+{
+    return ((CEngine*)h)->runner.push(InboundMsg::cancel(id)) ? 0 : -1;
+}
+int tcx_modify(tcx_engine h, int64_t id, double px, int qty)
+{
+    std::optional<PxTicks> npx = (px  >0) ? std::optional<PxTicks>(toTicks(px)) : std::nullopt;
+    std::optional<int>     nqt = (qty >0) ? std::optional<int>(qty)            : std::nullopt;
+    return ((CEngine*)h)->runner.push(InboundMsg::modify(id,npx,nqt)) ? 0 : -1;
+}
+
+uint64_t tcx_send(tcx_engine h, const tcx_msg* msg)
+{
+    return tcx_session_send(h, TCX_NO_SESSION, msg);
+}
+
+uint64_t tcx_session_send(tcx_engine h, uint32_t session, const tcx_msg* msg)
+{
+    auto* eng = (CEngine*)h;
+    InboundMsg m;
+    std::memcpy(&m, msg, sizeof(m));
+    if (m.type == InboundType::NEW_ORDER && m.clientId == 0)
+        m.clientId = ++eng->nextClientId;
+    eng->runner.push(&m, 1, session);
+    return m.type == InboundType::NEW_ORDER ? m.clientId : 0;
+}
+
+// every return of tcx_await_ack: the events it took off the runner still
+// wait for tcx_next_event, so the event fd must say so
+static int64_t awaitDone(CEngine* eng, int64_t id)
+{
+    if (eng->head < eng->buf.size()) eng->runner.raiseEventFd();
     return id;
 }
-int tcx_cancel(tcx_engine h,int id)
+
+int64_t tcx_await_ack(tcx_engine h, uint64_t clientId, int timeoutMs)
+{
+    auto* eng = (CEngine*)h;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::size_t seen = eng->head;
+    for (;;) {
+        OutboundMsg ev;
+        while (eng->runner.poll(ev)) eng->buf.push_back(ev);
+        for (; seen < eng->buf.size(); ++seen) {
+            const auto& e = eng->buf[seen];
+            if (e.type == OutboundType::ACK && e.ack.clientId == clientId)
+                return awaitDone(eng, e.ack.orderId);
+            if (e.type == OutboundType::REJECT && e.reject.clientId == clientId &&
+                e.reject.orderId == NO_ORDER)
+                return awaitDone(eng, -1);
+        }
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0) return awaitDone(eng, -1);
+        pollfd pfd{eng->runner.eventFd(), POLLIN, 0};
+        if (pfd.fd < 0) std::this_thread::yield();
+        else ::poll(&pfd, 1, static_cast<int>(left));
+    }
+}
+
+int tcx_shard_of(int64_t orderId) { return shardOf(orderId); }
+
+int tcx_mass_cancel(tcx_engine h, uint32_t account, uint32_t symbolId, int side)
+{
+    std::optional<OrderSide> sd;
+    if (side == TCX_BUY)  sd = OrderSide::BUY;
+    if (side == TCX_SELL) sd = OrderSide::SELL;
+    return ((CEngine*)h)->runner.push(InboundMsg::massCancel(account, symbolId, sd)) ? 0 : -1;
+}
+
+int tcx_auction_start(tcx_engine h, uint32_t symbolId)
+{
+    return ((CEngine*)h)->runner.push(InboundMsg::auctionStart(symbolId)) ? 0 : -1;
+}
+int tcx_auction_uncross(tcx_engine h, uint32_t symbolId, int resumeContinuous)
+{
+    return ((CEngine*)h)->runner.push(InboundMsg::auctionUncross(symbolId, resumeContinuous != 0)) ? 0 : -1;
+}
+
+void tcx_l3_enable(tcx_engine h, int on)
+{
+    ((CEngine*)h)->runner.setL3Feed(on != 0);
+}
+uint64_t tcx_l3_snapshot(tcx_engine h, uint32_t symbolId)
+{
+    auto* eng = (CEngine*)h;
+    std::uint64_t cid = ++eng->nextClientId;
+    eng->runner.push(InboundMsg::bookSnapshot(symbolId, cid));
+    return cid;
+}
+
+uint32_t tcx_session_open(tcx_engine h, uint32_t account, int cancelOnDisconnect)
 {
-    ((CEngine*)h)->runner.push(CancelMsg{id});
+    return ((CEngine*)h)->runner.openSession(account, cancelOnDisconnect != 0);
+}
+void tcx_session_close(tcx_engine h, uint32_t session)
+{
+    ((CEngine*)h)->runner.closeSession(session);
+}
+
+int tcx_set_flow_control(tcx_engine h, const tcx_flow_cfg* c)
+{
+    FlowControl fc;
+    fc.inCapacity     = static_cast<std::size_t>(c->inCapacity);
+    fc.outCapacity    = static_cast<std::size_t>(c->outCapacity);
+    fc.sessionCredits = c->sessionCredits;
+    if (c->inbound > TCX_OVERFLOW_CONFLATE || c->outbound > TCX_OVERFLOW_CONFLATE) return -1;
+    fc.inbound  = static_cast<Overflow>(c->inbound);
+    fc.outbound = static_cast<Overflow>(c->outbound);
+    return ((CEngine*)h)->runner.setFlowControl(fc) ? 0 : -1;
+}
+
+int64_t tcx_credits(tcx_engine h, uint32_t session)
+{
+    const std::size_t n = ((CEngine*)h)->runner.credits(session);
+    return n > static_cast<std::size_t>(INT64_MAX) ? INT64_MAX : static_cast<int64_t>(n);
+}
+
+int tcx_set_risk_limits(tcx_engine h, uint32_t account,
+                        int maxOrderQty, double maxNotional,
+                        int maxOpenOrders, int64_t maxPosition)
+{
+    auto& risk = ((CEngine*)h)->runner.engine().risk();
+    if (account >= risk.maxAccounts()) return -1;
+    RiskLimits l;
+    if (maxOrderQty   > 0) l.maxOrderQty   = maxOrderQty;
+    if (maxNotional   > 0) l.maxNotional   = maxNotional;
+    if (maxOpenOrders > 0) l.maxOpenOrders = maxOpenOrders;
+    if (maxPosition   > 0) l.maxPosition   = maxPosition;
+    risk.setLimits(account, l);
     return 0;
 }
-int tcx_modify(tcx_engine h,int id,double px,int qty)
+
+int64_t tcx_position(tcx_engine h, uint32_t account, uint32_t symbolId)
+{
+    return ((CEngine*)h)->runner.engine().risk().position(account, symbolId);
+}
+
+int tcx_stats(tcx_engine h, uint32_t symbolId, tcx_trade_stats* out)
+{
+    TradeStats::Summary s;
+    if (!((CEngine*)h)->runner.engine().stats().summary(symbolId, s)) return 0;
+    const TradeStats::Bar& b = s.bar;
+    *out = {s.last, s.lastQty, s.lastNs, s.open, s.high, s.low, s.vwap(), s.volume, s.trades,
+            {b.startNs, b.open, b.high, b.low, b.close, b.vwap(), b.volume, b.trades}};
+    return 1;
+}
+
+void tcx_set_bar_interval(tcx_engine h, int64_t intervalMs)
+{
+    ((CEngine*)h)->runner.setBarInterval(std::chrono::milliseconds(intervalMs));
+}
+
+int tcx_record_tape(tcx_engine h, const char* root)
+{
+    return root && ((CEngine*)h)->runner.recordTape(root) ? 0 : -1;
+}
+
+void tcx_metrics(tcx_engine h, tcx_engine_metrics* out)
+{
+    const MetricsSnapshot s = ((CEngine*)h)->runner.metrics().read();
+    *out = {s[Metric::MSGS_IN], s[Metric::MSGS_HANDLED], s.inQueue(),
+            s[Metric::EVENTS_OUT], s[Metric::EVENTS_POLLED], s.outQueue(),
+            s[Metric::ORDERS], s[Metric::CANCELS], s[Metric::MODIFIES], s[Metric::MASS_CANCELS],
+            s[Metric::ACKS], s[Metric::REJECTS], s[Metric::FILLS], s[Metric::FILLED_QTY],
+            s[Metric::THROTTLED], s[Metric::CONFLATED], s[Metric::RESTING_ORDERS], s[Metric::BOOKS]};
+}
+
+uint32_t tcx_book_orders(tcx_engine h, uint32_t symbolId)
 {
-    std::optional<double> npx = (px  >0) ? std::optional<double>(px)  : std::nullopt;
-    std::optional<int>    nqt = (qty >0) ? std::optional<int>(qty)    : std::nullopt;
-    ((CEngine*)h)->runner.push(ModifyMsg{id,npx,nqt});
+    return ((CEngine*)h)->runner.metrics().bookOrders(symbolId);
+}
+
+const char* tcx_metrics_shm(tcx_engine h)
+{
+    return ((CEngine*)h)->runner.metrics().shmName().c_str();
+}
+
+int tcx_flight_dump(tcx_engine h, const char* path, char* name, int cap)
+{
+    const std::string file = ((CEngine*)h)->runner.dumpFlightRecorder(path ? path : "");
+    if (file.empty()) return -1;
+    if (name && cap > 0) {
+        std::strncpy(name, file.c_str(), static_cast<std::size_t>(cap) - 1);
+        name[cap - 1] = '\0';
+    }
     return 0;
 }
 
-static void printEvent(const OutboundMsg& ev)
-{
-    std::visit([](auto&& e){
-        using T = std::decay_t<decltype(e)>;
-        if constexpr (std::is_same_v<T, TradeEvent>)
-            std::printf("FILL  %s  buy=%d  sell=%d\n",
-                        e.fill.symbol.c_str(),
-                        e.fill.buyId, e.fill.sellId);
-        else
-            std::printf("TOB   %s  %d@%.2f  /  %d@%.2f\n",
-                        e.symbol.c_str(),
-                        e.bidQty, e.bidPx,
-                        e.askQty, e.askPx);
-    }, ev);
-}
-
-static bool to_c_evt(const OutboundMsg& ev, tcx_evt& out)
-{
-    memset(&out, 0, sizeof(out));
-    return std::visit([&](auto&& e)->bool{
-        using T = std::decay_t<decltype(e)>;
-        if constexpr (std::is_same_v<T,TradeEvent>){
-            out.type   = TCX_EVT_TRADE;
-            std::strncpy(out.symbol, e.fill.symbol.c_str(), 15);
-            out.buyId  = e.fill.buyId;
-            out.sellId = e.fill.sellId;
-            out.qty    = e.fill.qty;
-            out.px     = e.fill.price;
-        } else {
-            out.type    = TCX_EVT_TOB;
-            std::strncpy(out.symbol, e.symbol.c_str(), 15);
-            out.bidPx   = e.bidPx;
-            out.bidQty  = e.bidQty;
-            out.askPx   = e.askPx;
-            out.askQty  = e.askQty;
-        }
-        return true;
-    }, ev);
+void tcx_flight_set_dir(tcx_engine h, const char* dir)
+{
+    if (dir) ((CEngine*)h)->runner.setFlightDumpDir(dir);
 }
 
+void tcx_flight_latency_dump(tcx_engine h, int64_t thresholdUs)
+{
+    ((CEngine*)h)->runner.setLatencyDump(std::chrono::microseconds(thresholdUs));
+}
+
+int tcx_flight_signal(int sig)
+{
+    return FlightRecorder::installSignalHandler(sig) ? 0 : -1;
+}
+
+static void printEvent(const SymbolTable& syms, const OutboundMsg& e)
+{
+    const char* sym = syms.name(e.symbolId).c_str();
+    switch (e.type) {
+    case OutboundType::TRADE:
+        std::printf("FILL  %s  buy=%lld  sell=%lld\n",
+                    sym, (long long)e.trade.buyId, (long long)e.trade.sellId);
+        break;
+    case OutboundType::REJECT:
+        std::printf("REJ   %s  id=%lld  %s\n",
+                    sym, (long long)e.reject.orderId, toString(e.reject.reason));
+        break;
+    case OutboundType::MASS_CANCEL:
+        std::printf("MCXL  acct=%u  n=%d\n",
+                    e.massCancel.account, e.massCancel.count);
+        break;
+    case OutboundType::ACK:
+        std::printf("ACK   %s  id=%lld  client=%llu\n", sym,
+                    (long long)e.ack.orderId, (unsigned long long)e.ack.clientId);
+        break;
+    case OutboundType::L3:
+        std::printf("L3    %s  seq=%llu  kind=%d  id=%lld  %d@%.2f\n", sym,
+                    (unsigned long long)e.l3.seq, (int)e.l3.kind,
+                    (long long)e.l3.orderId, e.l3.qty, fromTicks(e.l3.px));
+        break;
+    case OutboundType::BAR:
+        std::printf("BAR   %s  o=%.2f h=%.2f l=%.2f c=%.2f  vwap=%.4f  vol=%lld\n", sym,
+                    fromTicks(e.bar.open), fromTicks(e.bar.high), fromTicks(e.bar.low),
+                    fromTicks(e.bar.close), fromTicks(e.bar.vwap), (long long)e.bar.volume);
+        break;
+    case OutboundType::TOB:
+        std::printf("TOB   %s  %d@%.2f  /  %d@%.2f\n",
+                    sym,
+                    e.tob.bidQty, fromTicks(e.tob.bidPx),
+                    e.tob.askQty, fromTicks(e.tob.askPx));
+        break;
+    }
+}
+
+const char* tcx_reject_text(int reason)
+{
+    return toString(static_cast<RejectReason>(reason));
+}
 
 void tcx_poll(tcx_engine h)
 {
     auto* eng = (CEngine*)h;
+    if (eng->head == eng->buf.size()) { eng->buf.clear(); eng->head = 0; }
     OutboundMsg ev;
     while (eng->runner.poll(ev))
         eng->buf.push_back(ev); 
 }
 
+int tcx_event_fd(tcx_engine h) { return ((CEngine*)h)->runner.eventFd(); }
+
 int tcx_next_event(tcx_engine h, tcx_evt* out)
 {
     auto* eng = (CEngine*)h;
-    if (eng->buf.empty()) return 0;
-    to_c_evt(eng->buf.front(), *out);
-    eng->buf.erase(eng->buf.begin());
+    if (eng->head == eng->buf.size()) return 0;
+    std::memcpy(out, &eng->buf[eng->head++], sizeof(*out));
+    return 1;
+}
+
+void tcx_set_event_callback(tcx_engine h, tcx_event_fn fn, void* user)
+{
+    EngineRunner::EventHandler cb;
+    if (fn) cb = [fn, user](const OutboundMsg* evs, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) fn(user, reinterpret_cast<const tcx_evt*>(evs + i));
+    };
+    ((CEngine*)h)->runner.setEventHandler(std::move(cb));
+}
+
+void tcx_set_batch_callback(tcx_engine h, tcx_batch_fn fn, void* user)
+{
+    EngineRunner::EventHandler cb;
+    if (fn) cb = [fn, user](const OutboundMsg* evs, std::size_t n) {
+        fn(user, reinterpret_cast<const tcx_evt*>(evs), n);
+    };
+    ((CEngine*)h)->runner.setEventHandler(std::move(cb));
+}
+
+tcx_sub tcx_subscribe(tcx_engine h, uint32_t symbolId, uint32_t typeMask)
+{
+    return ((CEngine*)h)->runner.subscribe({symbolId, typeMask}).release();
+}
+int tcx_sub_next(tcx_sub s, tcx_evt* out)
+{
+    OutboundMsg ev;
+    if (!((EventBus::Subscription*)s)->next(ev)) return 0;
+    std::memcpy(out, &ev, sizeof(*out));
     return 1;
 }
+uint64_t tcx_sub_lost(tcx_sub s) { return ((EventBus::Subscription*)s)->lost(); }
+void tcx_unsubscribe(tcx_sub s) { delete (EventBus::Subscription*)s; }
 
 extern "C"
 int tcx_depth(tcx_engine         h,
@@ -122,27 +447,25 @@ int tcx_depth(tcx_engine         h,
               tcx_level*         askBuf,
               int*               nAsks)
 {
-    auto* book = ((CEngine*)h)->runner.engine().getBook(symbol);
+    auto& eng = ((CEngine*)h)->runner.engine();
+    const OrderBook* book = eng.getBook(eng.symbols().find(symbol));
     if (!book) { *nBids = *nAsks = 0; return 0; }
 
-    auto bids = book->getBuyOrders();
-    auto asks = book->getSellOrders();
-
-    int nb = std::min<int>(levels, bids.size());
-    int na = std::min<int>(levels, asks.size());
+    // lock-free: reads the last snapshot the matching thread published
+    const BookSnapshot snap = book->snapshot();
+    levels = std::max(levels, 0);
+    int nb = std::min(levels, snap.nBids);
+    int na = std::min(levels, snap.nAsks);
 
     for (int i = 0; i < nb; ++i) {
-        bidBuf[i].px  = bids[i]->getPrice();
-        bidBuf[i].qty = bids[i]->getQuantity();
+        bidBuf[i].px  = snap.bids[i].px;
+        bidBuf[i].qty = snap.bids[i].qty;
     }
     for (int i = 0; i < na; ++i) {
-        askBuf[i].px  = asks[i]->getPrice();
-        askBuf[i].qty = asks[i]->getQuantity();
+        askBuf[i].px  = snap.asks[i].px;
+        askBuf[i].qty = snap.asks[i].qty;
     }
     *nBids = nb;
     *nAsks = na;
     return nb + na;
 }
-
-
-
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-typedef struct { double px; int qty; } tcx_level;
+/* aggregated price level; px is fixed-point, see TCX_PX_SCALE */
+typedef struct { int64_t px; int qty; } tcx_level;
 
 typedef void* tcx_engine;
 typedef void* tcx_order;
@@ -13,41 +17,292 @@ enum tcx_side { TCX_BUY  = 0, TCX_SELL  = 1 };
 enum tcx_type { TCX_LIMIT= 1, TCX_MARKET= 2, TCX_STOP = 3 };
 
 tcx_engine tcx_create_engine(void);
+
+/* Placement of the engine's matching thread. cpus may be NULL (no pinning);
+   fifoPriority 0 keeps the default scheduler; numaNode -1 relies on first
+   touch; busyPoll != 0 spins instead of sleeping when idle. */
+struct tcx_thread_cfg {
+    const int* cpus;
+    int        nCpus;
+    int        fifoPriority;
+    int        numaNode;
+    int        busyPoll;
+};
+/* Startup warm-up on the matching thread: pre-creates the books, reserves
+   tables and cycles synthetic orders through them (no events are emitted).
+   lockMemory != 0 mlocks the process. */
+struct tcx_prewarm_cfg {
+    const char* const* symbols;
+    int                nSymbols;
+    int                ordersPerBook;
+    int                warmupRounds;
+    int                lockMemory;
+};
+/* either pointer may be NULL */
+tcx_engine tcx_create_engine_cfg(const struct tcx_thread_cfg*  worker,
+                                 const struct tcx_prewarm_cfg* prewarm);
 void       tcx_destroy_engine(tcx_engine e);
 
+/* price is rounded to the nearest 1/TCX_PX_SCALE */
 tcx_order  tcx_order_new(const char* symbol,
                          enum tcx_side side,
                          enum tcx_type type,
                          double price,
                          int    qty);
 void       tcx_order_free(tcx_order o);
+void       tcx_order_set_account(tcx_order o, uint32_t account);
+void       tcx_order_set_client_id(tcx_order o, uint64_t clientId);
 
-int  tcx_submit(tcx_engine e, tcx_order o);  
-int  tcx_cancel(tcx_engine e, int orderId);  
-int  tcx_modify(tcx_engine e, int orderId,
-                double newPx /*≤0 keep*/,
-                int    newQty/*≤0 keep*/);
+/* Order ids are 64-bit and minted by the engine when it accepts an order;
+   bits 62..48 hold the shard. Submitting returns the order's client id
+   (one is assigned if unset) and the engine answers with TCX_EVT_ACK or
+   TCX_EVT_REJECT carrying it. */
+uint64_t tcx_submit(tcx_engine e, tcx_order o);
+int      tcx_cancel(tcx_engine e, int64_t orderId);
+int      tcx_modify(tcx_engine e, int64_t orderId,
+                    double newPx /*≤0 keep*/,
+                    int    newQty/*≤0 keep*/);
+/* Waits up to timeoutMs for the ack of clientId and returns the order id,
+   or -1 on reject or timeout. Events seen meanwhile stay queued for
+   tcx_next_event. */
+int64_t  tcx_await_ack(tcx_engine e, uint64_t clientId, int timeoutMs);
+int      tcx_shard_of(int64_t orderId);
+
+/* every price the engine reports is fixed-point: px / TCX_PX_SCALE */
+#define TCX_PX_SCALE 10000
+
+/* symbols travel as interned ids; 0 means "no symbol" */
+uint32_t    tcx_symbol_id  (tcx_engine e, const char* symbol);
+const char* tcx_symbol_name(tcx_engine e, uint32_t symbolId);
+/* Limit prices of a symbol must be multiples of tickSize (fixed-point,
+   default 1); others are rejected with TCX_REJ_BAD_PRICE. -1 for an
+   unknown symbol or tickSize <= 0. */
+int         tcx_set_tick_size(tcx_engine e, uint32_t symbolId, int64_t tickSize);
+int64_t     tcx_tick_size    (tcx_engine e, uint32_t symbolId);
+
+enum tcx_msg_type { TCX_MSG_NEW=0, TCX_MSG_CANCEL=1, TCX_MSG_MODIFY=2, TCX_MSG_MASS_CANCEL=3,
+                   TCX_MSG_AUCTION_START=4, TCX_MSG_AUCTION_UNCROSS=5, TCX_MSG_BOOK_SNAPSHOT=6 };
+enum tcx_msg_flags { TCX_MSG_HAS_PX=1, TCX_MSG_HAS_QTY=2, TCX_MSG_HAS_SIDE=4, TCX_MSG_RESUME=8,
+                     TCX_MSG_OWNER=16 /* CANCEL / MODIFY: only an order of `account` */ };
+
+/* 64-byte inbound message; pushed to the engine as-is */
+struct tcx_msg {
+    uint8_t  type;       /* enum tcx_msg_type              */
+    uint8_t  side;       /* enum tcx_side                  */
+    uint8_t  ordType;    /* enum tcx_type                  */
+    uint8_t  flags;      /* enum tcx_msg_flags (MODIFY)    */
+    uint32_t symbolId;
+    int64_t  px;
+    int64_t  orderId;    /* CANCEL / MODIFY target */
+    int32_t  qty;
+    uint32_t account;
+    uint64_t clientId;   /* echoed on the ack (NEW) or any reject */
+    uint8_t  _reserved[24];
+};
+
+/* returns the client id for TCX_MSG_NEW (assigned if 0), 0 otherwise */
+uint64_t tcx_send(tcx_engine e, const struct tcx_msg* msg);
+
+/* per-account pre-trade limits; pass <= 0 to leave a limit unbounded */
+int  tcx_set_risk_limits(tcx_engine e, uint32_t account,
+                         int maxOrderQty, double maxNotional,
+                         int maxOpenOrders, int64_t maxPosition);
+int64_t tcx_position(tcx_engine e, uint32_t account, uint32_t symbolId);
+
+/* cancels all of an account's orders; symbolId 0 = every symbol,
+   side < 0 = both sides. Acknowledged with TCX_EVT_MASS_CANCEL. */
+int  tcx_mass_cancel(tcx_engine e, uint32_t account, uint32_t symbolId, int side);
+
+/* call auction: orders accumulate until uncross, which fills at one price.
+   symbolId 0 = every book. resumeContinuous = 0 keeps collecting (batch auctions). */
+int  tcx_auction_start  (tcx_engine e, uint32_t symbolId);
+int  tcx_auction_uncross(tcx_engine e, uint32_t symbolId, int resumeContinuous);
+
+/* closing a session opened with cancelOnDisconnect != 0 cancels the orders it placed */
+uint32_t tcx_session_open (tcx_engine e, uint32_t account, int cancelOnDisconnect);
+void     tcx_session_close(tcx_engine e, uint32_t session);
+
+/* Bounded queues. Messages wait for the matching thread in an inbound queue
+   and events wait for tcx_poll in an outbound one; 0 means unbounded.
+   A full inbound queue makes the handle's calls wait (BLOCK) or refuses
+   them (REJECT): tcx_cancel, tcx_modify, tcx_mass_cancel and the auction
+   calls return -1, and orders get a TCX_REJ_THROTTLED reject while the
+   outbound queue has room. A full outbound queue stops matching (BLOCK) or,
+   with CONFLATE, keeps reports and conflates quotes / drops incremental L3.
+   Defaults: 65536 in, 1048576 out, 4096 credits, BLOCK / CONFLATE. */
+enum tcx_overflow { TCX_OVERFLOW_BLOCK=0, TCX_OVERFLOW_REJECT=1, TCX_OVERFLOW_CONFLATE=2 };
+struct tcx_flow_cfg {
+    uint64_t inCapacity;
+    uint64_t outCapacity;
+    uint32_t sessionCredits;   /* messages a session may have waiting; 0: no limit */
+    uint8_t  inbound;          /* BLOCK or REJECT   */
+    uint8_t  outbound;         /* BLOCK or CONFLATE */
+};
+/* -1 for a policy that does not apply to its queue */
+int  tcx_set_flow_control(tcx_engine e, const struct tcx_flow_cfg* cfg);
+
+#define TCX_NO_SESSION 0xffffffffu
+/* Messages `session` (TCX_NO_SESSION: the handle's own calls) can send now
+   without waiting or being refused; pace on it instead of overrunning the
+   engine. Over shared memory, the free slots of the connection's ring. */
+int64_t  tcx_credits(tcx_engine e, uint32_t session);
+/* tcx_send on behalf of a session: never waits; past the session's credits
+   the message is refused with a TCX_REJ_THROTTLED reject */
+uint64_t tcx_session_send(tcx_engine e, uint32_t session, const struct tcx_msg* msg);
 
 void tcx_poll(tcx_engine e);
+/* A file descriptor (an eventfd) that is readable while tcx_poll has events
+   to collect; wait on it with poll/epoll/select or an event loop instead of
+   spinning. Signalled at most once per batch of events and cleared by the
+   tcx_poll that empties the queue, so on each wake call tcx_poll and drain
+   tcx_next_event (events tcx_await_ack set aside count as uncollected).
+   Owned by the engine: do not close it. Reading it is allowed, e.g. to stop
+   a level-triggered loop from waking again before tcx_poll runs. -1 if it
+   could not be created. */
+int  tcx_event_fd(tcx_engine e);
 
-enum tcx_evt_type { TCX_EVT_TRADE=0, TCX_EVT_TOB=1 };
+enum tcx_evt_type { TCX_EVT_TRADE=0, TCX_EVT_TOB=1, TCX_EVT_REJECT=2, TCX_EVT_MASS_CANCEL=3,
+                    TCX_EVT_ACK=4, TCX_EVT_L3=5, TCX_EVT_BAR=6 };
 
+/* Order-by-order feed (TCX_EVT_L3), off until tcx_l3_enable. seq counts each
+   symbol's changes without gaps; MODIFY moves the order to the back of its
+   level. A consumer that misses a seq calls tcx_l3_snapshot and rebuilds
+   from SNAPSHOT_BEGIN / SNAPSHOT_ORDER... / SNAPSHOT_END, which arrive in
+   the stream at the point of their seq, so the next incremental is seq+1. */
+enum tcx_l3_kind { TCX_L3_ADD=0, TCX_L3_MODIFY=1, TCX_L3_CANCEL=2, TCX_L3_EXEC=3,
+                   TCX_L3_SNAPSHOT_BEGIN=4, TCX_L3_SNAPSHOT_ORDER=5, TCX_L3_SNAPSHOT_END=6 };
+void     tcx_l3_enable  (tcx_engine e, int on);
+/* returns the client id echoed on the snapshot's events */
+uint64_t tcx_l3_snapshot(tcx_engine e, uint32_t symbolId);
+
+/* mirrors RejectReason in Order.hpp */
+enum tcx_reject_reason {
+    TCX_REJ_NONE=0, TCX_REJ_NULL_ORDER, TCX_REJ_EMPTY_SYMBOL, TCX_REJ_BAD_QTY,
+    TCX_REJ_BAD_PRICE, TCX_REJ_QTY_LIMIT, TCX_REJ_SYMBOL_MISMATCH,
+    TCX_REJ_UNKNOWN_ORDER, TCX_REJ_INACTIVE_ORDER, TCX_REJ_UNKNOWN_ACCOUNT,
+    TCX_REJ_NOTIONAL_LIMIT, TCX_REJ_OPEN_ORDER_LIMIT, TCX_REJ_POSITION_LIMIT,
+    TCX_REJ_THROTTLED
+};
+
+/* 64-byte outbound event, copied verbatim from the engine's queue */
 struct tcx_evt {
-    enum tcx_evt_type type;
-    char   symbol[16];
-    int    buyId;
-    int    sellId;
-    int    qty;
-    double px;
-
-    double bidPx;
-    int    bidQty;
-    double askPx;
-    int    askQty;
+    uint8_t  type;       /* enum tcx_evt_type */
+    uint8_t  _pad[3];
+    uint32_t symbolId;   /* see tcx_symbol_name */
+    union {
+        struct { int64_t px; int64_t buyId; int64_t sellId; int32_t qty; } trade;
+        struct { int64_t bidPx; int64_t askPx; int32_t bidQty; int32_t askQty; } tob;
+        struct { int64_t orderId; uint64_t clientId; uint8_t reason; /* enum tcx_reject_reason */ } reject;
+        struct { uint32_t account; int32_t count; } massCancel;
+        struct { int64_t orderId; uint64_t clientId; } ack;
+        /* qty: ADD/MODIFY/SNAPSHOT_ORDER the order's, CANCEL/EXEC the amount
+           removed, SNAPSHOT_BEGIN/END the number of orders */
+        struct { uint64_t seq; int64_t orderId; int64_t px; uint64_t clientId;
+                 int32_t qty; uint8_t side; uint8_t kind; /* enum tcx_l3_kind */ } l3;
+        /* closed bar, prices fixed-point; see tcx_set_bar_interval */
+        struct { int64_t startNs; int64_t open; int64_t high; int64_t low;
+                 int64_t close; int64_t vwap; int64_t volume; } bar;
+    };
 };
 
 int tcx_next_event(tcx_engine eng, struct tcx_evt* out);
+const char* tcx_reject_text(int reason);
+
+/* Push delivery instead of tcx_poll: the matching thread calls fn for
+   each event as soon as its batch is done, with a pointer into its own
+   buffer (valid only during the call); tcx_set_batch_callback passes the
+   whole batch at once. While a callback is set, tcx_poll, tcx_next_event,
+   tcx_await_ack and tcx_event_fd see no events. Throttle rejects are
+   delivered on the thread whose call was refused. Calls never overlap and
+   none is made after the setter returns; fn NULL goes back to polling. fn
+   runs on the matching path, so it must return quickly and must not call
+   back into the engine (including the setters). */
+typedef void (*tcx_event_fn)(void* user, const struct tcx_evt* evt);
+typedef void (*tcx_batch_fn)(void* user, const struct tcx_evt* evts, size_t n);
+void tcx_set_event_callback(tcx_engine e, tcx_event_fn fn, void* user);
+void tcx_set_batch_callback(tcx_engine e, tcx_batch_fn fn, void* user);
+
+/* Broadcast subscriptions. tcx_poll / tcx_next_event take events from the
+   handle's single flow-controlled queue; a subscription instead sees every
+   event (before conflation) without taking it from anyone, so any number of
+   readers can follow the same fills. symbolId 0 = every symbol, typeMask 0 =
+   every type, else a TCX_EVT_BIT per wanted type. A subscriber never slows
+   the engine: one that falls a whole ring behind loses events (counted by
+   tcx_sub_lost). Use each subscription from one thread, and free it before
+   the engine. */
+typedef void* tcx_sub;
+#define TCX_EVT_BIT(type) (1u << (type))
+tcx_sub  tcx_subscribe  (tcx_engine e, uint32_t symbolId, uint32_t typeMask);
+/* 1 and *out filled, or 0 when caught up; never blocks */
+int      tcx_sub_next   (tcx_sub s, struct tcx_evt* out);
+uint64_t tcx_sub_lost   (tcx_sub s);
+void     tcx_unsubscribe(tcx_sub s);
+
+/* Running trade statistics of a symbol, updated with every fill. Bars are
+   aligned to multiples of the interval since the epoch (wall clock) and
+   only exist for intervals that traded; each closes into a TCX_EVT_BAR.
+   Prices are fixed-point; vwap is rounded to 1/TCX_PX_SCALE. */
+struct tcx_bar {
+    int64_t  startNs;
+    int64_t  open, high, low, close, vwap;
+    int64_t  volume;
+    uint64_t trades;     /* 0: no bar open */
+};
+struct tcx_trade_stats {
+    int64_t  last;
+    int64_t  lastQty;
+    int64_t  lastNs;     /* ns since the epoch */
+    int64_t  open, high, low, vwap;
+    int64_t  volume;
+    uint64_t trades;
+    struct tcx_bar bar;  /* the bar still open */
+};
+/* lock-free; returns 0 (and leaves *out alone) until the symbol has traded */
+int  tcx_stats(tcx_engine e, uint32_t symbolId, struct tcx_trade_stats* out);
+/* default one minute; 0 turns bars off */
+void tcx_set_bar_interval(tcx_engine e, int64_t intervalMs);
+
+/* Records every fill and top-of-book change from now on into memory-mapped
+   columnar files, one directory per UTC day: <root>/YYYYMMDD/trades.<col>
+   (ts sym px qty buy sell), quotes.<col> (ts sym bid ask bidqty askqty),
+   plus meta and a block index; see Tape.hpp for the layout. Returns 0, or
+   -1 if root cannot be created or a tape is already being recorded. */
+int  tcx_record_tape(tcx_engine e, const char* root);
+
+/* Engine counters summed over all threads. Queue depths are derived:
+   in_queue = msgs_in - msgs_handled, out_queue = events_out - events_polled.
+   The same registry is mapped at /dev/shm/<tcx_metrics_shm()> for tce_top. */
+struct tcx_engine_metrics {
+    uint64_t msgs_in, msgs_handled, in_queue;
+    uint64_t events_out, events_polled, out_queue;
+    uint64_t orders, cancels, modifies, mass_cancels;
+    uint64_t acks, rejects, fills, filled_qty;
+    uint64_t throttled;        /* messages refused by flow control */
+    uint64_t conflated;        /* market data conflated or dropped */
+    uint64_t resting_orders, books;
+};
+void tcx_metrics(tcx_engine e, struct tcx_engine_metrics* out);
+/* resting orders of one book */
+uint32_t tcx_book_orders(tcx_engine e, uint32_t symbolId);
+/* segment name, or "" if the registry could not be shared */
+const char* tcx_metrics_shm(tcx_engine e);
+
+/* Flight recorder: the last few thousand inbound messages, fills, book
+   changes and events of every thread using the engine, dumped to a binary
+   file (decode with tce_flight). tcx_flight_dump writes to `path`, or to a
+   new file in the dump directory if path is NULL, and copies the file name
+   into name[cap] if given; 0 on success. */
+int  tcx_flight_dump(tcx_engine e, const char* path, char* name, int cap);
+/* default $TMPDIR or /tmp */
+void tcx_flight_set_dir(tcx_engine e, const char* dir);
+/* dump when one message takes longer than thresholdUs to handle (at most
+   once a second); 0 turns it off */
+void tcx_flight_latency_dump(tcx_engine e, int64_t thresholdUs);
+/* every engine in the process dumps on signal `sig` (0: SIGUSR2); 0 on success */
+int  tcx_flight_signal(int sig);
 
+/* Aggregated price levels (at most 10 per side) from the book's last
+   published snapshot; never blocks the matching thread. */
 int tcx_depth(tcx_engine         h,
               const char*        symbol,
               int                levels,
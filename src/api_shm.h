@@ -0,0 +1,30 @@
+#pragma once
+
+#include "api_c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Out-of-process access to an engine served over shared memory (see
+   tce_shm_server). Link against tcx_client instead of tce_core; the handle
+   returned here works with the message-path calls of api_c.h:
+
+     tcx_destroy_engine (disconnects), tcx_order_*, tcx_submit, tcx_cancel,
+     tcx_modify, tcx_await_ack, tcx_shard_of, tcx_symbol_id, tcx_symbol_name,
+     tcx_send, tcx_mass_cancel, tcx_auction_start, tcx_auction_uncross,
+     tcx_l3_snapshot, tcx_poll, tcx_next_event, tcx_reject_text,
+     tcx_credits (the session argument is ignored)
+
+   The connection is bound to `account`: orders and mass cancels are stamped
+   with it whatever the caller sets. Events are broadcast, so tcx_next_event
+   also returns other clients' acks and fills. Returns NULL if no engine
+   serves `name` or it has no free slot. */
+tcx_engine tcx_shm_connect(const char* name, uint32_t account, int cancelOnDisconnect);
+
+/* events dropped because this client fell a whole ring behind */
+uint64_t   tcx_shm_lost(tcx_engine e);
+
+#ifdef __cplusplus
+}   /* extern "C" */
+#endif
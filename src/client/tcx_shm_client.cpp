@@ -0,0 +1,154 @@
+// The tcx_* message-path calls of api_c.h implemented over ShmClient, built
+// into tcx_client for processes that talk to an engine in another process.
+#include "api_shm.h"
+#include "ShmClient.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+struct CShm {
+    std::unique_ptr<ShmClient> client;
+    std::vector<OutboundMsg> buf;
+    std::size_t head = 0;
+};
+
+static ShmClient& clientOf(tcx_engine h) { return *((CShm*)h)->client; }
+
+tcx_engine tcx_shm_connect(const char* name, uint32_t account, int cancelOnDisconnect)
+{
+    auto c = ShmClient::connect(name ? name : "", account, cancelOnDisconnect != 0);
+    if (!c) return nullptr;
+    auto* h = new CShm();
+    h->client = std::move(c);
+    return h;
+}
+void     tcx_destroy_engine(tcx_engine h) { delete (CShm*)h; }
+uint64_t tcx_shm_lost(tcx_engine h)       { return clientOf(h).lost(); }
+
+tcx_order tcx_order_new(const char* sym, tcx_side sd, tcx_type tp, double px, int qty)
+{
+    return new std::shared_ptr<Order>(std::make_shared<Order>(
+        sym ? sym : "",
+        sd==TCX_BUY ? OrderSide::BUY : OrderSide::SELL,
+        tp==TCX_LIMIT ? OrderType::LIMIT :
+        tp==TCX_MARKET? OrderType::MARKET : OrderType::STOP,
+        px, qty));
+}
+void tcx_order_free(tcx_order p) { delete (std::shared_ptr<Order>*)p; }
+void tcx_order_set_account(tcx_order, uint32_t) {}   // the connection's account applies
+void tcx_order_set_client_id(tcx_order p, uint64_t clientId)
+{
+    (*(std::shared_ptr<Order>*)p)->setClientId(clientId);
+}
+
+uint32_t tcx_symbol_id(tcx_engine h, const char* sym)
+{
+    return sym ? clientOf(h).symbolId(sym) : 0;
+}
+const char* tcx_symbol_name(tcx_engine h, uint32_t id) { return clientOf(h).symbolName(id); }
+
+uint64_t tcx_submit(tcx_engine h, tcx_order o)
+{
+    auto& ord = **(std::shared_ptr<Order>*)o;
+    SymbolId sym = clientOf(h).symbolId(ord.getSymbol());
+    std::uint64_t id = clientOf(h).send(InboundMsg::newOrder(sym, ord));
+    ord.setClientId(id);
+    return id;
+}
+int tcx_cancel(tcx_engine h, int64_t id)
+{
+    clientOf(h).send(InboundMsg::cancel(id));
+    return 0;
+}
+int tcx_modify(tcx_engine h, int64_t id, double px, int qty)
+{
+    std::optional<PxTicks> npx = (px  >0) ? std::optional<PxTicks>(toTicks(px)) : std::nullopt;
+    std::optional<int>     nqt = (qty >0) ? std::optional<int>(qty)            : std::nullopt;
+    clientOf(h).send(InboundMsg::modify(id, npx, nqt));
+    return 0;
+}
+
+uint64_t tcx_send(tcx_engine h, const tcx_msg* msg)
+{
+    InboundMsg m;
+    std::memcpy(&m, msg, sizeof(m));
+    return clientOf(h).send(m);
+}
+
+int64_t tcx_await_ack(tcx_engine h, uint64_t clientId, int timeoutMs)
+{
+    auto* c = (CShm*)h;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::size_t seen = c->head;
+    for (;;) {
+        OutboundMsg ev;
+        while (c->client->next(ev)) c->buf.push_back(ev);
+        for (; seen < c->buf.size(); ++seen) {
+            const auto& e = c->buf[seen];
+            if (e.type == OutboundType::ACK && e.ack.clientId == clientId)
+                return e.ack.orderId;
+            if (e.type == OutboundType::REJECT && e.reject.clientId == clientId &&
+                e.reject.orderId == NO_ORDER)
+                return -1;
+        }
+        if (std::chrono::steady_clock::now() >= deadline || !c->client->connected()) return -1;
+        std::this_thread::yield();
+    }
+}
+
+int tcx_shard_of(int64_t orderId) { return shardOf(orderId); }
+
+int tcx_mass_cancel(tcx_engine h, uint32_t account, uint32_t symbolId, int side)
+{
+    std::optional<OrderSide> sd;
+    if (side == TCX_BUY)  sd = OrderSide::BUY;
+    if (side == TCX_SELL) sd = OrderSide::SELL;
+    clientOf(h).send(InboundMsg::massCancel(account, symbolId, sd));
+    return 0;
+}
+
+int tcx_auction_start(tcx_engine h, uint32_t symbolId)
+{
+    clientOf(h).send(InboundMsg::auctionStart(symbolId));
+    return 0;
+}
+int tcx_auction_uncross(tcx_engine h, uint32_t symbolId, int resumeContinuous)
+{
+    clientOf(h).send(InboundMsg::auctionUncross(symbolId, resumeContinuous != 0));
+    return 0;
+}
+
+uint64_t tcx_l3_snapshot(tcx_engine h, uint32_t symbolId)
+{
+    return clientOf(h).send(InboundMsg::bookSnapshot(symbolId));
+}
+
+int64_t tcx_credits(tcx_engine h, uint32_t)
+{
+    return static_cast<int64_t>(clientOf(h).credits());
+}
+
+const char* tcx_reject_text(int reason)
+{
+    return toString(static_cast<RejectReason>(reason));
+}
+
+void tcx_poll(tcx_engine h)
+{
+    auto* c = (CShm*)h;
+    if (c->head == c->buf.size()) { c->buf.clear(); c->head = 0; }
+    OutboundMsg ev;
+    while (c->client->next(ev)) c->buf.push_back(ev);
+}
+
+int tcx_next_event(tcx_engine h, tcx_evt* out)
+{
+    auto* c = (CShm*)h;
+    if (c->head == c->buf.size()) return 0;
+    std::memcpy(out, &c->buf[c->head++], sizeof(*out));
+    return 1;
+}
@@ -0,0 +1,394 @@
+#include "OrderGateway.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::uint64_t TCP_LISTENER  = ~std::uint64_t{0};
+constexpr std::uint64_t UNIX_LISTENER = ~std::uint64_t{0} - 1;
+constexpr int  MAX_EVENTS  = 64;
+constexpr auto ACTIVE_SPIN = std::chrono::milliseconds(2);   // keep polling this long after traffic
+
+// Replies are routed back by the connection's tag, stored above the
+// client's 48 bits. Tags rotate through 1..0xFFFF instead of naming the slot,
+// so replies still in flight for a closed connection never reach the next
+// one on the same slot.
+std::uint64_t tagClientId(std::uint16_t tag, std::uint64_t clientId) noexcept
+{
+    return (std::uint64_t{tag} << 48) | (clientId & WIRE_CLIENT_ID_MASK);
+}
+}
+
+std::unique_ptr<OrderGateway> OrderGateway::open(EngineRunner& runner, const GatewayConfig& cfg)
+{
+    std::unique_ptr<OrderGateway> gw(new OrderGateway(runner, cfg));
+    if (!gw->listen(cfg)) return nullptr;
+    gw->thread_ = std::thread([gw = gw.get(), t = cfg.thread]{
+        applyThreadConfig(t);
+        gw->loop();
+    });
+    return gw;
+}
+
+OrderGateway::OrderGateway(EngineRunner& runner, const GatewayConfig& cfg)
+    : runner_(runner), maxConns_(static_cast<std::uint32_t>(std::max(cfg.maxConnections, 0))),
+      busyPoll_(cfg.thread.busyPoll), tagSlot_(0x10000, 0)
+{
+    conns_.reserve(maxConns_);
+    dirty_.reserve(maxConns_);
+    batch_.reserve(RX_BYTES / WIRE_FRAME);
+    batchFrom_.reserve(RX_BYTES / WIRE_FRAME);
+}
+
+OrderGateway::~OrderGateway()
+{
+    running_.store(false);
+    if (thread_.joinable()) thread_.join();
+    for (std::uint32_t s = 0; s < conns_.size(); ++s) close(s);
+    if (tcpFd_  >= 0) ::close(tcpFd_);
+    if (unixFd_ >= 0) { ::close(unixFd_); ::unlink(unixPath_.c_str()); }
+    if (epfd_   >= 0) ::close(epfd_);
+}
+
+bool OrderGateway::listen(const GatewayConfig& cfg)
+{
+    epfd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd_ < 0 || cfg.maxConnections <= 0 || cfg.maxConnections > 0xFFFF) return false;
+
+    if (cfg.tcpPort >= 0) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port   = htons(static_cast<std::uint16_t>(cfg.tcpPort));
+        if (inet_pton(AF_INET, cfg.tcpHost.c_str(), &addr.sin_addr) != 1) return false;
+
+        tcpFd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        setsockopt(tcpFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        socklen_t len = sizeof(addr);
+        if (tcpFd_ < 0 || bind(tcpFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(tcpFd_, SOMAXCONN) != 0 ||
+            getsockname(tcpFd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0)
+            return false;
+        tcpPort_ = ntohs(addr.sin_port);
+
+        epoll_event ev{};
+        ev.events   = EPOLLIN;
+        ev.data.u64 = TCP_LISTENER;
+        if (epoll_ctl(epfd_, EPOLL_CTL_ADD, tcpFd_, &ev) != 0) return false;
+    }
+
+    if (!cfg.unixPath.empty()) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (cfg.unixPath.size() >= sizeof(addr.sun_path)) return false;
+        std::memcpy(addr.sun_path, cfg.unixPath.c_str(), cfg.unixPath.size());
+
+        ::unlink(cfg.unixPath.c_str());
+        unixFd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (unixFd_ < 0 || bind(unixFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(unixFd_, SOMAXCONN) != 0)
+            return false;
+        unixPath_ = cfg.unixPath;
+
+        epoll_event ev{};
+        ev.events   = EPOLLIN;
+        ev.data.u64 = UNIX_LISTENER;
+        if (epoll_ctl(epfd_, EPOLL_CTL_ADD, unixFd_, &ev) != 0) return false;
+    }
+    return tcpFd_ >= 0 || unixFd_ >= 0;
+}
+
+void OrderGateway::loop()
+{
+    epoll_event evs[MAX_EVENTS];
+    auto lastActive = std::chrono::steady_clock::now();
+
+    while (running_.load(std::memory_order_relaxed)) {
+        // right after traffic the replies are microseconds away: don't sleep
+        bool recent = std::chrono::steady_clock::now() - lastActive < ACTIVE_SPIN;
+        int n = epoll_wait(epfd_, evs, MAX_EVENTS, (busyPoll_ || recent) ? 0 : 1);
+        bool busy = n > 0;
+
+        for (int i = 0; i < n; ++i) {
+            const std::uint64_t tag = evs[i].data.u64;
+            if (tag == TCP_LISTENER)  { accept(tcpFd_);  continue; }
+            if (tag == UNIX_LISTENER) { accept(unixFd_); continue; }
+
+            auto slot = static_cast<std::uint32_t>(tag);
+            if (evs[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) read(slot);
+            if ((evs[i].events & EPOLLOUT) && conns_[slot]->fd >= 0) flush(slot);
+        }
+
+        submitBatch();
+
+        OutboundMsg ev;
+        while (runner_.poll(ev)) {
+            route(ev);
+            busy = true;
+        }
+        for (std::uint32_t s : dirty_) flush(s);
+        dirty_.clear();
+
+        if (busy) lastActive = std::chrono::steady_clock::now();
+        else if (busyPoll_) cpuRelax();
+        else if (recent) std::this_thread::yield();
+    }
+}
+
+void OrderGateway::accept(int listenFd)
+{
+    for (;;) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (open_.load() >= maxConns_) { ::close(fd); continue; }
+        if (listenFd == tcpFd_) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        std::uint32_t slot;
+        if (!freeSlots_.empty()) { slot = freeSlots_.back(); freeSlots_.pop_back(); }
+        else {
+            slot = static_cast<std::uint32_t>(conns_.size());
+            conns_.push_back(std::make_unique<Conn>());
+        }
+        Conn& c = *conns_[slot];
+        c.fd = fd;
+        // at most 0xFFFE other connections are open, so a free tag exists
+        std::uint32_t inUse;
+        do { if (++lastTag_ == 0) lastTag_ = 1; } while (routeTo(lastTag_, inUse));
+        c.tag = lastTag_;
+        tagSlot_[c.tag] = slot;
+
+        epoll_event ev{};
+        ev.events   = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = slot;
+        if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            ::close(fd);
+            c.fd  = -1;
+            c.tag = 0;
+            freeSlots_.push_back(slot);
+            continue;
+        }
+        ++open_;
+    }
+}
+
+void OrderGateway::read(std::uint32_t slot)
+{
+    Conn& c = *conns_[slot];
+    while (c.fd >= 0) {
+        const std::size_t room = RX_BYTES - c.rxLen;
+        ssize_t got = recv(c.fd, c.rx + c.rxLen, room, 0);
+        if (got == 0) { close(slot); return; }
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) close(slot);
+            return;
+        }
+        c.rxLen += static_cast<std::size_t>(got);
+
+        // parse whole frames where they landed; a partial one moves to the front
+        std::size_t off = 0;
+        for (; c.rxLen - off >= WIRE_FRAME; off += WIRE_FRAME)
+            if (!handleFrame(slot, c.rx + off)) { close(slot); return; }
+        if (off) {
+            std::memmove(c.rx, c.rx + off, c.rxLen - off);
+            c.rxLen -= off;
+        }
+        if (static_cast<std::size_t>(got) < room) return;
+    }
+}
+
+bool OrderGateway::handleFrame(std::uint32_t slot, const unsigned char* frame)
+{
+    Conn& c = *conns_[slot];
+    const std::uint8_t type = frame[0];
+
+    if (type == WIRE_LOGON) {
+        if (c.loggedOn) return false;
+        WireLogon logon;
+        std::memcpy(&logon, frame, sizeof(logon));
+        c.account  = logon.account;
+        c.session  = runner_.openSession(logon.account, logon.cancelOnDisconnect != 0);
+        c.loggedOn = true;
+        enqueue(slot, &logon);
+        return c.fd >= 0;
+    }
+    if (!c.loggedOn) return false;
+
+    if (type == WIRE_SYMBOL) {
+        WireSymbol sym;
+        std::memcpy(&sym, frame, sizeof(sym));
+        sym.name[sizeof(sym.name) - 1] = '\0';
+        sym.symbolId = runner_.engine().symbols().intern(sym.name);
+        enqueue(slot, &sym);
+        return c.fd >= 0;
+    }
+    // auctions are run by the venue, not by its clients
+    if (type > static_cast<std::uint8_t>(InboundType::BOOK_SNAPSHOT) ||
+        type == static_cast<std::uint8_t>(InboundType::AUCTION_START) ||
+        type == static_cast<std::uint8_t>(InboundType::AUCTION_UNCROSS)) return false;
+
+    InboundMsg& m = batch_.emplace_back();
+    batchFrom_.push_back(c.session);
+    std::memcpy(&m, frame, sizeof(m));
+    m.account = c.account;
+    if (m.type == InboundType::CANCEL || m.type == InboundType::MODIFY) m.flags |= IN_OWNER;
+    m.clientId = tagClientId(c.tag, m.clientId);
+    return true;
+}
+
+// One push per run of a session's requests; what exceeds its credits comes
+// back to the client as THROTTLED rejects.
+void OrderGateway::submitBatch()
+{
+    for (std::size_t i = 0, j; i < batch_.size(); i = j) {
+        for (j = i + 1; j < batch_.size() && batchFrom_[j] == batchFrom_[i]; ++j) {}
+        runner_.push(batch_.data() + i, j - i, batchFrom_[i]);
+    }
+    batch_.clear();
+    batchFrom_.clear();
+}
+
+void OrderGateway::route(const OutboundMsg& ev)
+{
+    auto live = [this](std::uint32_t s){ return conns_[s]->fd >= 0 && conns_[s]->loggedOn; };
+
+    switch (ev.type) {
+    case OutboundType::ACK:
+    case OutboundType::REJECT: {
+        OutboundMsg out = ev;
+        std::uint64_t& cid = ev.type == OutboundType::ACK ? out.ack.clientId : out.reject.clientId;
+        std::uint32_t slot;
+        if (!routeTo(cid >> 48, slot) || !live(slot)) return;
+        cid &= WIRE_CLIENT_ID_MASK;
+        enqueue(slot, &out);
+        return;
+    }
+    case OutboundType::MASS_CANCEL:
+        for (std::uint32_t s = 0; s < conns_.size(); ++s)
+            if (live(s) && conns_[s]->account == ev.massCancel.account) enqueue(s, &ev);
+        return;
+    case OutboundType::L3:
+        if (ev.l3.kind >= L3Kind::SNAPSHOT_BEGIN) {
+            // a snapshot goes only to the connection that asked for it
+            OutboundMsg out = ev;
+            std::uint32_t slot;
+            if (!routeTo(out.l3.clientId >> 48, slot) || !live(slot)) return;
+            out.l3.clientId &= WIRE_CLIENT_ID_MASK;
+            enqueue(slot, &out);
+            return;
+        }
+        [[fallthrough]];
+    case OutboundType::TRADE:
+    case OutboundType::TOB:
+    case OutboundType::BAR:
+        for (std::uint32_t s = 0; s < conns_.size(); ++s)
+            if (live(s)) enqueue(s, &ev);
+        return;
+    }
+}
+
+void OrderGateway::enqueue(std::uint32_t slot, const void* frame)
+{
+    Conn& c = *conns_[slot];
+    if (c.txTail - c.txHead == TX_FRAMES) {
+        // a burst can fill the queue of a client that reads promptly: hand
+        // it to the socket, and give up only if the client is not reading
+        const bool listed = c.dirty;
+        flush(slot);
+        if (c.fd < 0) return;
+        c.dirty = listed;
+        if (c.txTail - c.txHead == TX_FRAMES) { close(slot); return; }
+    }
+    std::memcpy(&c.tx[c.txTail++ % TX_FRAMES], frame, WIRE_FRAME);
+    if (!c.dirty) {
+        c.dirty = true;
+        dirty_.push_back(slot);
+    }
+}
+
+void OrderGateway::flush(std::uint32_t slot)
+{
+    Conn& c = *conns_[slot];
+    c.dirty = false;
+    auto* base = reinterpret_cast<char*>(c.tx);
+
+    while (c.fd >= 0 && c.txHead != c.txTail) {
+        // the queue is a ring: at most two runs of frames, one sendmsg
+        const std::size_t h = c.txHead % TX_FRAMES, t = c.txTail % TX_FRAMES;
+        iovec iov[2];
+        std::size_t n = 0;
+        const std::size_t firstEnd = h < t ? t : TX_FRAMES;
+        iov[n++] = {base + h * WIRE_FRAME + c.txOff, (firstEnd - h) * WIRE_FRAME - c.txOff};
+        if (h >= t && t > 0) iov[n++] = {base, t * WIRE_FRAME};
+        const std::size_t want = iov[0].iov_len + (n > 1 ? iov[1].iov_len : 0);
+
+        msghdr msg{};
+        msg.msg_iov    = iov;
+        msg.msg_iovlen = n;
+        ssize_t sent = sendmsg(c.fd, &msg, MSG_NOSIGNAL);   // writev without SIGPIPE
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) { close(slot); return; }
+            sent = 0;
+        }
+        const std::size_t done = c.txOff + static_cast<std::size_t>(sent);
+        c.txHead += done / WIRE_FRAME;
+        c.txOff   = done % WIRE_FRAME;
+        if (static_cast<std::size_t>(sent) < want) break;
+    }
+    if (c.fd < 0) return;
+
+    // arm EPOLLOUT only while the socket is backed up
+    const bool backlog = c.txHead != c.txTail;
+    if (backlog != c.wantWrite) {
+        epoll_event ev{};
+        ev.events   = EPOLLIN | EPOLLRDHUP;
+        if (backlog) ev.events |= EPOLLOUT;
+        ev.data.u64 = slot;
+        epoll_ctl(epfd_, EPOLL_CTL_MOD, c.fd, &ev);
+        c.wantWrite = backlog;
+    }
+}
+
+// The open connection carrying `tag`, if any.
+bool OrderGateway::routeTo(std::uint64_t tag, std::uint32_t& slot) const noexcept
+{
+    if (tag == 0 || tag >= tagSlot_.size()) return false;
+    slot = tagSlot_[tag];
+    return slot < conns_.size() && conns_[slot]->tag == tag;
+}
+
+void OrderGateway::close(std::uint32_t slot)
+{
+    Conn& c = *conns_[slot];
+    if (c.fd < 0) return;
+    epoll_ctl(epfd_, EPOLL_CTL_DEL, c.fd, nullptr);
+    ::close(c.fd);
+    c.fd  = -1;
+    c.tag = 0;
+    if (c.loggedOn) {
+        // requests already parsed go in ahead of any cancel-on-disconnect
+        submitBatch();
+        runner_.closeSession(c.session);
+    }
+    c.loggedOn  = false;
+    c.dirty     = false;
+    c.wantWrite = false;
+    c.rxLen     = 0;
+    c.txHead = c.txTail = 0;
+    c.txOff     = 0;
+    freeSlots_.push_back(slot);
+    --open_;
+}
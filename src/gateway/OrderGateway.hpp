@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EngineRunner.hpp"
+#include "ThreadConfig.hpp"
+#include "WireProtocol.hpp"
+
+struct GatewayConfig {
+    std::string tcpHost = "127.0.0.1";
+    int         tcpPort = -1;          // -1 = no TCP listener, 0 = any free port
+    std::string unixPath;              // empty = no Unix-domain listener
+    int         maxConnections = 256;
+    ThreadConfig thread;               // busyPoll: never sleep in epoll_wait
+};
+
+// Binary order entry over TCP and/or Unix-domain sockets (see
+// WireProtocol.hpp). One thread runs an epoll loop: complete frames are
+// parsed in place from each connection's receive buffer, every pass hands
+// the requests to the runner as one batch, and the replies queued for a
+// connection during the pass go out in one writev. Like ShmGateway it must
+// be the runner's only consumer.
+//
+// A connection whose send queue is still full after a flush (a client that
+// stops reading) or that sends a malformed frame is dropped; its session is
+// closed.
+class OrderGateway {
+public:
+    static constexpr std::size_t TX_FRAMES = 1024;      // send queue per connection
+    // nullptr if no listener could be set up.
+    static std::unique_ptr<OrderGateway> open(EngineRunner &runner, const GatewayConfig &cfg);
+    ~OrderGateway();
+
+    OrderGateway(const OrderGateway &) = delete;
+    OrderGateway &operator=(const OrderGateway &) = delete;
+
+    int tcpPort() const noexcept { return tcpPort_; }      // as bound, -1 if none
+    std::uint32_t connections() const noexcept { return open_.load(); }
+
+private:
+    static constexpr std::size_t RX_BYTES  = 64 * 1024;
+
+    struct Conn {
+        int fd = -1;
+        bool loggedOn = false;
+        bool dirty = false;                 // has queued replies to flush
+        bool wantWrite = false;             // EPOLLOUT armed
+        std::uint16_t tag = 0;              // routing tag of this connection, 0 when closed
+        AccountId account = 0;
+        SessionId session = 0;
+        std::size_t rxLen = 0;
+        std::uint64_t txHead = 0, txTail = 0;   // frames
+        std::size_t txOff = 0;                  // bytes of tx[txHead] already sent
+        alignas(64) unsigned char rx[RX_BYTES];
+        OutboundMsg tx[TX_FRAMES];
+    };
+
+    OrderGateway(EngineRunner &runner, const GatewayConfig &cfg);
+    bool listen(const GatewayConfig &cfg);
+
+    void loop();
+    void accept(int listenFd);
+    void read(std::uint32_t slot);
+    bool handleFrame(std::uint32_t slot, const unsigned char *frame);
+    void route(const OutboundMsg &ev);
+    bool routeTo(std::uint64_t tag, std::uint32_t &slot) const noexcept;
+    void enqueue(std::uint32_t slot, const void *frame);
+    void flush(std::uint32_t slot);
+    void close(std::uint32_t slot);
+    void submitBatch();
+
+    EngineRunner &runner_;
+    int epfd_ = -1;
+    int tcpFd_ = -1, unixFd_ = -1;
+    int tcpPort_ = -1;
+    std::string unixPath_;
+    std::uint32_t maxConns_;
+    bool busyPoll_;
+
+    std::vector<std::unique_ptr<Conn>> conns_;   // index = slot
+    std::vector<std::uint32_t> freeSlots_;
+    std::vector<std::uint32_t> tagSlot_;        // routing tag -> slot
+    std::uint16_t lastTag_ = 0;
+    std::vector<std::uint32_t> dirty_;
+    std::vector<InboundMsg> batch_;
+    std::vector<SessionId> batchFrom_;          // session of each batch_ entry
+    std::atomic<std::uint32_t> open_{0};
+
+    std::thread thread_;
+    std::atomic<bool> running_{true};
+};
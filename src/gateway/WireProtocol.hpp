@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "Messages.hpp"
+
+// Order-entry wire format. Every frame is 64 bytes in host byte order, so a
+// frame is parsed by copying it out of the receive buffer as-is.
+//
+//   client → gateway   InboundMsg (tcx_msg), WireLogon, WireSymbol
+//   gateway → client   OutboundMsg (tcx_evt), WireLogon, WireSymbol
+//
+// A connection must log on before anything else and is then bound to that
+// account: every request is stamped with it, cancels and modifies only reach
+// the account's own orders, and auction frames close the connection (the
+// venue runs auctions, not its clients). Client ids are the client's own
+// (low 48 bits; the gateway uses the rest for routing) and come back on
+// acks, rejects and L3 snapshots. Trades, top-of-book, bars and L3
+// incrementals go to every connection.
+// The first byte of a frame is its type; session frames use the range
+// above every InboundType / OutboundType.
+enum WireType : std::uint8_t {
+    WIRE_LOGON  = 0x40,
+    WIRE_SYMBOL = 0x41
+};
+
+constexpr std::size_t WIRE_FRAME = 64;
+constexpr std::uint64_t WIRE_CLIENT_ID_MASK = (std::uint64_t{1} << 48) - 1;
+
+// request and echo: the gateway answers with the same frame once logged on
+struct WireLogon {
+    std::uint8_t  type = WIRE_LOGON;
+    std::uint8_t  cancelOnDisconnect = 0;
+    std::uint8_t  pad_[2] = {};
+    AccountId     account = 0;
+    std::uint8_t  reserved_[56] = {};
+};
+
+// request: name; reply: name and its interned id (0 if it cannot be interned)
+struct WireSymbol {
+    std::uint8_t  type = WIRE_SYMBOL;
+    std::uint8_t  pad_[3] = {};
+    SymbolId      symbolId = SymbolTable::NONE;
+    char          name[56] = {};
+};
+
+static_assert(sizeof(WireLogon)  == WIRE_FRAME && std::is_trivially_copyable_v<WireLogon>);
+static_assert(sizeof(WireSymbol) == WIRE_FRAME && std::is_trivially_copyable_v<WireSymbol>);
+static_assert(sizeof(InboundMsg) == WIRE_FRAME && sizeof(OutboundMsg) == WIRE_FRAME);
@@ -0,0 +1,73 @@
+// Binary order-entry gateway in front of an in-process engine.
+//   tce_gateway [--tcp [host:]port] [--unix path] [--busy-poll] [--cpu N]... [--l3]
+//               [--tape dir] [--flight dir] [--slow-us N]
+// --busy-poll spins both the matching and the gateway thread; --cpu pins the
+// matching thread (repeatable); --l3 publishes the order-by-order feed;
+// --tape records fills and quotes under dir. The flight recorder is dumped
+// into --flight dir (default $TMPDIR) on SIGUSR2 and when a message takes
+// longer than --slow-us to handle.
+// Stops on SIGINT / SIGTERM.
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "EngineRunner.hpp"
+#include "OrderGateway.hpp"
+
+static volatile std::sig_atomic_t stopRequested = 0;
+
+int main(int argc, char** argv)
+{
+    GatewayConfig cfg;
+    ThreadConfig matching;
+    bool l3 = false;
+    std::string tape, flight;
+    long slowUs = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--tcp") && i + 1 < argc) {
+            std::string arg = argv[++i];
+            auto colon = arg.rfind(':');
+            if (colon != std::string::npos) cfg.tcpHost = arg.substr(0, colon);
+            cfg.tcpPort = std::atoi(arg.c_str() + (colon == std::string::npos ? 0 : colon + 1));
+        }
+        else if (!std::strcmp(argv[i], "--unix") && i + 1 < argc) cfg.unixPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--busy-poll")) matching.busyPoll = cfg.thread.busyPoll = true;
+        else if (!std::strcmp(argv[i], "--l3")) l3 = true;
+        else if (!std::strcmp(argv[i], "--tape") && i + 1 < argc) tape = argv[++i];
+        else if (!std::strcmp(argv[i], "--flight") && i + 1 < argc) flight = argv[++i];
+        else if (!std::strcmp(argv[i], "--slow-us") && i + 1 < argc) slowUs = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "--cpu") && i + 1 < argc) matching.cpus.push_back(std::atoi(argv[++i]));
+        else {
+            std::fprintf(stderr, "usage: %s [--tcp [host:]port] [--unix path] [--busy-poll] [--cpu N]... [--l3] [--tape dir] [--flight dir] [--slow-us N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (cfg.tcpPort < 0 && cfg.unixPath.empty()) cfg.tcpPort = 9000;
+
+    EngineRunner runner(matching);
+    runner.setL3Feed(l3);
+    if (!flight.empty()) runner.setFlightDumpDir(flight);
+    runner.setLatencyDump(std::chrono::microseconds(slowUs));
+    FlightRecorder::installSignalHandler(SIGUSR2);
+    if (!tape.empty() && !runner.recordTape(tape)) {
+        std::fprintf(stderr, "tce_gateway: cannot record to %s\n", tape.c_str());
+        return 1;
+    }
+    auto gw = OrderGateway::open(runner, cfg);
+    if (!gw) {
+        std::fprintf(stderr, "tce_gateway: cannot listen\n");
+        return 1;
+    }
+    std::signal(SIGINT,  [](int){ stopRequested = 1; });
+    std::signal(SIGTERM, [](int){ stopRequested = 1; });
+    if (gw->tcpPort() >= 0) std::printf("listening on %s:%d\n", cfg.tcpHost.c_str(), gw->tcpPort());
+    if (!cfg.unixPath.empty()) std::printf("listening on %s\n", cfg.unixPath.c_str());
+    if (!runner.metrics().shmName().empty())
+        std::printf("metrics in /dev/shm/%s (tce_top)\n", runner.metrics().shmName().c_str());
+    while (!stopRequested) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return 0;
+}
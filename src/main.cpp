@@ -3,23 +3,44 @@
 #include <QPushButton>
 #include <QLineEdit>
 #include <QLabel>
-#include <QTextEdit>
+#include <QPlainTextEdit>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QTableWidget>
+#include <QTableView>
 #include <QTabWidget>
 #include <QHeaderView>
 #include <QWidget>
 #include <QTimer>
-#include <QTableWidgetItem>
+#include <QSocketNotifier>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QStringList>
 #include <random>
 #include "EngineRunner.hpp"
+#include "ui/MarketModels.hpp"
+
+namespace {
+QTableView* makeTable(QAbstractItemModel* model) {
+    auto* view = new QTableView;
+    view->setModel(model);
+    view->setSelectionBehavior(QAbstractItemView::SelectRows);
+    view->setSelectionMode(QAbstractItemView::SingleSelection);
+    view->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // fixed row heights: the view never measures rows it does not show
+    view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    view->verticalHeader()->setDefaultSectionSize(view->fontMetrics().height() + 4);
+    view->verticalHeader()->hide();
+    return view;
+}
+}
 
 class TradingUI : public QMainWindow {
     Q_OBJECT
 public:
     TradingUI(QWidget* parent = nullptr)
-        : QMainWindow(parent), runner_(), rng_(std::random_device{}()) {
+        : QMainWindow(parent), runner_(), rng_(std::random_device{}()),
+          market_(runner_.engine()), ladder_(runner_.engine()),
+          blotter_(runner_.engine().symbols()) {
         auto* central = new QWidget;
         auto* mainLayout = new QVBoxLayout;
 
@@ -46,24 +67,16 @@ public:
         btnRow->addWidget(orderIdInput_);
 
         tabs_ = new QTabWidget;
-        auto* tobWidget = new QWidget;
-        auto* tobLayout = new QVBoxLayout;
-        tobTable_ = new QTableWidget(0,5);
-        tobTable_->setHorizontalHeaderLabels({"Symbol","BidQty","BidPx","AskQty","AskPx"});
-        tobTable_->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-        tobLayout->addWidget(tobTable_);
-        tobWidget->setLayout(tobLayout);
-        tabs_->addTab(tobWidget, "Top of Book");
-
-        auto* histWidget = new QWidget;
-        auto* histLayout = new QVBoxLayout;
-        historyLog_ = new QTextEdit;
-        historyLog_->setReadOnly(true);
-        QFont monoFont("Courier");
-        historyLog_->setFont(monoFont);
-        histLayout->addWidget(historyLog_);
-        histWidget->setLayout(histLayout);
-        tabs_->addTab(histWidget, "Trade History");
+        marketView_ = makeTable(&market_);
+        tabs_->addTab(marketView_, "Market");
+        tabs_->addTab(makeTable(&ladder_), "Ladder");
+        tabs_->addTab(makeTable(&blotter_), "Blotter");
+
+        messageLog_ = new QPlainTextEdit;
+        messageLog_->setReadOnly(true);
+        messageLog_->setMaximumBlockCount(1000);
+        messageLog_->setFont(QFont("Courier"));
+        tabs_->addTab(messageLog_, "Messages");
 
         mainLayout->addLayout(inputRow);
         mainLayout->addLayout(btnRow);
@@ -76,9 +89,22 @@ public:
         connect(newBtn, &QPushButton::clicked, this, &TradingUI::onNewOrder);
         connect(cancelBtn, &QPushButton::clicked, this, &TradingUI::onCancelOrder);
         connect(modBtn, &QPushButton::clicked, this, &TradingUI::onModifyOrder);
-        auto* timer = new QTimer(this);
-        connect(timer, &QTimer::timeout, this, &TradingUI::processEvents);
-        timer->start(100);
+        connect(marketView_, &QTableView::clicked, this, [this](const QModelIndex& i) {
+            ladder_.setSymbol(market_.symbolAt(i.row()));
+            tabs_->setCurrentIndex(1);
+        });
+        // Sleep until the runner has events rather than polling on a timer.
+        // The first event after a quiet spell is drawn at once, a busy feed
+        // at most once a frame.
+        frame_.start();
+        if (runner_.eventFd() >= 0) {
+            notifier_ = new QSocketNotifier(runner_.eventFd(), QSocketNotifier::Read, this);
+            connect(notifier_, &QSocketNotifier::activated, this, &TradingUI::onEventsReady);
+        } else {
+            auto* timer = new QTimer(this);
+            connect(timer, &QTimer::timeout, this, &TradingUI::processEvents);
+            timer->start(FRAME_MS);
+        }
 
         simulateRandomHistory(100);
     }
@@ -93,70 +119,100 @@ private slots:
         int type = typeInput_->text().toInt(&ok);
         double px = priceInput_->text().toDouble(&ok);
         int qty   = qtyInput_->text().toInt(&ok);
-        runner_.push(NewOrderMsg{ std::make_shared<Order>(sym,
+        Order o(sym,
             side==0?OrderSide::BUY:OrderSide::SELL,
             type==0?OrderType::LIMIT:OrderType::MARKET,
-            px, qty) });
+            px, qty);
+        runner_.push(InboundMsg::newOrder(runner_.engine().symbols().intern(sym), o));
     }
 
     void onCancelOrder() {
-        int id = orderIdInput_->text().toInt();
-        runner_.push(CancelMsg{id});
+        OrderId id = orderIdInput_->text().toLongLong();
+        runner_.push(InboundMsg::cancel(id));
     }
 
     void onModifyOrder() {
-        int id = orderIdInput_->text().toInt();
-        std::optional<double> px;
+        OrderId id = orderIdInput_->text().toLongLong();
+        std::optional<PxTicks> px;
         std::optional<int> qty;
         bool ok;
-        if (!priceInput_->text().isEmpty()) px = priceInput_->text().toDouble(&ok);
+        if (!priceInput_->text().isEmpty()) px = toTicks(priceInput_->text().toDouble(&ok));
         if (!qtyInput_->text().isEmpty())   qty = qtyInput_->text().toInt(&ok);
-        runner_.push(ModifyMsg{id, px, qty});
+        runner_.push(InboundMsg::modify(id, px, qty));
     }
 
+    void onEventsReady() {
+        notifier_->setEnabled(false);
+        const qint64 wait = FRAME_MS - frame_.elapsed();
+        if (wait > 0) QTimer::singleShot(int(wait), this, &TradingUI::processEvents);
+        else processEvents();
+    }
+
+    // One frame: fold queued events into the models for at most DRAIN_MS,
+    // then tell each view once what changed. Whatever is left waits for the
+    // next frame instead of starving the paint.
     void processEvents() {
-        OutboundMsg evt;
-        while (runner_.poll(evt)) {
-            std::visit([&](auto&& e){
-                using T = std::decay_t<decltype(e)>;
-                if constexpr (std::is_same_v<T, TradeEvent>) {
-                    historyLog_->append(QString::fromStdString(
-                        e.fill.symbol + " " + std::to_string(e.fill.qty) +
-                        " @ " + std::to_string(e.fill.price)));
-                } else if constexpr (std::is_same_v<T, TopOfBookEvt>) {
-                    int row = findOrAddRow(e.symbol);
-                    tobTable_->setItem(row, 1, new QTableWidgetItem(QString::number(e.bidQty)));
-                    tobTable_->setItem(row, 2, new QTableWidgetItem(QString::number(e.bidPx)));
-                    tobTable_->setItem(row, 3, new QTableWidgetItem(QString::number(e.askQty)));
-                    tobTable_->setItem(row, 4, new QTableWidgetItem(QString::number(e.askPx)));
-                }
-            }, evt);
+        frame_.restart();
+        const auto& syms = runner_.engine().symbols();
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        QStringList lines;
+        QElapsedTimer budget;
+        budget.start();
+        OutboundMsg e;
+        for (int n = 0; runner_.poll(e); ++n) {
+            switch (e.type) {
+            case OutboundType::TRADE:
+                market_.onTrade(e.symbolId);
+                blotter_.onTrade(e.symbolId, e.trade, now);
+                break;
+            case OutboundType::TOB:
+                market_.onQuote(e.symbolId, e.tob);
+                break;
+            case OutboundType::ACK:
+                lines << QString::fromStdString(
+                    syms.name(e.symbolId) + " accepted as " + std::to_string(e.ack.orderId));
+                break;
+            case OutboundType::REJECT:
+                lines << QString::fromStdString(
+                    "REJECT " + std::to_string(e.reject.orderId) + ": " +
+                    toString(e.reject.reason));
+                break;
+            case OutboundType::BAR:
+                lines << QString("%1 bar  O %2  H %3  L %4  C %5  VWAP %6  vol %7")
+                    .arg(QString::fromStdString(syms.name(e.symbolId)))
+                    .arg(fromTicks(e.bar.open)).arg(fromTicks(e.bar.high))
+                    .arg(fromTicks(e.bar.low)).arg(fromTicks(e.bar.close))
+                    .arg(fromTicks(e.bar.vwap)).arg(e.bar.volume);
+                break;
+            default:
+                break;
+            }
+            if ((n & 255) == 255 && budget.elapsed() >= DRAIN_MS) break;
         }
+        market_.flush();
+        ladder_.flush();
+        blotter_.flush();
+        if (!lines.isEmpty()) messageLog_->appendPlainText(lines.join('\n'));
+        // still readable if the drain budget left events behind
+        if (notifier_) notifier_->setEnabled(true);
     }
 
 private:
-    int findOrAddRow(const std::string& sym) {
-        for (int r=0; r<tobTable_->rowCount(); ++r) {
-            if (tobTable_->item(r,0)->text().toStdString() == sym)
-                return r;
-        }
-        int newRow = tobTable_->rowCount();
-        tobTable_->insertRow(newRow);
-        tobTable_->setItem(newRow,0, new QTableWidgetItem(QString::fromStdString(sym)));
-        return newRow;
-    }
+    static constexpr int FRAME_MS = 16;
+    static constexpr int DRAIN_MS = 8;
 
     void simulateRandomHistory(int n) {
         std::vector<std::string> syms = {"AAPL","MSFT","GOOGL","TSLA","AMZN"};
         std::uniform_int_distribution<int> symd(0, syms.size()-1);
         std::uniform_int_distribution<int> qtd(1, 100);
         std::uniform_real_distribution<double> prd(10.0, 3000.0);
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
         for (int i = 0; i < n; ++i) {
-            auto s = syms[symd(rng_)];
-            int q = qtd(rng_);
-            double p = std::round(prd(rng_)*100)/100;
-            historyLog_->append(QString::fromStdString(s + " " + std::to_string(q) + " @ " + std::to_string(p)));
+            const SymbolId s = runner_.engine().symbols().intern(syms[symd(rng_)]);
+            const TradeEvent t{toTicks(std::round(prd(rng_)*100)/100), 0, 0, qtd(rng_)};
+            blotter_.onTrade(s, t, now - (n - i) * 1000);
         }
+        blotter_.flush();
     }
 
     EngineRunner runner_;
@@ -167,9 +223,14 @@ private:
     QLineEdit* qtyInput_;
     QLineEdit* orderIdInput_;
     QTabWidget* tabs_;
-    QTableWidget* tobTable_;
-    QTextEdit* historyLog_;
+    QTableView* marketView_;
+    QPlainTextEdit* messageLog_;
+    QSocketNotifier* notifier_ = nullptr;
+    QElapsedTimer frame_;
     std::mt19937 rng_;
+    MarketModel market_;
+    LadderModel ladder_;
+    BlotterModel blotter_;
 };
 
 int main(int argc, char** argv) {
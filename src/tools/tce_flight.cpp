@@ -0,0 +1,145 @@
+// Prints a flight-recorder dump (see FlightRecorder.hpp) as one timeline.
+//   tce_flight dump.bin [--last N]
+// Times are relative to the moment of the dump; symbols are shown by id.
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "ExecutionEngine.hpp"
+#include "FlightRecorder.hpp"
+#include "Messages.hpp"
+
+using Kind = FlightRecorder::Kind;
+
+template <class T> static T as(const FlightRecorder::Event& e)
+{
+    T v;
+    std::memcpy(&v, e.body, sizeof v);
+    return v;
+}
+
+static const char* inboundName(unsigned t)
+{
+    static const char* const names[] = {"NEW", "CANCEL", "MODIFY", "MASS_CANCEL",
+                                        "AUCTION_START", "AUCTION_UNCROSS", "BOOK_SNAPSHOT"};
+    return t < sizeof names / sizeof *names ? names[t] : "?";
+}
+
+static const char* reasonName(FlightRecorder::Reason r)
+{
+    switch (r) {
+    case FlightRecorder::Reason::REQUEST:   return "request";
+    case FlightRecorder::Reason::SIGNAL:    return "signal";
+    case FlightRecorder::Reason::LATENCY:   return "latency threshold";
+    case FlightRecorder::Reason::EXCEPTION: return "exception";
+    }
+    return "?";
+}
+
+static void printInbound(const char* what, const InboundMsg& m)
+{
+    std::printf("%-7s %-13s sym %u  px %.4f  qty %d  side %d  order %" PRId64 "  acct %u  client %" PRIu64 "\n",
+                what, inboundName(static_cast<unsigned>(m.type)), m.symbolId, fromTicks(m.px), m.qty,
+                static_cast<int>(m.side), static_cast<std::int64_t>(m.orderId), m.account, m.clientId);
+}
+
+static void printOutbound(const OutboundMsg& m)
+{
+    std::printf("OUT     ");
+    switch (m.type) {
+    case OutboundType::TRADE:
+        std::printf("TRADE  sym %u  %d @ %.4f  buy %" PRId64 "  sell %" PRId64 "\n", m.symbolId,
+                    m.trade.qty, fromTicks(m.trade.px), static_cast<std::int64_t>(m.trade.buyId),
+                    static_cast<std::int64_t>(m.trade.sellId));
+        break;
+    case OutboundType::TOB:
+        std::printf("TOB    sym %u  %d x %.4f / %.4f x %d\n", m.symbolId, m.tob.bidQty,
+                    fromTicks(m.tob.bidPx), fromTicks(m.tob.askPx), m.tob.askQty);
+        break;
+    case OutboundType::REJECT:
+        std::printf("REJECT sym %u  order %" PRId64 "  client %" PRIu64 "  %s\n", m.symbolId,
+                    static_cast<std::int64_t>(m.reject.orderId), m.reject.clientId, toString(m.reject.reason));
+        break;
+    case OutboundType::MASS_CANCEL:
+        std::printf("MASS_CANCEL  acct %u  %d cancelled\n", m.massCancel.account, m.massCancel.count);
+        break;
+    case OutboundType::ACK:
+        std::printf("ACK    sym %u  order %" PRId64 "  client %" PRIu64 "\n", m.symbolId,
+                    static_cast<std::int64_t>(m.ack.orderId), m.ack.clientId);
+        break;
+    case OutboundType::L3:
+        std::printf("L3     sym %u  seq %" PRIu64 "  kind %d  order %" PRId64 "  %d @ %.4f\n", m.symbolId,
+                    m.l3.seq, static_cast<int>(m.l3.kind), static_cast<std::int64_t>(m.l3.orderId),
+                    m.l3.qty, fromTicks(m.l3.px));
+        break;
+    case OutboundType::BAR:
+        std::printf("BAR    sym %u  close %.4f  vol %" PRId64 "\n", m.symbolId, fromTicks(m.bar.close),
+                    m.bar.volume);
+        break;
+    default:
+        std::printf("type %d\n", static_cast<int>(m.type));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = nullptr;
+    std::size_t last = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--last") && i + 1 < argc) last = std::strtoul(argv[++i], nullptr, 10);
+        else path = argv[i];
+    }
+    if (!path) {
+        std::fprintf(stderr, "usage: %s dump.bin [--last N]\n", argv[0]);
+        return 2;
+    }
+    FlightRecorder::Dump d;
+    if (!FlightRecorder::load(path, d)) {
+        std::fprintf(stderr, "tce_flight: %s is not a readable flight-recorder dump\n", path);
+        return 1;
+    }
+
+    std::printf("pid %d, dumped on %s, %zu events\n", d.pid, reasonName(d.reason), d.events.size());
+    for (const auto& [tid, name] : d.threads) std::printf("  thread %u  %s\n", tid, name.c_str());
+    std::printf("\n");
+
+    const std::size_t from = last && last < d.events.size() ? d.events.size() - last : 0;
+    for (std::size_t i = from; i < d.events.size(); ++i) {
+        const FlightRecorder::Event& e = d.events[i];
+        std::printf("%14.3f us  %7u  ", double(e.wallNs - d.wallNs) / 1e3, e.thread);
+        switch (e.kind) {
+        case Kind::ENQUEUE: printInbound("ENQUEUE", as<InboundMsg>(e)); break;
+        case Kind::HANDLE:  printInbound("HANDLE", as<InboundMsg>(e)); break;
+        case Kind::DONE:
+            std::printf("DONE    %-13s %.0f ns\n", inboundName(e.aux),
+                        double(as<std::uint64_t>(e)) / d.ticksPerNs);
+            break;
+        case Kind::FILL: {
+            const auto t = as<ExecutionEngine::Trade>(e);
+            std::printf("FILL    sym %u  %d @ %.4f  buy %" PRId64 "  sell %" PRId64 "\n", t.symbolId,
+                        t.qty, fromTicks(t.price), static_cast<std::int64_t>(t.buyId),
+                        static_cast<std::int64_t>(t.sellId));
+            break;
+        }
+        case Kind::BOOK: {
+            static const char* const changes[] = {"ADD", "MODIFY", "CANCEL", "EXEC"};
+            const auto b = as<ExecutionEngine::BookEvent>(e);
+            std::printf("BOOK    %-6s sym %u  seq %" PRIu64 "  order %" PRId64 "  side %d  %d @ %.4f\n",
+                        changes[static_cast<int>(b.change) & 3], b.symbolId, b.seq,
+                        static_cast<std::int64_t>(b.orderId), static_cast<int>(b.side), b.qty, fromTicks(b.price));
+            break;
+        }
+        case Kind::OUT:  printOutbound(as<OutboundMsg>(e)); break;
+        case Kind::NOTE:
+            std::printf("NOTE    %.*s\n", static_cast<int>(strnlen(reinterpret_cast<const char*>(e.body),
+                                                                        FlightRecorder::BODY)),
+                        reinterpret_cast<const char*>(e.body));
+            break;
+        default:
+            std::printf("kind %d\n", static_cast<int>(e.kind));
+        }
+    }
+    return 0;
+}
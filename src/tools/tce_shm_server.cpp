@@ -0,0 +1,61 @@
+// Runs an engine and serves it to other processes over shared memory.
+//   tce_shm_server [name] [--busy-poll] [--cpu N]... [--l3] [--tape dir]
+//                  [--flight dir] [--slow-us N]
+// --busy-poll spins both the matching and the gateway thread; --cpu pins the
+// matching thread (repeatable); --l3 publishes the order-by-order feed;
+// --tape records fills and quotes under dir. The flight recorder is dumped
+// into --flight dir (default $TMPDIR) on SIGUSR2 and when a message takes
+// longer than --slow-us to handle.
+// Stops on SIGINT / SIGTERM.
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "EngineRunner.hpp"
+#include "ShmGateway.hpp"
+
+static volatile std::sig_atomic_t stopRequested = 0;
+
+int main(int argc, char** argv)
+{
+    std::string name = "tcx";
+    ThreadConfig matching, gateway;
+    bool l3 = false;
+    std::string tape, flight;
+    long slowUs = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--busy-poll")) matching.busyPoll = gateway.busyPoll = true;
+        else if (!std::strcmp(argv[i], "--l3")) l3 = true;
+        else if (!std::strcmp(argv[i], "--tape") && i + 1 < argc) tape = argv[++i];
+        else if (!std::strcmp(argv[i], "--flight") && i + 1 < argc) flight = argv[++i];
+        else if (!std::strcmp(argv[i], "--slow-us") && i + 1 < argc) slowUs = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "--cpu") && i + 1 < argc) matching.cpus.push_back(std::atoi(argv[++i]));
+        else name = argv[i];
+    }
+
+    EngineRunner runner(matching);
+    runner.setL3Feed(l3);
+    if (!flight.empty()) runner.setFlightDumpDir(flight);
+    runner.setLatencyDump(std::chrono::microseconds(slowUs));
+    FlightRecorder::installSignalHandler(SIGUSR2);
+    if (!tape.empty() && !runner.recordTape(tape)) {
+        std::fprintf(stderr, "tce_shm_server: cannot record to %s\n", tape.c_str());
+        return 1;
+    }
+    auto gw = ShmGateway::open(runner, name, gateway);
+    if (!gw) {
+        std::fprintf(stderr, "tce_shm_server: cannot create /dev/shm/%s\n", name.c_str());
+        return 1;
+    }
+    std::signal(SIGINT,  [](int){ stopRequested = 1; });
+    std::signal(SIGTERM, [](int){ stopRequested = 1; });
+    std::printf("serving /dev/shm/%s\n", name.c_str());
+    if (!runner.metrics().shmName().empty())
+        std::printf("metrics in /dev/shm/%s (tce_top)\n", runner.metrics().shmName().c_str());
+    while (!stopRequested) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Live view of a running engine's metrics registry (see Metrics.hpp).
+//   tce_top [segment | pid] [--interval ms] [--once]
+// Without an argument it attaches to the first live /dev/shm/tcx-metrics.*.
+// Shows totals and per-second rates, queue depths and the largest books.
+// Exits when the engine process does, or on SIGINT.
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <signal.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Metrics.hpp"
+
+static volatile std::sig_atomic_t stopRequested = 0;
+
+static bool alive(std::int32_t pid) { return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM); }
+
+static std::vector<std::string> segments(const std::string& prefix)
+{
+    std::vector<std::string> out;
+    if (DIR* d = opendir("/dev/shm")) {
+        while (dirent* e = readdir(d))
+            if (!std::strncmp(e->d_name, prefix.c_str(), prefix.size())) out.push_back(e->d_name);
+        closedir(d);
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+static ShmMapping attach(const std::string& name)
+{
+    ShmMapping m = ShmMapping::open(name, sizeof(MetricsRegion), false);
+    if (!m) return m;
+    const auto* r = static_cast<const MetricsRegion*>(m.data());
+    if (r->magic.load(std::memory_order_acquire) != METRICS_MAGIC ||
+        r->version != METRICS_VERSION || r->metrics != METRIC_COUNT || !alive(r->pid))
+        return {};
+    return m;
+}
+
+static void show(const MetricsRegion& r, const MetricsSnapshot& now,
+                 const MetricsSnapshot& before, double secs, const std::string& name)
+{
+    if (secs > 0) std::printf("\033[H\033[2J");          // redraw in place
+    std::printf("%s  pid %d\n\n", name.c_str(), r.pid);
+    std::printf("  %-16s %14s %12s\n", "", "total", "per sec");
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(Metric::RESTING_ORDERS); ++i) {
+        const Metric m = static_cast<Metric>(i);
+        std::printf("  %-16s %14llu %12.0f\n", metricName(m), (unsigned long long)now[m],
+                    secs > 0 ? double(now[m] - before[m]) / secs : 0.0);
+    }
+    std::printf("\n  %-16s %14llu\n  %-16s %14llu\n  %-16s %14llu\n  %-16s %14llu\n",
+                "in queue",  (unsigned long long)now.inQueue(),
+                "out queue", (unsigned long long)now.outQueue(),
+                "resting",   (unsigned long long)now[Metric::RESTING_ORDERS],
+                "books",     (unsigned long long)now[Metric::BOOKS]);
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> books;   // orders, id
+    const std::uint32_t n = std::min(r.books.load(std::memory_order_acquire), METRICS_BOOKS);
+    for (std::uint32_t i = 1; i < n; ++i)
+        if (std::uint32_t o = r.book[i].orders.load(std::memory_order_relaxed)) books.push_back({o, i});
+    const std::size_t top = std::min<std::size_t>(books.size(), 10);
+    std::partial_sort(books.begin(), books.begin() + top, books.end(),
+                      [](const auto& a, const auto& b){ return a.first > b.first; });
+    std::printf("\n  %-16s %14s\n", "book", "resting");
+    for (std::size_t i = 0; i < top; ++i)
+        std::printf("  %-16.*s %14u\n", int(SHM_SYMBOL_LEN), r.book[books[i].second].name,
+                    books[i].first);
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    std::string target;
+    int intervalMs = 1000;
+    bool once = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--interval") && i + 1 < argc) intervalMs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--once")) once = true;
+        else target = argv[i];
+    }
+
+    std::vector<std::string> names;
+    if (target.empty()) names = segments("tcx-metrics.");
+    else if (target.find_first_not_of("0123456789") == std::string::npos)
+        names = segments("tcx-metrics." + target + ".");
+    else names.push_back(target);
+
+    ShmMapping map;
+    std::string name;
+    for (const auto& n : names)
+        if ((map = attach(n))) { name = n; break; }
+    if (!map) {
+        std::fprintf(stderr, "tce_top: no live engine metrics%s%s\n",
+                     target.empty() ? "" : " for ", target.c_str());
+        return 1;
+    }
+    const auto& r = *static_cast<const MetricsRegion*>(map.data());
+
+    std::signal(SIGINT, [](int){ stopRequested = 1; });
+    MetricsSnapshot before = readMetrics(r);
+    auto t0 = std::chrono::steady_clock::now();
+    if (once) {
+        show(r, before, before, 0, name);
+        return 0;
+    }
+    while (!stopRequested && alive(r.pid)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        const MetricsSnapshot now = readMetrics(r);
+        const auto t1 = std::chrono::steady_clock::now();
+        show(r, now, before, std::chrono::duration<double>(t1 - t0).count(), name);
+        before = now;
+        t0 = t1;
+    }
+    return 0;
+}
@@ -0,0 +1,244 @@
+#include "MarketModels.hpp"
+
+#include <QDateTime>
+#include <algorithm>
+
+#include "ExecutionEngine.hpp"
+
+namespace {
+QVariant alignRight() { return QVariant(int(Qt::AlignRight | Qt::AlignVCenter)); }
+QVariant price(PxTicks px) { return px ? QVariant(fromTicks(px)) : QVariant(); }
+}
+
+// ────────── MarketModel ──────────────────────────────────────────────────
+MarketModel::MarketModel(const ExecutionEngine& engine, QObject* parent)
+    : QAbstractTableModel(parent), engine_(engine)
+{
+    rowOf_.reserve(256);
+}
+
+int MarketModel::rowCount(const QModelIndex& parent) const { return parent.isValid() ? 0 : shown_; }
+int MarketModel::columnCount(const QModelIndex& parent) const { return parent.isValid() ? 0 : COLUMNS; }
+
+QVariant MarketModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= shown_) return {};
+    if (role == Qt::TextAlignmentRole)
+        return index.column() == SYMBOL ? QVariant() : alignRight();
+    if (role != Qt::DisplayRole) return {};
+
+    const Row& r = rows_[index.row()];
+    switch (index.column()) {
+    case SYMBOL:  return QString::fromStdString(engine_.symbols().name(r.sym));
+    case BID_QTY: return r.tob.bidQty ? QVariant(r.tob.bidQty) : QVariant();
+    case BID_PX:  return price(r.tob.bidPx);
+    case ASK_QTY: return r.tob.askQty ? QVariant(r.tob.askQty) : QVariant();
+    case ASK_PX:  return price(r.tob.askPx);
+    case LAST:    return r.trades ? price(r.last) : QVariant();
+    case VWAP:    return r.trades ? price(r.vwap) : QVariant();
+    case VOLUME:  return r.volume;
+    case TRADES:  return r.trades;
+    }
+    return {};
+}
+
+QVariant MarketModel::headerData(int section, Qt::Orientation o, int role) const
+{
+    static const char* const names[COLUMNS] =
+        {"Symbol", "BidQty", "BidPx", "AskQty", "AskPx", "Last", "VWAP", "Volume", "Trades"};
+    if (o != Qt::Horizontal || role != Qt::DisplayRole || section < 0 || section >= COLUMNS)
+        return QAbstractTableModel::headerData(section, o, role);
+    return QString(names[section]);
+}
+
+int MarketModel::rowFor(SymbolId sym)
+{
+    auto it = rowOf_.constFind(sym);
+    if (it != rowOf_.constEnd()) return *it;
+    rows_.push_back({sym, {}, 0, 0, 0, 0, false});
+    const int row = static_cast<int>(rows_.size()) - 1;
+    rowOf_.insert(sym, row);
+    return row;
+}
+
+void MarketModel::touch(int row)
+{
+    if (row >= shown_) return;          // announced as inserted on flush
+    dirtyFirst_ = dirtyFirst_ < 0 ? row : std::min(dirtyFirst_, row);
+    dirtyLast_  = std::max(dirtyLast_, row);
+}
+
+void MarketModel::onQuote(SymbolId sym, const TopOfBookEvt& tob)
+{
+    const int row = rowFor(sym);
+    rows_[row].tob = tob;
+    touch(row);
+}
+
+void MarketModel::onTrade(SymbolId sym)
+{
+    Row& r = rows_[rowFor(sym)];
+    if (r.traded) return;
+    r.traded = true;
+    traded_.push_back(sym);
+}
+
+void MarketModel::flush()
+{
+    // the engine keeps the running stats; read each traded symbol once
+    TradeStats::Summary s;
+    for (SymbolId sym : traded_) {
+        const int row = rowOf_.value(sym);
+        Row& r = rows_[row];
+        r.traded = false;
+        if (!engine_.stats().summary(sym, s)) continue;
+        r.last   = s.last;
+        r.vwap   = s.vwap();
+        r.volume = s.volume;
+        r.trades = static_cast<long long>(s.trades);
+        touch(row);
+    }
+    traded_.clear();
+
+    if (static_cast<int>(rows_.size()) > shown_) {
+        beginInsertRows({}, shown_, static_cast<int>(rows_.size()) - 1);
+        shown_ = static_cast<int>(rows_.size());
+        endInsertRows();
+    }
+    if (dirtyFirst_ >= 0) {
+        emit dataChanged(index(dirtyFirst_, 0), index(dirtyLast_, COLUMNS - 1));
+        dirtyFirst_ = dirtyLast_ = -1;
+    }
+}
+
+SymbolId MarketModel::symbolAt(int row) const
+{
+    return row >= 0 && row < shown_ ? rows_[row].sym : SymbolTable::NONE;
+}
+
+// ────────── LadderModel ──────────────────────────────────────────────────
+LadderModel::LadderModel(ExecutionEngine& engine, QObject* parent)
+    : QAbstractTableModel(parent), engine_(engine) {}
+
+int LadderModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : 2 * BookSnapshot::DEPTH;
+}
+int LadderModel::columnCount(const QModelIndex& parent) const { return parent.isValid() ? 0 : COLUMNS; }
+
+QVariant LadderModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) return {};
+    if (role == Qt::TextAlignmentRole)
+        return index.column() == PRICE ? QVariant(int(Qt::AlignCenter)) : alignRight();
+    if (role != Qt::DisplayRole) return {};
+
+    // rows 0..DEPTH-1: asks, best at the bottom; then bids, best on top
+    constexpr int D = BookSnapshot::DEPTH;
+    const bool ask = index.row() < D;
+    const int lvl = ask ? D - 1 - index.row() : index.row() - D;
+    if (lvl >= (ask ? snap_.nAsks : snap_.nBids)) return {};
+    const PriceLevel& l = ask ? snap_.asks[lvl] : snap_.bids[lvl];
+
+    switch (index.column()) {
+    case BID_QTY: return ask ? QVariant() : QVariant(l.qty);
+    case PRICE:   return fromTicks(l.px);
+    case ASK_QTY: return ask ? QVariant(l.qty) : QVariant();
+    }
+    return {};
+}
+
+QVariant LadderModel::headerData(int section, Qt::Orientation o, int role) const
+{
+    static const char* const names[COLUMNS] = {"BidQty", "Price", "AskQty"};
+    if (o != Qt::Horizontal || role != Qt::DisplayRole || section < 0 || section >= COLUMNS)
+        return QAbstractTableModel::headerData(section, o, role);
+    return QString(names[section]);
+}
+
+void LadderModel::setSymbol(SymbolId sym)
+{
+    if (sym == sym_) return;
+    beginResetModel();
+    sym_ = sym;
+    snap_ = {};
+    version_ = 0;
+    endResetModel();
+    flush();
+}
+
+void LadderModel::flush()
+{
+    const OrderBook* book = sym_ != SymbolTable::NONE ? engine_.getBook(sym_) : nullptr;
+    if (!book) return;
+    const BookSnapshot s = book->snapshot();          // lock-free
+    if (s.version == version_) return;
+    snap_ = s;
+    version_ = s.version;
+    emit dataChanged(index(0, 0), index(rowCount() - 1, COLUMNS - 1));
+}
+
+// ────────── BlotterModel ─────────────────────────────────────────────────
+BlotterModel::BlotterModel(const SymbolTable& symbols, int capacity, QObject* parent)
+    : QAbstractTableModel(parent), symbols_(symbols), ring_(std::max(capacity, 1))
+{
+    pending_.reserve(4096);
+}
+
+int BlotterModel::rowCount(const QModelIndex& parent) const { return parent.isValid() ? 0 : size_; }
+int BlotterModel::columnCount(const QModelIndex& parent) const { return parent.isValid() ? 0 : COLUMNS; }
+
+QVariant BlotterModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= size_) return {};
+    if (role == Qt::TextAlignmentRole)
+        return index.column() == SYMBOL || index.column() == TIME ? QVariant() : alignRight();
+    if (role != Qt::DisplayRole) return {};
+
+    const int cap = ring_.size();
+    const Fill& f = ring_[(head_ - 1 - index.row() + cap) % cap];   // newest first
+    switch (index.column()) {
+    case TIME:    return QDateTime::fromMSecsSinceEpoch(f.timeMs).toString("HH:mm:ss.zzz");
+    case SYMBOL:  return QString::fromStdString(symbols_.name(f.sym));
+    case QTY:     return f.trade.qty;
+    case PRICE:   return fromTicks(f.trade.px);
+    case BUY_ID:  return QString::number(f.trade.buyId);
+    case SELL_ID: return QString::number(f.trade.sellId);
+    }
+    return {};
+}
+
+QVariant BlotterModel::headerData(int section, Qt::Orientation o, int role) const
+{
+    static const char* const names[COLUMNS] = {"Time", "Symbol", "Qty", "Price", "BuyId", "SellId"};
+    if (o != Qt::Horizontal || role != Qt::DisplayRole || section < 0 || section >= COLUMNS)
+        return QAbstractTableModel::headerData(section, o, role);
+    return QString(names[section]);
+}
+
+void BlotterModel::onTrade(SymbolId sym, const TradeEvent& t, qint64 timeMs)
+{
+    pending_.push_back({timeMs, sym, t});
+}
+
+void BlotterModel::flush()
+{
+    if (pending_.isEmpty()) return;
+    const int cap = ring_.size();
+    const int n = std::min(static_cast<int>(pending_.size()), cap);   // older ones would scroll out anyway
+    const Fill* src = pending_.constData() + (pending_.size() - n);
+
+    if (const int drop = size_ + n - cap; drop > 0) {     // oldest rows are overwritten
+        beginRemoveRows({}, size_ - drop, size_ - 1);
+        size_ -= drop;
+        endRemoveRows();
+    }
+    beginInsertRows({}, 0, n - 1);
+    for (int i = 0; i < n; ++i) {
+        ring_[head_] = src[i];
+        head_ = (head_ + 1) % cap;
+    }
+    size_ += n;
+    endInsertRows();
+    pending_.clear();
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QVector>
+#include <vector>
+
+#include "Messages.hpp"
+#include "OrderBook.hpp"
+
+class ExecutionEngine;
+
+// Models behind the demo UI. Events are folded into them as they are
+// drained (no signals), and flush() tells the views once per frame what
+// changed, so a burst of updates costs one repaint instead of one per event.
+
+// One row per symbol: top of book plus the engine's running trade stats.
+class MarketModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { SYMBOL, BID_QTY, BID_PX, ASK_QTY, ASK_PX, LAST, VWAP, VOLUME, TRADES, COLUMNS };
+
+    explicit MarketModel(const ExecutionEngine& engine, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = {}) const override;
+    int columnCount(const QModelIndex& parent = {}) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation o, int role) const override;
+
+    void onQuote(SymbolId sym, const TopOfBookEvt& tob);
+    void onTrade(SymbolId sym);
+    void flush();
+
+    SymbolId symbolAt(int row) const;
+
+private:
+    struct Row {
+        SymbolId sym;
+        TopOfBookEvt tob;
+        PxTicks last, vwap;
+        long long volume, trades;
+        bool traded;                // stats to be re-read at the next flush
+    };
+    int rowFor(SymbolId sym);
+    void touch(int row);
+
+    const ExecutionEngine& engine_;
+    std::vector<Row> rows_;
+    QHash<SymbolId, int> rowOf_;
+    std::vector<SymbolId> traded_;  // since the last flush, once each
+    int shown_ = 0;                 // rows the views know about
+    int dirtyFirst_ = -1, dirtyLast_ = -1;
+};
+
+// Aggregated depth of one symbol, asks above bids, read from the book's
+// published snapshot at most once per frame.
+class LadderModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { BID_QTY, PRICE, ASK_QTY, COLUMNS };
+
+    explicit LadderModel(ExecutionEngine& engine, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = {}) const override;
+    int columnCount(const QModelIndex& parent = {}) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation o, int role) const override;
+
+    void setSymbol(SymbolId sym);
+    void flush();
+
+private:
+    ExecutionEngine& engine_;
+    SymbolId sym_ = SymbolTable::NONE;
+    BookSnapshot snap_{};
+    std::uint64_t version_ = 0;
+};
+
+// The last `capacity` trades, newest first, in a ring: memory stays bounded
+// and the view only asks for the rows it shows.
+class BlotterModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { TIME, SYMBOL, QTY, PRICE, BUY_ID, SELL_ID, COLUMNS };
+
+    explicit BlotterModel(const SymbolTable& symbols, int capacity = 100'000,
+                          QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = {}) const override;
+    int columnCount(const QModelIndex& parent = {}) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation o, int role) const override;
+
+    void onTrade(SymbolId sym, const TradeEvent& t, qint64 timeMs);
+    void flush();
+
+private:
+    struct Fill { qint64 timeMs; SymbolId sym; TradeEvent trade; };
+
+    const SymbolTable& symbols_;
+    QVector<Fill> ring_;
+    int head_ = 0;                  // next slot to write
+    int size_ = 0;                  // rows the views know about
+    QVector<Fill> pending_;         // since the last flush, oldest first
+};
@@ -1,36 +1,45 @@
 #include <gtest/gtest.h>
 #include <thread>
+#include <algorithm>
 #include <atomic>
+#include <poll.h>
 #include "EngineRunner.hpp"
 
 using std::make_shared;
 
-static auto mktBuy (int q){return make_shared<Order>("AAPL",OrderSide::BUY ,
-                                                    OrderType::MARKET,0.0,q);}
-static auto mktSell(int q){return make_shared<Order>("AAPL",OrderSide::SELL,
-                                                    OrderType::MARKET,0.0,q);}
 static auto lim  (double px,int q,OrderSide s){
     return make_shared<Order>("AAPL",s,OrderType::LIMIT,px,q);
 }
+static InboundMsg newMsg(EngineRunner& r, const std::shared_ptr<Order>& o){
+    return InboundMsg::newOrder(r.engine().symbols().intern(o->getSymbol()), *o);
+}
+// Waits for the ack of `clientId`; other events are dropped.
+static OrderId awaitAck(EngineRunner& r, std::uint64_t clientId){
+    OutboundMsg ev;
+    for (int i = 0; i < 1000; ++i) {
+        while (r.poll(ev))
+            if (ev.type == OutboundType::ACK && ev.ack.clientId == clientId)
+                return ev.ack.orderId;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return NO_ORDER;
+}
 
 
 TEST(EngineRunnerBasic, PushAndPollOrderFlow)
 {
     EngineRunner r;
 
-    r.push(NewOrderMsg{ lim(150.0, 50, OrderSide::BUY ) }); // id 0
-    r.push(NewOrderMsg{ lim(149.5, 25, OrderSide::SELL) }); // id 1
+    r.push(newMsg(r, lim(150.0, 50, OrderSide::BUY ))); // id 0
+    r.push(newMsg(r, lim(149.5, 25, OrderSide::SELL))); // id 1
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
 
     int tobCnt = 0, tradeCnt = 0;
     OutboundMsg ev;
     while (r.poll(ev))
     {
-        std::visit([&](auto&& e){
-            using T = std::decay_t<decltype(e)>;
-            if constexpr (std::is_same_v<T, TradeEvent>)   ++tradeCnt;
-            else                                          ++tobCnt;
-        }, ev);
+        if      (ev.type == OutboundType::TRADE) ++tradeCnt;
+        else if (ev.type == OutboundType::TOB)   ++tobCnt;
     }
     r.stop();
 
@@ -41,19 +50,20 @@ TEST(EngineRunnerBasic, PushAndPollOrderFlow)
 TEST(EngineRunnerBasic, MultiSymbolTOB)
 {
     EngineRunner r;
-    r.push(NewOrderMsg{ make_shared<Order>("MSFT", OrderSide::BUY ,
-                                   OrderType::LIMIT, 300, 10) });
-    r.push(NewOrderMsg{ make_shared<Order>("AAPL", OrderSide::SELL,
-                                   OrderType::LIMIT, 180, 5 ) });
+    r.push(newMsg(r, make_shared<Order>("MSFT", OrderSide::BUY ,
+                                   OrderType::LIMIT, 300, 10)));
+    r.push(newMsg(r, make_shared<Order>("AAPL", OrderSide::SELL,
+                                   OrderType::LIMIT, 180, 5 )));
 
     std::this_thread::sleep_for(std::chrono::milliseconds(5));
 
     bool sawAapl = false, sawMsft = false;
     OutboundMsg ev;
     while (r.poll(ev)) {
-        if (auto* p = std::get_if<TopOfBookEvt>(&ev)) {
-            if (p->symbol == "AAPL") sawAapl = true;
-            if (p->symbol == "MSFT") sawMsft = true;
+        if (ev.type == OutboundType::TOB) {
+            const auto& sym = r.engine().symbols().name(ev.symbolId);
+            if (sym == "AAPL") sawAapl = true;
+            if (sym == "MSFT") sawMsft = true;
         }
     }
     r.stop();
@@ -64,25 +74,123 @@ TEST(EngineRunner, TradeCallbackConvertsToOutbound)
 {
     EngineRunner r;
 
-    r.push(NewOrderMsg{ lim(150, 1, OrderSide::BUY ) });
-    r.push(NewOrderMsg{ lim(149, 1, OrderSide::SELL) });
+    auto buy  = lim(150, 1, OrderSide::BUY );
+    auto sell = lim(149, 1, OrderSide::SELL);
+    buy->setClientId(11);
+    sell->setClientId(12);
+    r.push(newMsg(r, buy));
+    r.push(newMsg(r, sell));
 
     std::this_thread::sleep_for(std::chrono::milliseconds(5));
 
     int tradeEvt = 0;
+    OrderId buyId = NO_ORDER, sellId = NO_ORDER;
     OutboundMsg ev;
-    while (r.poll(ev))
-        if (std::holds_alternative<TradeEvent>(ev)) ++tradeEvt;
+    while (r.poll(ev)) {
+        if (ev.type == OutboundType::ACK)               // acks precede fills
+            (ev.ack.clientId == 11 ? buyId : sellId) = ev.ack.orderId;
+        if (ev.type == OutboundType::TRADE) {
+            ++tradeEvt;
+            EXPECT_EQ(ev.trade.buyId,  buyId);
+            EXPECT_EQ(ev.trade.sellId, sellId);
+            EXPECT_EQ(ev.trade.px, 150 * PX_SCALE);
+            EXPECT_EQ(ev.trade.qty, 1);
+        }
+    }
 
     r.stop();
     EXPECT_EQ(tradeEvt, 1);
+    EXPECT_NE(buyId, sellId);
+    EXPECT_EQ(shardOf(buyId), r.engine().shard());
+}
+
+TEST(EngineRunner, ModifyAndCancelMessages)
+{
+    EngineRunner r;
+    auto bid = lim(100, 10, OrderSide::BUY);
+    bid->setClientId(7);
+    r.push(newMsg(r, bid));
+    OrderId id = awaitAck(r, 7);
+    ASSERT_NE(id, NO_ORDER);
+    r.push(InboundMsg::modify(id, toTicks(101.0), std::nullopt));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    auto* book = r.engine().getBook("AAPL");
+    ASSERT_NE(book, nullptr);
+    ASSERT_NE(book->getBestBid(), nullptr);
+    EXPECT_EQ(book->getBestBid()->getPrice(), toTicks(101.0));
+    EXPECT_EQ(book->getBestBid()->getQuantity(), 10);
+
+    r.push(InboundMsg::cancel(id));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(book->getBestBid(), nullptr);
+    r.stop();
+}
+
+TEST(EngineRunner, InvalidOrderEmitsReject)
+{
+    EngineRunner r;
+    auto bad = lim(-5.0, 10, OrderSide::BUY);
+    r.push(newMsg(r, bad));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    int rejects = 0, tobs = 0;
+    OutboundMsg ev;
+    while (r.poll(ev)) {
+        if (ev.type == OutboundType::REJECT) {
+            ++rejects;
+            EXPECT_EQ(ev.reject.orderId, NO_ORDER);     // never accepted
+            EXPECT_EQ(ev.reject.reason, RejectReason::BAD_PRICE);
+        }
+        if (ev.type == OutboundType::TOB) ++tobs;
+    }
+    r.stop();
+    EXPECT_EQ(rejects, 1);
+    EXPECT_EQ(tobs, 0);
+}
+
+TEST(EngineRunner, CancelOnDisconnect)
+{
+    EngineRunner r;
+    SessionId keep = r.openSession(1, false);
+    SessionId cod  = r.openSession(2, true);
+    SessionId same = r.openSession(2, true);            // same account, stays connected
+    auto send = [&](SessionId s, const std::shared_ptr<Order>& o) {
+        const InboundMsg m = newMsg(r, o);
+        r.push(&m, 1, s);
+    };
+
+    send(keep, make_shared<Order>("AAPL", OrderSide::BUY, OrderType::LIMIT, 100, 5, 1));
+    send(cod,  make_shared<Order>("AAPL", OrderSide::BUY, OrderType::LIMIT, 101, 5, 2));
+    send(cod,  make_shared<Order>("AAPL", OrderSide::SELL, OrderType::LIMIT, 110, 5, 2));
+    send(same, make_shared<Order>("AAPL", OrderSide::SELL, OrderType::LIMIT, 120, 5, 2));
+    r.closeSession(keep);
+    r.closeSession(cod);
+    r.closeSession(cod);                                 // idempotent
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    int acks = 0;
+    OutboundMsg ev, lastTob{};
+    while (r.poll(ev)) {
+        if (ev.type == OutboundType::MASS_CANCEL) {
+            ++acks;
+            EXPECT_EQ(ev.massCancel.account, 2u);
+            EXPECT_EQ(ev.massCancel.count, 2);
+        }
+        if (ev.type == OutboundType::TOB) lastTob = ev;
+    }
+    r.stop();
+    EXPECT_EQ(acks, 1);
+    EXPECT_EQ(lastTob.tob.bidPx, 100 * PX_SCALE);
+    EXPECT_EQ(lastTob.tob.askPx, 120 * PX_SCALE);       // the other session's order rests on
 }
 
 TEST(EngineRunner, StopTerminatesCleanly)
 {
     {
         EngineRunner r;
-        r.push(NewOrderMsg{ lim(100, 1, OrderSide::BUY) });
+        r.push(newMsg(r, lim(100, 1, OrderSide::BUY)));
         // let destructor run -> should join without deadlock
     }
     SUCCEED();
@@ -96,7 +204,7 @@ TEST(EngineRunnerConcurrency, ManyThreads)
 
     auto worker = [&](int tid){
         for (int i=0;i<OrdersPerThread;++i)
-            r.push(NewOrderMsg{ lim(100+tid, 1, OrderSide::BUY) });
+            r.push(newMsg(r, lim(100+tid, 1, OrderSide::BUY)));
         ++done;
     };
 
@@ -111,8 +219,220 @@ TEST(EngineRunnerConcurrency, ManyThreads)
     int tobSeen = 0;
     OutboundMsg ev;
     while (r.poll(ev))
-        if (std::holds_alternative<TopOfBookEvt>(ev)) ++tobSeen;
+        if (ev.type == OutboundType::TOB) ++tobSeen;
 
     r.stop();
     EXPECT_GE(tobSeen, 1); 
 }
+
+static bool waitHandled(EngineRunner& r, std::uint64_t n){
+    for (int i = 0; i < 1000 && r.metrics().read()[Metric::MSGS_HANDLED] < n; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return r.metrics().read()[Metric::MSGS_HANDLED] >= n;
+}
+// With an outbound capacity of 1 and BLOCK, the unpolled events of one order
+// hold the matching thread back until someone polls.
+static void stallWorker(EngineRunner& r){
+    r.push(newMsg(r, lim(100.0, 1, OrderSide::BUY)));
+    ASSERT_TRUE(waitHandled(r, 1));
+}
+
+TEST(EngineRunnerFlow, RejectPolicyRefusesWhenFull)
+{
+    EngineRunner r;
+    FlowControl fc;
+    fc.inCapacity  = 2;
+    fc.outCapacity = 1;
+    fc.inbound     = Overflow::REJECT;
+    fc.outbound    = Overflow::BLOCK;
+    ASSERT_TRUE(r.setFlowControl(fc));
+    stallWorker(r);
+
+    EXPECT_EQ(r.credits(), 2u);
+    EXPECT_TRUE(r.push(newMsg(r, lim(99.0, 1, OrderSide::BUY))));
+    EXPECT_TRUE(r.push(newMsg(r, lim(98.0, 1, OrderSide::BUY))));
+    EXPECT_EQ(r.credits(), 0u);
+    EXPECT_FALSE(r.push(newMsg(r, lim(97.0, 1, OrderSide::BUY))));
+    EXPECT_EQ(r.metrics().read()[Metric::THROTTLED], 1u);
+
+    int acks = 0;
+    OutboundMsg ev;
+    for (int i = 0; i < 1000 && acks < 3; ++i) {
+        while (r.poll(ev)) acks += ev.type == OutboundType::ACK;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(acks, 3);
+    EXPECT_EQ(r.credits(), 2u);
+    EXPECT_EQ(r.engine().orderCount(), 3u);
+}
+
+TEST(EngineRunnerFlow, SessionsAreThrottledByCredits)
+{
+    EngineRunner r;
+    FlowControl fc;
+    fc.inCapacity     = 0;
+    fc.outCapacity    = 1;
+    fc.sessionCredits = 2;
+    fc.outbound       = Overflow::BLOCK;
+    ASSERT_TRUE(r.setFlowControl(fc));
+    const SessionId s = r.openSession(7, false);
+    stallWorker(r);
+
+    InboundMsg batch[3];
+    for (int i = 0; i < 3; ++i) {
+        auto o = lim(90.0 + i, 1, OrderSide::BUY);
+        o->setClientId(11 + i);
+        batch[i] = newMsg(r, o);
+    }
+    EXPECT_EQ(r.credits(s), 2u);
+    EXPECT_EQ(r.push(batch, 3, s), 2u);
+    EXPECT_EQ(r.credits(s), 0u);
+    EXPECT_GT(r.credits(), 1000u);          // the queue itself is unbounded
+
+    bool throttled = false;
+    int acks = 0;
+    OutboundMsg ev;
+    for (int i = 0; i < 1000 && acks < 3; ++i) {
+        while (r.poll(ev)) {
+            acks += ev.type == OutboundType::ACK;
+            throttled |= ev.type == OutboundType::REJECT && ev.reject.clientId == 13 &&
+                         ev.reject.reason == RejectReason::THROTTLED;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(acks, 3);
+    EXPECT_TRUE(throttled);
+    EXPECT_EQ(r.credits(s), 2u);
+}
+
+TEST(EngineRunnerFlow, BlockPolicyWaitsForRoom)
+{
+    EngineRunner r;
+    FlowControl fc;
+    fc.inCapacity  = 1;
+    fc.outCapacity = 1;
+    fc.outbound    = Overflow::BLOCK;
+    ASSERT_TRUE(r.setFlowControl(fc));
+    stallWorker(r);
+    EXPECT_TRUE(r.push(newMsg(r, lim(99.0, 1, OrderSide::BUY))));
+
+    std::atomic<bool> done{false};
+    std::thread producer([&]{ r.push(newMsg(r, lim(98.0, 1, OrderSide::BUY))); done = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(done.load());
+
+    OutboundMsg ev;
+    for (int i = 0; i < 1000 && !done.load(); ++i) {
+        while (r.poll(ev)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    producer.join();
+    EXPECT_TRUE(done.load());
+    EXPECT_TRUE(waitHandled(r, 3));
+}
+
+TEST(EngineRunnerFlow, ConflationKeepsReportsAndTheLatestQuote)
+{
+    EngineRunner r;
+    FlowControl fc;
+    fc.outCapacity = 3;
+    ASSERT_TRUE(r.setFlowControl(fc));      // outbound CONFLATE by default
+    for (double px : {100.0, 101.0, 102.0}) r.push(newMsg(r, lim(px, 1, OrderSide::BUY)));
+    ASSERT_TRUE(waitHandled(r, 3));
+
+    int acks = 0, quotes = 0;
+    PxTicks bid = 0;
+    OutboundMsg ev;
+    while (r.poll(ev)) {
+        acks += ev.type == OutboundType::ACK;
+        if (ev.type == OutboundType::TOB) { ++quotes; bid = ev.tob.bidPx; }
+    }
+    EXPECT_EQ(acks, 3);
+    EXPECT_EQ(quotes, 1);
+    EXPECT_EQ(bid, toTicks(102.0));
+    EXPECT_EQ(r.metrics().read()[Metric::CONFLATED], 2u);
+
+    fc.inbound = Overflow::CONFLATE;
+    EXPECT_FALSE(r.setFlowControl(fc));
+}
+
+TEST(EngineRunner, QuotesOnlyWhenTheTopChanges)
+{
+    EngineRunner r;
+    InboundMsg batch[] = {newMsg(r, lim(100.0, 5, OrderSide::BUY)),
+                          newMsg(r, lim( 99.0, 5, OrderSide::BUY)),     // behind the top
+                          newMsg(r, lim(101.0, 5, OrderSide::SELL)),
+                          newMsg(r, lim(102.0, 5, OrderSide::SELL))};   // behind the top
+    EXPECT_EQ(r.push(batch, 4), 4u);
+    ASSERT_TRUE(waitHandled(r, 4));
+
+    std::vector<TopOfBookEvt> quotes;
+    int acks = 0;
+    OutboundMsg ev;
+    while (r.poll(ev)) {
+        acks += ev.type == OutboundType::ACK;
+        if (ev.type == OutboundType::TOB) quotes.push_back(ev.tob);
+    }
+    EXPECT_EQ(acks, 4);
+    ASSERT_EQ(quotes.size(), 2u);
+    EXPECT_EQ(quotes[0].bidPx, toTicks(100.0));
+    EXPECT_EQ(quotes[0].askQty, 0);
+    EXPECT_EQ(quotes[1].askPx, toTicks(101.0));
+    EXPECT_EQ(quotes[1].bidQty, 5);
+}
+
+TEST(EngineRunner, EventFdIsReadableUntilPollRunsDry)
+{
+    EngineRunner r;
+    ASSERT_GE(r.eventFd(), 0);
+    pollfd pfd{r.eventFd(), POLLIN, 0};
+    EXPECT_EQ(::poll(&pfd, 1, 0), 0);
+
+    r.push(newMsg(r, lim(100.0, 5, OrderSide::BUY)));
+    ASSERT_EQ(::poll(&pfd, 1, 1000), 1);        // sleeps until the worker signals
+    OutboundMsg ev;
+    ASSERT_TRUE(r.poll(ev));
+    EXPECT_EQ(::poll(&pfd, 1, 0), 1);           // quote still queued
+    while (r.poll(ev)) {}
+    EXPECT_EQ(::poll(&pfd, 1, 0), 0);
+
+    r.push(newMsg(r, lim(99.0, 5, OrderSide::BUY)));
+    EXPECT_EQ(::poll(&pfd, 1, 1000), 1);
+}
+
+TEST(EngineRunner, EventHandlerTakesWholeBatchesInsteadOfPoll)
+{
+    EngineRunner r;
+    std::vector<std::size_t> batches;
+    std::vector<OutboundType> seen;
+    r.setEventHandler([&](const OutboundMsg* evs, std::size_t n) {
+        batches.push_back(n);
+        for (std::size_t i = 0; i < n; ++i) seen.push_back(evs[i].type);
+    });
+    InboundMsg batch[] = {newMsg(r, lim(100.0, 5, OrderSide::BUY)),
+                          newMsg(r, lim(100.0, 5, OrderSide::SELL))};
+    EXPECT_EQ(r.push(batch, 2), 2u);
+    ASSERT_TRUE(waitHandled(r, 2));
+
+    OutboundMsg ev;
+    EXPECT_FALSE(r.poll(ev));
+    pollfd pfd{r.eventFd(), POLLIN, 0};
+    EXPECT_EQ(::poll(&pfd, 1, 0), 0);
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_EQ(batches[0], seen.size());
+    EXPECT_EQ(std::count(seen.begin(), seen.end(), OutboundType::ACK), 2);
+    EXPECT_EQ(std::count(seen.begin(), seen.end(), OutboundType::TRADE), 1);
+    MetricsSnapshot s = r.metrics().read();
+    for (int i = 0; i < 1000 && s[Metric::EVENTS_OUT] < seen.size(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        s = r.metrics().read();
+    }
+    EXPECT_EQ(s[Metric::EVENTS_OUT], seen.size());
+    EXPECT_EQ(s.outQueue(), 0u);                    // delivered events count as polled
+
+    r.setEventHandler(nullptr);
+    r.push(newMsg(r, lim(99.0, 5, OrderSide::BUY)));
+    ASSERT_TRUE(waitHandled(r, 3));
+    EXPECT_TRUE(r.poll(ev));
+    EXPECT_EQ(batches.size(), 1u);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "EngineRunner.hpp"
+#include "EventBus.hpp"
+
+namespace {
+OutboundMsg event(OutboundType type, SymbolId sym)
+{
+    OutboundMsg m{};
+    m.type     = type;
+    m.symbolId = sym;
+    return m;
+}
+}
+
+TEST(EventBus, SubscribersReadIndependentlyThroughFilters)
+{
+    EventBus bus;
+    bus.publish(event(OutboundType::ACK, 1));           // nobody listening yet
+    auto all    = bus.subscribe();
+    auto msft   = bus.subscribe({2, 0});
+    auto trades = bus.subscribe({SymbolTable::NONE, EventFilter::bit(OutboundType::TRADE)});
+    EXPECT_EQ(bus.subscribers(), 3u);
+
+    bus.publish(event(OutboundType::TRADE, 1));
+    bus.publish(event(OutboundType::TOB, 2));
+    bus.publish(event(OutboundType::TRADE, 2));
+
+    OutboundMsg m;
+    int n = 0;
+    while (all->next(m)) ++n;
+    EXPECT_EQ(n, 3);
+
+    ASSERT_TRUE(msft->next(m));
+    EXPECT_EQ(m.type, OutboundType::TOB);
+    ASSERT_TRUE(msft->next(m));
+    EXPECT_EQ(m.type, OutboundType::TRADE);
+    EXPECT_FALSE(msft->next(m));
+
+    ASSERT_TRUE(trades->next(m));
+    EXPECT_EQ(m.symbolId, 1u);
+    ASSERT_TRUE(trades->next(m));
+    EXPECT_EQ(m.symbolId, 2u);
+    EXPECT_FALSE(trades->next(m));
+
+    msft.reset();
+    trades.reset();
+    EXPECT_EQ(bus.subscribers(), 1u);
+}
+
+TEST(EventBus, SlowSubscriberCountsWhatItLost)
+{
+    EventBus bus;
+    auto sub = bus.subscribe();
+    for (std::size_t i = 0; i < EventBus::RING + 5; ++i)
+        bus.publish(event(OutboundType::TOB, static_cast<SymbolId>(i % 7 + 1)));
+
+    OutboundMsg m;
+    std::size_t n = 0;
+    while (sub->next(m)) ++n;
+    EXPECT_GT(sub->lost(), 0u);
+    EXPECT_EQ(n + sub->lost(), EventBus::RING + 5);
+}
+
+TEST(EventBus, RunnerBroadcastsEveryFillToEveryReader)
+{
+    EngineRunner r;
+    auto risk = r.subscribe({SymbolTable::NONE, EventFilter::bit(OutboundType::TRADE)});
+    auto ui   = r.subscribe();
+    const SymbolId sym = r.engine().symbols().intern("AAPL");
+    r.push(InboundMsg::newOrder(sym, Order("AAPL", OrderSide::BUY,  OrderType::LIMIT, 150, 3)));
+    r.push(InboundMsg::newOrder(sym, Order("AAPL", OrderSide::SELL, OrderType::LIMIT, 150, 2)));
+
+    int polled = 0, seenByUi = 0, seenByRisk = 0;
+    OutboundMsg ev;
+    for (int i = 0; i < 1000 && (polled < 1 || seenByUi < 1 || seenByRisk < 1); ++i) {
+        while (r.poll(ev)) polled += ev.type == OutboundType::TRADE;
+        while (ui->next(ev)) seenByUi += ev.type == OutboundType::TRADE;
+        while (risk->next(ev)) {
+            EXPECT_EQ(ev.type, OutboundType::TRADE);
+            EXPECT_EQ(ev.trade.qty, 2);
+            ++seenByRisk;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(polled, 1);
+    EXPECT_EQ(seenByUi, 1);
+    EXPECT_EQ(seenByRisk, 1);
+    EXPECT_EQ(ui->lost(), 0u);
+}
@@ -26,7 +26,7 @@ TEST(EngineLifecycle, EnsureBookAndSubmit)
     ASSERT_NE(eng.getBook("AAPL"), nullptr);
 
     auto bid = makeLimit("AAPL", OrderSide::BUY, 150.0, 10);
-    int id   = eng.submit(bid);
+    OrderId id   = eng.submit(bid);
 
     EXPECT_EQ(bid->getOrderId(), id);
     EXPECT_EQ(eng.getBook("AAPL")->getBuyOrders().size(), 1);
@@ -98,7 +98,7 @@ TEST(EngineCancelModify, CancelUpdatesMaps)
 {
     ExecutionEngine eng;
     auto o = makeLimit("AAPL", OrderSide::BUY, 150, 20);
-    int id = eng.submit(o);
+    OrderId id = eng.submit(o);
 
     EXPECT_TRUE(eng.cancel(id));
     EXPECT_FALSE(o->isActive());
@@ -116,28 +116,119 @@ TEST(EngineCancelModify, ModifyTriggersRematch)
     eng.submit(bid);
     eng.submit(ask);
 
-    eng.modify(bid->getOrderId(), 152.0, std::nullopt);
+    eng.modify(bid->getOrderId(), toTicks(152.0), std::nullopt);
     EXPECT_EQ(tradeCnt, 1);
 }
 
+TEST(EngineCancelModify, MassCancelBySymbolAndSide)
+{
+    ExecutionEngine eng;
+    auto acct = [](const std::string& sym, OrderSide s, double px, AccountId a) {
+        return make_shared<Order>(sym, s, OrderType::LIMIT, px, 5, a);
+    };
+    int keep = eng.submit(acct("AAPL", OrderSide::BUY , 100, 4));
+    eng.submit(acct("AAPL", OrderSide::BUY , 101, 9));
+    eng.submit(acct("AAPL", OrderSide::SELL, 105, 9));
+    eng.submit(acct("MSFT", OrderSide::BUY , 300, 9));
+
+    SymbolId aapl = eng.symbols().find("AAPL");
+    EXPECT_EQ(eng.massCancel(9, aapl, OrderSide::BUY), 1);
+    EXPECT_EQ(eng.getBook("AAPL")->getBuyOrders().size(), 1u);
+    EXPECT_EQ(eng.getBook("AAPL")->getSellOrders().size(), 1u);
+
+    std::vector<SymbolId> touched;
+    EXPECT_EQ(eng.massCancel(9, std::nullopt, std::nullopt, &touched), 2);
+    EXPECT_EQ(touched.size(), 2u);
+    EXPECT_EQ(eng.getBook("MSFT")->getBuyOrders().size(), 0u);
+    EXPECT_EQ(eng.risk().exposure(9).openOrders, 0);
+    EXPECT_TRUE(eng.cancel(keep));
+}
+
+TEST(EngineAuction, OpenThenResumeContinuous)
+{
+    ExecutionEngine eng;
+    std::vector<ExecutionEngine::Trade> trades;
+    eng.setTradeHandler([&](const ExecutionEngine::Trade& t){ trades.push_back(t); });
+
+    eng.setAuction(std::nullopt, true);
+    eng.submit(makeLimit("AAPL", OrderSide::BUY , 101, 10));
+    eng.submit(makeLimit("AAPL", OrderSide::SELL,  99, 10));
+    eng.submit(makeLimit("MSFT", OrderSide::BUY , 300, 10));   // book created mid-auction
+    eng.submit(makeLimit("MSFT", OrderSide::SELL, 300,  4));
+    EXPECT_TRUE(trades.empty());
+
+    std::vector<SymbolId> touched;
+    EXPECT_EQ(eng.uncross(std::nullopt, true, &touched), 2);
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(touched.size(), 2u);
+    EXPECT_FALSE(eng.getBook("AAPL")->inAuction());
+
+    eng.submit(makeLimit("MSFT", OrderSide::SELL, 299, 6));      // continuous again
+    EXPECT_EQ(trades.size(), 3u);
+}
+
 // -----------------------------------------------------------------------------
 // Suite 4 : risk checks
 // -----------------------------------------------------------------------------
 TEST(EngineRisk, RejectTooLarge)
 {
     ExecutionEngine eng;
+    std::vector<ExecutionEngine::Reject> rejects;
+    eng.setRejectHandler([&](const ExecutionEngine::Reject& r){ rejects.push_back(r); });
     eng.setMaxOrderQty(99);
-    EXPECT_THROW(
-        eng.submit(makeLimit("AAPL", OrderSide::BUY, 150, 100)),
-        std::invalid_argument);
+
+    auto o = makeLimit("AAPL", OrderSide::BUY, 150, 100);
+    EXPECT_EQ(eng.submit(o), -1);
+    ASSERT_EQ(rejects.size(), 1u);
+    EXPECT_EQ(rejects[0].orderId, o->getOrderId());
+    EXPECT_EQ(rejects[0].reason, RejectReason::QTY_LIMIT);
+    EXPECT_EQ(eng.getBook("AAPL"), nullptr);
 }
 
 TEST(EngineRisk, AcceptAtLimit)
 {
     ExecutionEngine eng;
     eng.setMaxOrderQty(100);
-    EXPECT_NO_THROW(
-        eng.submit(makeLimit("AAPL", OrderSide::SELL, 150, 100)));
+    EXPECT_GE(
+        eng.submit(makeLimit("AAPL", OrderSide::SELL, 150, 100)), 0);
+}
+
+TEST(EngineRisk, RejectReasons)
+{
+    ExecutionEngine eng;
+    std::vector<RejectReason> why;
+    eng.setRejectHandler([&](const ExecutionEngine::Reject& r){ why.push_back(r.reason); });
+
+    EXPECT_EQ(eng.submit(nullptr), -1);
+    EXPECT_EQ(eng.submit(makeLimit("AAPL", OrderSide::BUY, 0.0, 10)), -1);
+    EXPECT_EQ(eng.submit(makeLimit("",     OrderSide::BUY, 10.0, 10)), -1);
+    OrderId id = eng.submit(makeLimit("AAPL", OrderSide::BUY, 10.0, 10));
+    EXPECT_FALSE(eng.modify(id, toTicks(-1.0), std::nullopt));
+    EXPECT_FALSE(eng.cancel(987654));
+
+    std::vector<RejectReason> expected = {
+        RejectReason::NULL_ORDER, RejectReason::BAD_PRICE, RejectReason::EMPTY_SYMBOL,
+        RejectReason::BAD_PRICE,  RejectReason::UNKNOWN_ORDER };
+    EXPECT_EQ(why, expected);
+    EXPECT_EQ(eng.getBook("AAPL")->getBuyOrders().size(), 1u);
+}
+
+TEST(EngineRisk, PricesMustBeOnTheTick)
+{
+    ExecutionEngine eng;
+    int rejects = 0;
+    eng.setRejectHandler([&](const ExecutionEngine::Reject& r){ rejects += r.reason == RejectReason::BAD_PRICE; });
+    const SymbolId sym = eng.symbols().intern("AAPL");
+    EXPECT_FALSE(eng.symbols().setTickSize(sym, 0));
+    ASSERT_TRUE(eng.symbols().setTickSize(sym, toTicks(0.05)));
+
+    EXPECT_EQ(eng.submit(makeLimit("AAPL", OrderSide::BUY, 10.02, 1)), -1);
+    OrderId id = eng.submit(makeLimit("AAPL", OrderSide::BUY, 10.05, 1));
+    ASSERT_GT(id, 0);
+    EXPECT_FALSE(eng.modify(id, toTicks(10.07), std::nullopt));
+    EXPECT_TRUE(eng.modify(id, toTicks(10.10), std::nullopt));
+    EXPECT_GT(eng.submit(makeMkt("AAPL", OrderSide::SELL, 1)), 0);
+    EXPECT_EQ(rejects, 2);
 }
 
 // -----------------------------------------------------------------------------
@@ -149,8 +240,8 @@ TEST(EngineIdMap, BookForOrder)
     auto o1 = makeLimit("AAPL", OrderSide::BUY, 100, 10);
     auto o2 = makeLimit("MSFT", OrderSide::BUY, 200, 10);
 
-    int id1 = eng.submit(o1);
-    int id2 = eng.submit(o2);
+    OrderId id1 = eng.submit(o1);
+    OrderId id2 = eng.submit(o2);
 
     EXPECT_NE(eng.getBook("AAPL"), eng.getBook("MSFT"));
     EXPECT_TRUE( eng.cancel(id1));
@@ -170,7 +261,7 @@ TEST(EngineEdge, CancelNonexistent)
 TEST(EngineEdge, ModifyNonexistent)
 {
     ExecutionEngine eng;
-    EXPECT_FALSE(eng.modify(67890, 100.0, 10));
+    EXPECT_FALSE(eng.modify(67890, toTicks(100.0), 10));
 }
 
 TEST(EngineEdge, MarketOrderNoLiquidity)
@@ -188,7 +279,7 @@ TEST(EngineEdge, ModifyToZeroQtyCancels)
 {
     ExecutionEngine eng;
     auto o = makeLimit("AAPL", OrderSide::BUY, 100, 20);
-    int id = eng.submit(o);
+    OrderId id = eng.submit(o);
 
     eng.modify(id, std::nullopt, 0);
     EXPECT_FALSE(o->isActive());
@@ -245,3 +336,145 @@ TEST(EngineStress, ManyOrders)
 
     EXPECT_GE(eng.getBook("AAPL")->getBuyOrders().size(), N/2);
 }
+
+TEST(EnginePrewarm, LeavesNoTraceBehind)
+{
+    ExecutionEngine eng;
+    int events = 0;
+    eng.setTradeHandler([&](const ExecutionEngine::Trade&){ ++events; });
+    eng.setRejectHandler([&](const ExecutionEngine::Reject&){ ++events; });
+
+    PrewarmConfig cfg;
+    cfg.symbols = {"AAPL", "MSFT"};
+    cfg.ordersPerBook = 5000;
+    cfg.warmupRounds = 16;
+    EXPECT_TRUE(eng.prewarm(cfg));
+
+    EXPECT_EQ(events, 0);
+    for (const char* s : {"AAPL", "MSFT"}) {
+        auto* book = eng.getBook(s);
+        ASSERT_NE(book, nullptr);
+        EXPECT_TRUE(book->getBuyOrders().empty());
+        EXPECT_TRUE(book->getSellOrders().empty());
+        EXPECT_GE(book->capacity(), cfg.ordersPerBook);
+        SymbolId sid = eng.symbols().find(s);
+        EXPECT_EQ(eng.risk().position(0, sid), 0);
+    }
+    EXPECT_EQ(eng.risk().exposure(0).openOrders, 0);
+
+    eng.ensureBook("IBM");                       // created after prewarm
+    EXPECT_GE(eng.getBook("IBM")->capacity(), cfg.ordersPerBook);
+
+    // handlers are back in place
+    eng.submit(makeLimit("AAPL", OrderSide::BUY , 100, 1));
+    eng.submit(makeLimit("AAPL", OrderSide::SELL, 100, 1));
+    EXPECT_EQ(events, 1);
+}
+
+TEST(EnginePrewarm, SkipsBooksItCannotLeaveEmpty)
+{
+    ExecutionEngine eng;
+    const OrderId resting = eng.submit(makeLimit("MSFT", OrderSide::SELL, 2.0, 5));
+    ASSERT_NE(resting, -1);
+    eng.setAuction(std::nullopt, true);
+
+    PrewarmConfig cfg;
+    cfg.symbols = {"AAPL", "MSFT"};
+    cfg.warmupRounds = 4;
+    eng.prewarm(cfg);
+
+    EXPECT_TRUE(eng.getBook("AAPL")->getBuyOrders().empty());
+    EXPECT_TRUE(eng.getBook("AAPL")->getSellOrders().empty());
+    EXPECT_EQ(eng.orderCount(), 1u);
+    auto msft = eng.getBook("MSFT")->getSellOrders();
+    ASSERT_EQ(msft.size(), 1u);
+    EXPECT_EQ(msft[0]->getQuantity(), 5);
+
+    // ids keep counting up from the last one handed out
+    const OrderId next = eng.submit(makeLimit("AAPL", OrderSide::BUY, 1.0, 1));
+    EXPECT_GT(next, resting);
+    EXPECT_EQ(eng.orderCount(), 2u);
+}
+
+TEST(EngineRisk, OwnerChecksKeepOtherAccountsOut)
+{
+    ExecutionEngine eng;
+    std::vector<ExecutionEngine::Reject> rejects;
+    eng.setRejectHandler([&](const ExecutionEngine::Reject& r){ rejects.push_back(r); });
+    auto o = make_shared<Order>("AAPL", OrderSide::BUY, OrderType::LIMIT, 100.0, 5, 1);
+    const OrderId id = eng.submit(o);
+
+    EXPECT_FALSE(eng.modify(id, toTicks(101.0), std::nullopt, 0, AccountId{2}));
+    EXPECT_FALSE(eng.cancel(id, 0, AccountId{2}));
+    ASSERT_EQ(rejects.size(), 2u);
+    EXPECT_EQ(rejects[1].reason, RejectReason::UNKNOWN_ORDER);
+    EXPECT_EQ(o->getPrice(), toTicks(100.0));
+
+    EXPECT_TRUE(eng.modify(id, toTicks(101.0), std::nullopt, 0, AccountId{1}));
+    EXPECT_TRUE(eng.cancel(id, 0, AccountId{1}));
+}
+
+TEST(EngineOrderIds, MintedByShardOnAcceptance)
+{
+    ExecutionEngine eng(5);
+    std::vector<ExecutionEngine::Accept> acks;
+    std::vector<ExecutionEngine::Reject> rejects;
+    eng.setAcceptHandler([&](const ExecutionEngine::Accept& a){ acks.push_back(a); });
+    eng.setRejectHandler([&](const ExecutionEngine::Reject& r){ rejects.push_back(r); });
+
+    auto bad = makeLimit("AAPL", OrderSide::BUY, -1.0, 10);
+    bad->setClientId(41);
+    EXPECT_EQ(eng.submit(bad), -1);
+    ASSERT_EQ(rejects.size(), 1u);
+    EXPECT_EQ(rejects[0].orderId, NO_ORDER);
+    EXPECT_EQ(rejects[0].clientId, 41u);
+
+    auto good = makeLimit("AAPL", OrderSide::BUY, 10.0, 10);
+    good->setClientId(42);
+    OrderId id = eng.submit(good);
+    EXPECT_EQ(id, makeOrderId(5, 1));            // the reject spent no id
+    EXPECT_EQ(shardOf(id), 5);
+    EXPECT_EQ(good->getOrderId(), id);
+    ASSERT_EQ(acks.size(), 1u);
+    EXPECT_EQ(acks[0].orderId, id);
+    EXPECT_EQ(acks[0].clientId, 42u);
+
+    // same sequence, other shard: not ours, no lookup
+    EXPECT_FALSE(eng.cancel(makeOrderId(3, 1)));
+    EXPECT_EQ(rejects.back().reason, RejectReason::UNKNOWN_ORDER);
+    EXPECT_TRUE(eng.cancel(id));
+}
+
+TEST(EngineBookEvents, SequencedPerSymbol)
+{
+    using BC = ExecutionEngine::BookChange;
+    ExecutionEngine eng;
+    std::vector<ExecutionEngine::BookEvent> ev;
+    eng.setBookEventHandler([&](const ExecutionEngine::BookEvent& b){ ev.push_back(b); });
+
+    OrderId bid = eng.submit(makeLimit("AAPL", OrderSide::BUY, 10.0, 5));
+    eng.submit(makeLimit("MSFT", OrderSide::BUY, 20.0, 1));
+    OrderId ask = eng.submit(makeLimit("AAPL", OrderSide::SELL, 10.0, 2));
+    eng.modify(bid, toTicks(9.5), std::nullopt);
+    eng.cancel(bid);
+    EXPECT_FALSE(eng.cancel(ask));                 // filled: no event
+
+    SymbolId aapl = eng.symbols().find("AAPL");
+    std::vector<ExecutionEngine::BookEvent> a;
+    for(const auto& b : ev) if(b.symbolId == aapl) a.push_back(b);
+    ASSERT_EQ(a.size(), 6u);
+    for(std::size_t i = 0; i < a.size(); ++i) EXPECT_EQ(a[i].seq, i + 1);
+    EXPECT_EQ(a[0].change, BC::ADD);    EXPECT_EQ(a[0].qty, 5);
+    EXPECT_EQ(a[1].change, BC::ADD);    EXPECT_EQ(a[1].orderId, ask);
+    EXPECT_EQ(a[2].change, BC::EXEC);   EXPECT_EQ(a[2].orderId, bid);  EXPECT_EQ(a[2].qty, 2);
+    EXPECT_EQ(a[3].change, BC::EXEC);   EXPECT_EQ(a[3].orderId, ask);
+    EXPECT_EQ(a[4].change, BC::MODIFY); EXPECT_EQ(a[4].price, toTicks(9.5)); EXPECT_EQ(a[4].qty, 3);
+    EXPECT_EQ(a[5].change, BC::CANCEL); EXPECT_EQ(a[5].qty, 3);
+
+    std::vector<ExecutionEngine::RestingOrder> rows;
+    EXPECT_EQ(eng.restingOrders(aapl, rows), 6u);
+    EXPECT_TRUE(rows.empty());
+    EXPECT_EQ(eng.restingOrders(eng.symbols().find("MSFT"), rows), 1u);
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].qty, 1);
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include "FlatIdMap.hpp"
+
+TEST(FlatIdMap, InsertFindErase)
+{
+    FlatIdMap<int, int> m(16);
+    for (int id = 0; id < 100; ++id) m.insert(id, id * 10);   // grows past 16
+    EXPECT_EQ(m.size(), 100u);
+    ASSERT_NE(m.find(42), nullptr);
+    EXPECT_EQ(*m.find(42), 420);
+    EXPECT_EQ(m.find(100), nullptr);
+
+    m.insert(42, 7);                                           // overwrite
+    EXPECT_EQ(*m.find(42), 7);
+    EXPECT_EQ(m.size(), 100u);
+
+    EXPECT_TRUE(m.erase(42));
+    EXPECT_FALSE(m.erase(42));
+    EXPECT_EQ(m.find(42), nullptr);
+    EXPECT_EQ(m.size(), 99u);
+}
+
+// Colliding ids (same low bits) exercise backward-shift deletion.
+TEST(FlatIdMap, MatchesStdMapUnderChurn)
+{
+    FlatIdMap<int, int> m(64);
+    std::map<int, int> ref;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> pick(0, 9);
+    for (int step = 0; step < 20'000; ++step) {
+        int id = pick(rng) * 128 + pick(rng);
+        if (step % 3 == 0) { EXPECT_EQ(m.erase(id), ref.erase(id) == 1); }
+        else               { m.insert(id, step); ref[id] = step; }
+    }
+    EXPECT_EQ(m.size(), ref.size());
+    for (int a = 0; a < 10; ++a)
+        for (int b = 0; b < 10; ++b) {
+            int id = a * 128 + b;
+            auto it = ref.find(id);
+            const int* v = m.find(id);
+            ASSERT_EQ(v != nullptr, it != ref.end()) << id;
+            if (v) { EXPECT_EQ(*v, it->second); }
+        }
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+#include "EngineRunner.hpp"
+#include "FlightRecorder.hpp"
+
+namespace {
+using Kind = FlightRecorder::Kind;
+
+struct TempDir {
+    std::string path;
+    explicit TempDir(const char* tag)
+        : path((std::filesystem::temp_directory_path() /
+                (std::string("tcx_") + tag + "_" + std::to_string(getpid()))).string()) {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+
+    std::vector<std::string> files() const {
+        std::vector<std::string> out;
+        for (const auto& f : std::filesystem::directory_iterator(path)) out.push_back(f.path().string());
+        return out;
+    }
+};
+
+std::size_t count(const FlightRecorder::Dump& d, Kind k)
+{
+    std::size_t n = 0;
+    for (const auto& e : d.events) n += e.kind == k;
+    return n;
+}
+}
+
+TEST(FlightRecorder, MergesThreadsIntoOneTimeline)
+{
+    TempDir dir("flight");
+    FlightRecorder fr(dir.path);
+    fr.note("first");
+    std::thread([&]{ fr.record(Kind::DONE, std::uint64_t{42}, 7); }).join();
+    fr.note("last");
+
+    const std::string file = fr.dump(FlightRecorder::Reason::REQUEST);
+    ASSERT_FALSE(file.empty());
+    FlightRecorder::Dump d;
+    ASSERT_TRUE(FlightRecorder::load(file, d));
+    EXPECT_EQ(d.pid, getpid());
+    EXPECT_EQ(d.threads.size(), 2u);
+    ASSERT_EQ(d.events.size(), 3u);
+    EXPECT_STREQ(reinterpret_cast<const char*>(d.events[0].body), "first");
+    EXPECT_EQ(d.events[1].kind, Kind::DONE);
+    EXPECT_EQ(d.events[1].aux, 7u);
+    EXPECT_NE(d.events[1].thread, d.events[0].thread);
+    EXPECT_STREQ(reinterpret_cast<const char*>(d.events[2].body), "last");
+    EXPECT_LE(d.events[0].wallNs, d.events[2].wallNs);
+    EXPECT_LE(d.events[2].wallNs, d.wallNs + 1'000'000);
+}
+
+TEST(FlightRecorder, KeepsTheLastRingOfRecords)
+{
+    TempDir dir("flight_ring");
+    FlightRecorder fr(dir.path);
+    const std::uint64_t n = FlightRecorder::RING + 10;
+    for (std::uint64_t i = 0; i < n; ++i) fr.record(Kind::DONE, i);
+
+    FlightRecorder::Dump d;
+    ASSERT_TRUE(FlightRecorder::load(fr.dump(FlightRecorder::Reason::REQUEST, dir.path + "/d.bin"), d));
+    ASSERT_EQ(d.events.size(), FlightRecorder::RING);
+    std::uint64_t first, lastv;
+    std::memcpy(&first, d.events.front().body, sizeof first);
+    std::memcpy(&lastv, d.events.back().body, sizeof lastv);
+    EXPECT_EQ(first, 10u);
+    EXPECT_EQ(lastv, n - 1);
+}
+
+TEST(FlightRecorder, RunnerRecordsTheMatchAndDumpsWhenSlow)
+{
+    TempDir dir("flight_runner");
+    EngineRunner r;
+    r.setFlightDumpDir(dir.path);
+    const SymbolId sym = r.engine().symbols().intern("AAPL");
+    r.push(InboundMsg::newOrder(sym, Order("AAPL", OrderSide::BUY,  OrderType::LIMIT, 150, 3)));
+    r.push(InboundMsg::newOrder(sym, Order("AAPL", OrderSide::SELL, OrderType::LIMIT, 150, 2)));
+    OutboundMsg ev;
+    for (int idle = 0; idle < 50; ) {
+        if (r.poll(ev)) idle = 0;
+        else { ++idle; std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    }
+
+    FlightRecorder::Dump d;
+    ASSERT_TRUE(FlightRecorder::load(r.dumpFlightRecorder(), d));
+    EXPECT_EQ(count(d, Kind::ENQUEUE), 2u);
+    EXPECT_EQ(count(d, Kind::HANDLE), 2u);
+    EXPECT_EQ(count(d, Kind::DONE), 2u);
+    EXPECT_EQ(count(d, Kind::FILL), 1u);
+    EXPECT_GE(count(d, Kind::BOOK), 3u);            // 2 adds, 2 execs
+    EXPECT_GE(count(d, Kind::OUT), 4u);             // 2 acks, a trade, quotes
+    EXPECT_EQ(dir.files().size(), 1u);
+
+    r.setLatencyDump(std::chrono::nanoseconds(1));  // every message breaches
+    r.push(InboundMsg::cancel(12345));
+    for (int i = 0; i < 1000 && dir.files().size() < 2; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    r.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    int latency = 0;
+    for (const auto& f : dir.files())
+        latency += FlightRecorder::load(f, d) && d.reason == FlightRecorder::Reason::LATENCY;
+    EXPECT_EQ(latency, 1);
+}
+
+TEST(FlightRecorder, RunnerRecordsSnapshotEvents)
+{
+    TempDir dir("flight_snapshot");
+    EngineRunner r;
+    r.setFlightDumpDir(dir.path);
+    const SymbolId sym = r.engine().symbols().intern("AAPL");
+    r.push(InboundMsg::newOrder(sym, Order("AAPL", OrderSide::BUY, OrderType::LIMIT, 150, 3)));
+    r.push(InboundMsg::bookSnapshot(sym, 9));
+    OutboundMsg ev;
+    int snapshots = 0;
+    for (int i = 0; i < 1000 && snapshots < 3; ++i) {
+        while (r.poll(ev)) snapshots += ev.type == OutboundType::L3 && ev.l3.clientId == 9;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(snapshots, 3);
+
+    FlightRecorder::Dump d;
+    ASSERT_TRUE(FlightRecorder::load(r.dumpFlightRecorder(), d));
+    r.stop();
+    int recorded = 0;
+    for (const auto& e : d.events) {
+        if (e.kind != Kind::OUT) continue;
+        OutboundMsg m;
+        std::memcpy(&m, e.body, sizeof m);
+        recorded += m.type == OutboundType::L3 && m.l3.clientId == 9;
+    }
+    EXPECT_EQ(recorded, 3);                         // begin, the order, end
+}
+
+TEST(FlightRecorder, DumpsOnSignal)
+{
+    TempDir dir("flight_signal");
+    FlightRecorder fr(dir.path);
+    fr.note("before the signal");
+    ASSERT_TRUE(FlightRecorder::installSignalHandler(SIGUSR2));
+    std::raise(SIGUSR2);
+    std::signal(SIGUSR2, SIG_DFL);
+
+    FlightRecorder::Dump d;
+    bool found = false;
+    for (const auto& f : dir.files()) found |= FlightRecorder::load(f, d) &&
+                                               d.reason == FlightRecorder::Reason::SIGNAL &&
+                                               count(d, Kind::NOTE) == 1;
+    EXPECT_TRUE(found);
+}
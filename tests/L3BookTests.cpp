@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "EngineRunner.hpp"
+#include "L3Book.hpp"
+
+namespace {
+constexpr SymbolId SYM = 1;
+
+OutboundMsg l3(L3Kind kind, std::uint64_t seq, OrderId id = NO_ORDER,
+               OrderSide side = OrderSide::BUY, double px = 0.0, int qty = 0)
+{
+    OutboundMsg m{};
+    m.type     = OutboundType::L3;
+    m.symbolId = SYM;
+    m.l3       = {seq, id, toTicks(px), 0, qty, side, kind};
+    return m;
+}
+}
+
+TEST(L3Book, AppliesIncrementalsFromTheFirstSeq)
+{
+    L3Book b(SYM);
+    EXPECT_EQ(b.state(), L3Book::State::STALE);
+    EXPECT_TRUE(b.apply(l3(L3Kind::ADD, 1, 11, OrderSide::BUY, 10.0, 5)));
+    EXPECT_EQ(b.state(), L3Book::State::LIVE);
+    b.apply(l3(L3Kind::ADD, 2, 12, OrderSide::BUY, 10.0, 3));
+    b.apply(l3(L3Kind::ADD, 3, 13, OrderSide::BUY, 10.0, 4));
+    EXPECT_EQ(b.queueAhead(13), 8);
+
+    b.apply(l3(L3Kind::EXEC, 4, 11, OrderSide::BUY, 10.0, 2));
+    EXPECT_EQ(b.queueAhead(13), 6);
+    b.apply(l3(L3Kind::MODIFY, 5, 11, OrderSide::BUY, 10.0, 3));    // to the back
+    EXPECT_EQ(b.queueAhead(11), 7);
+    b.apply(l3(L3Kind::CANCEL, 6, 12, OrderSide::BUY, 10.0, 3));
+    EXPECT_EQ(b.queueAhead(13), 0);
+
+    PxTicks px = 0;
+    long long qty = 0;
+    ASSERT_TRUE(b.best(OrderSide::BUY, px, qty));
+    EXPECT_EQ(px, toTicks(10.0));
+    EXPECT_EQ(qty, 7);
+    EXPECT_FALSE(b.best(OrderSide::SELL, px, qty));
+    EXPECT_EQ(b.seq(), 6u);
+}
+
+TEST(L3Book, GapThenSnapshot)
+{
+    L3Book b(SYM);
+    b.apply(l3(L3Kind::ADD, 1, 11, OrderSide::SELL, 10.0, 5));
+    EXPECT_FALSE(b.apply(l3(L3Kind::ADD, 3, 12, OrderSide::SELL, 10.0, 5)));
+    EXPECT_EQ(b.state(), L3Book::State::STALE);
+    EXPECT_EQ(b.orders(), 0u);
+    EXPECT_TRUE(b.apply(l3(L3Kind::ADD, 4, 13, OrderSide::SELL, 11.0, 1)));   // ignored
+    EXPECT_EQ(b.orders(), 0u);
+
+    b.apply(l3(L3Kind::SNAPSHOT_BEGIN, 4, NO_ORDER, OrderSide::BUY, 0.0, 3));
+    b.apply(l3(L3Kind::SNAPSHOT_ORDER, 4, 11, OrderSide::SELL, 10.0, 5));
+    b.apply(l3(L3Kind::SNAPSHOT_ORDER, 4, 12, OrderSide::SELL, 10.0, 5));
+    b.apply(l3(L3Kind::SNAPSHOT_ORDER, 4, 13, OrderSide::SELL, 11.0, 1));
+    b.apply(l3(L3Kind::SNAPSHOT_END,   4, NO_ORDER, OrderSide::BUY, 0.0, 3));
+    EXPECT_EQ(b.state(), L3Book::State::LIVE);
+    EXPECT_EQ(b.queueAhead(12), 5);
+
+    EXPECT_TRUE(b.apply(l3(L3Kind::CANCEL, 5, 11, OrderSide::SELL, 10.0, 5)));
+    EXPECT_EQ(b.queueAhead(12), 0);
+}
+
+TEST(L3Book, ResyncsAgainstTheRunner)
+{
+    EngineRunner r;
+    r.setL3Feed(true);
+    SymbolId sym = r.engine().symbols().intern("AAPL");
+    auto order = [&](OrderSide s, double px, int q){
+        r.push(InboundMsg::newOrder(sym, Order("AAPL", s, OrderType::LIMIT, px, q)));
+    };
+    auto drain = [&](auto&& fn){
+        OutboundMsg ev;
+        for (int idle = 0; idle < 50; ) {
+            if (r.poll(ev)) { fn(ev); idle = 0; }
+            else { ++idle; std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+        }
+    };
+
+    order(OrderSide::BUY, 10.0, 5);
+    order(OrderSide::BUY, 10.0, 7);
+    drain([](const OutboundMsg&){});                 // this consumer joins late
+
+    L3Book book(sym);
+    order(OrderSide::BUY, 10.0, 4);
+    bool gap = false;
+    drain([&](const OutboundMsg& ev){ gap |= !book.apply(ev); });
+    EXPECT_TRUE(book.state() == L3Book::State::STALE || gap);
+
+    r.push(InboundMsg::bookSnapshot(sym, 77));
+    order(OrderSide::SELL, 10.0, 6);                 // lands after the snapshot
+    drain([&](const OutboundMsg& ev){ EXPECT_TRUE(book.apply(ev)); });
+
+    ASSERT_EQ(book.state(), L3Book::State::LIVE);
+    EXPECT_EQ(book.orders(), 2u);                    // 5 filled, 7 has 6 left, 4 untouched
+    std::vector<ExecutionEngine::RestingOrder> rows;
+    r.engine().restingOrders(sym, rows);
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(book.queueAhead(rows[0].orderId), 0);
+    EXPECT_EQ(book.queueAhead(rows[1].orderId), 6);
+}
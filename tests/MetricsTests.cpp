@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "EngineRunner.hpp"
+#include "Metrics.hpp"
+
+TEST(Metrics, SumsPerThreadCounters)
+{
+    Metrics m;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&]{ for (int i = 0; i < 100000; ++i) m.add(Metric::FILLS); });
+    for (auto& t : threads) t.join();
+    m.add(Metric::FILLED_QTY, 7);
+    m.set(Metric::BOOKS, 3);
+    m.set(Metric::BOOKS, 2);
+
+    const MetricsSnapshot s = m.read();
+    EXPECT_EQ(s[Metric::FILLS], 400000u);
+    EXPECT_EQ(s[Metric::FILLED_QTY], 7u);
+    EXPECT_EQ(s[Metric::BOOKS], 2u);
+    EXPECT_EQ(s[Metric::ORDERS], 0u);
+}
+
+TEST(Metrics, SharedSegmentMirrorsTheRegistry)
+{
+    Metrics m;
+    if (m.shmName().empty()) GTEST_SKIP() << "no /dev/shm";
+    m.add(Metric::ORDERS, 5);
+    m.setBookOrders(3, 9, "MSFT");
+
+    ShmMapping map = ShmMapping::open(m.shmName(), sizeof(MetricsRegion), false);
+    ASSERT_TRUE(map);
+    const auto& r = *static_cast<const MetricsRegion*>(map.data());
+    EXPECT_EQ(r.magic.load(), METRICS_MAGIC);
+    EXPECT_EQ(readMetrics(r)[Metric::ORDERS], 5u);
+    EXPECT_EQ(r.books.load(), 4u);
+    EXPECT_STREQ(r.book[3].name, "MSFT");
+    EXPECT_EQ(r.book[3].orders.load(), 9u);
+}
+
+TEST(Metrics, RunnerCountsFlowAndQueues)
+{
+    EngineRunner r;
+    const SymbolId sym = r.engine().symbols().intern("AAPL");
+    r.push(InboundMsg::newOrder(sym, Order("AAPL", OrderSide::BUY,  OrderType::LIMIT, 150, 3)));
+    r.push(InboundMsg::newOrder(sym, Order("AAPL", OrderSide::SELL, OrderType::LIMIT, 150, 2)));
+    r.push(InboundMsg::cancel(12345));
+
+    OutboundMsg ev;
+    for (int idle = 0; idle < 50; ) {
+        if (r.poll(ev)) idle = 0;
+        else { ++idle; std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    }
+
+    const MetricsSnapshot s = r.metrics().read();
+    EXPECT_EQ(s[Metric::MSGS_IN], 3u);
+    EXPECT_EQ(s[Metric::MSGS_HANDLED], 3u);
+    EXPECT_EQ(s.inQueue(), 0u);
+    EXPECT_EQ(s[Metric::ORDERS], 2u);
+    EXPECT_EQ(s[Metric::CANCELS], 1u);
+    EXPECT_EQ(s[Metric::ACKS], 2u);
+    EXPECT_EQ(s[Metric::REJECTS], 1u);
+    EXPECT_EQ(s[Metric::FILLS], 1u);
+    EXPECT_EQ(s[Metric::FILLED_QTY], 2u);
+    EXPECT_EQ(s[Metric::RESTING_ORDERS], 1u);
+    EXPECT_EQ(s[Metric::BOOKS], 1u);
+    EXPECT_GT(s[Metric::EVENTS_OUT], 0u);
+    EXPECT_EQ(s.outQueue(), 0u);
+    EXPECT_EQ(r.metrics().bookOrders(sym), 1u);
+}
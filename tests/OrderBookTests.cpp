@@ -14,8 +14,20 @@ TEST(OrderBookBasic, BestBidAsk)
 
     ASSERT_NE(book.getBestBid(), nullptr);
     ASSERT_NE(book.getBestAsk(), nullptr);
-    EXPECT_DOUBLE_EQ(book.getBestBid()->getPrice(), 149.0);
-    EXPECT_DOUBLE_EQ(book.getBestAsk()->getPrice(), 150.0);
+    EXPECT_EQ(book.getBestBid()->getPrice(), toTicks(149.0));
+    EXPECT_EQ(book.getBestAsk()->getPrice(), toTicks(150.0));
+}
+
+TEST(OrderBookBasic, OnePriceIsOneLevel)
+{
+    OrderBook book("AAPL");
+    book.addOrder(make_shared<Order>("AAPL", OrderSide::BUY, OrderType::LIMIT, 100.1, 1));
+    book.addOrder(make_shared<Order>("AAPL", OrderSide::BUY, OrderType::LIMIT, 100.0 + 0.1, 2));
+    book.publish();
+    BookSnapshot s = book.snapshot();
+    ASSERT_EQ(s.nBids, 1);
+    EXPECT_EQ(s.bids[0].px, 1'001'000);
+    EXPECT_EQ(s.bids[0].qty, 3);
 }
 
 TEST(OrderBookMatch, LimitCrossFullAndPartial)
@@ -53,7 +65,7 @@ TEST(OrderBookOps, CancelAndModify)
 {
     OrderBook book("AAPL");
     auto bid = make_shared<Order>("AAPL", OrderSide::BUY, OrderType::LIMIT, 148.0, 40);
-    int id   = book.addOrder(bid);
+    OrderId id   = book.addOrder(bid);
 
     // modify quantity
     EXPECT_TRUE(book.modifyOrder(id, std::nullopt, 60));
@@ -64,3 +76,126 @@ TEST(OrderBookOps, CancelAndModify)
     EXPECT_FALSE(bid->isActive());
     EXPECT_EQ(book.getBuyOrders().size(), 0);
 }
+
+TEST(OrderBookOps, RemoveAccountOrders)
+{
+    OrderBook book("AAPL");
+    auto mk = [](OrderSide s, double px, AccountId a) {
+        return make_shared<Order>("AAPL", s, OrderType::LIMIT, px, 10, a);
+    };
+    auto b1 = mk(OrderSide::BUY,  99.0, 1);
+    auto b2 = mk(OrderSide::BUY,  99.0, 2);
+    auto b3 = mk(OrderSide::BUY,  98.0, 1);
+    auto s1 = mk(OrderSide::SELL, 101.0, 1);
+    for (auto& o : {b1, b2, b3, s1}) book.addOrder(o);
+
+    auto gone = book.removeAccountOrders(1, OrderSide::BUY);
+    EXPECT_EQ(gone.size(), 2u);
+    EXPECT_FALSE(b1->isActive());
+    EXPECT_FALSE(b3->isActive());
+    EXPECT_TRUE (s1->isActive());
+    ASSERT_EQ(book.getBuyOrders().size(), 1u);
+    EXPECT_EQ(book.getBuyOrders().front(), b2);
+    EXPECT_EQ(book.getOrder(b1->getOrderId()), nullptr);
+
+    gone = book.removeAccountOrders(1);
+    ASSERT_EQ(gone.size(), 1u);
+    EXPECT_EQ(gone[0].orderId, s1->getOrderId());
+    EXPECT_EQ(gone[0].qty, 10);
+    EXPECT_EQ(book.getBestAsk(), nullptr);
+}
+
+TEST(OrderBookAuction, UncrossAtEquilibrium)
+{
+    OrderBook book("AAPL");
+    book.setAuction(true);
+    auto lmt = [](OrderSide s, double px, int q) {
+        return make_shared<Order>("AAPL", s, OrderType::LIMIT, px, q);
+    };
+    auto b1 = lmt(OrderSide::BUY , 102.0, 30);
+    auto b2 = lmt(OrderSide::BUY , 101.0, 20);
+    auto b3 = lmt(OrderSide::BUY ,  99.0, 50);
+    auto s1 = lmt(OrderSide::SELL,  98.0, 10);
+    auto s2 = lmt(OrderSide::SELL, 100.0, 25);
+    auto s3 = lmt(OrderSide::SELL, 101.0, 40);
+    auto mb = make_shared<Order>("AAPL", OrderSide::BUY, OrderType::MARKET, 0.0, 5);
+    for (auto& o : {b1, b2, b3, s1, s2, s3, mb}) book.addOrder(o);
+
+    EXPECT_TRUE(book.match().empty());           // accumulating
+
+    // demand@101 = 5+30+20 = 55, supply@101 = 75 -> 55 (max)
+    auto ind = book.indicative();
+    EXPECT_EQ(ind.price, toTicks(101.0));
+    EXPECT_EQ(ind.volume, 55);
+    EXPECT_EQ(ind.surplus, -20);
+
+    auto fills = book.uncross();
+    int vol = 0;
+    for (const auto& m : fills) { EXPECT_EQ(m.price, toTicks(101.0)); vol += m.qty; }
+    EXPECT_EQ(vol, 55);
+    EXPECT_FALSE(b1->isActive());
+    EXPECT_FALSE(b2->isActive());
+    EXPECT_FALSE(mb->isActive());
+    EXPECT_EQ(s3->getQuantity(), 20);
+    EXPECT_EQ(book.indicative().volume, 0);      // nothing left crossed
+
+    book.setAuction(false);
+    EXPECT_TRUE(book.match().empty());
+    EXPECT_EQ(book.getBestBid()->getPrice(), toTicks(99.0));
+    EXPECT_EQ(book.getBestAsk()->getPrice(), toTicks(101.0));
+}
+
+TEST(OrderBookSnapshot, AggregatesLevelsOnPublish)
+{
+    OrderBook book("AAPL");
+    auto lmt = [](OrderSide s, double px, int q) {
+        return make_shared<Order>("AAPL", s, OrderType::LIMIT, px, q);
+    };
+    book.addOrder(lmt(OrderSide::BUY , 100.0, 10));
+    book.addOrder(lmt(OrderSide::BUY , 100.0,  5));
+    book.addOrder(lmt(OrderSide::BUY ,  99.0,  7));
+    book.addOrder(lmt(OrderSide::SELL, 101.0,  3));
+    book.addOrder(make_shared<Order>("AAPL", OrderSide::SELL, OrderType::MARKET, 0.0, 1));
+
+    EXPECT_EQ(book.snapshot().version, 0u);      // nothing published yet
+    book.publish();
+
+    BookSnapshot s = book.snapshot();
+    EXPECT_EQ(s.version, 1u);
+    ASSERT_EQ(s.nBids, 2);
+    ASSERT_EQ(s.nAsks, 1);                       // market order not shown
+    EXPECT_EQ(s.bids[0].px, toTicks(100.0));
+    EXPECT_EQ(s.bids[0].qty, 15);
+    EXPECT_EQ(s.bids[0].orders, 2);
+    EXPECT_EQ(s.bids[1].px, toTicks(99.0));
+    EXPECT_EQ(s.asks[0].px, toTicks(101.0));
+}
+
+TEST(OrderBookPolicy, LimitShardBook)
+{
+    BasicOrderBook<LimitShardPolicy> book("AAPL");
+    auto lmt = [](OrderSide s, double px, int q) {
+        return make_shared<Order>("AAPL", s, OrderType::LIMIT, px, q);
+    };
+    EXPECT_EQ(book.addOrder(make_shared<Order>("AAPL", OrderSide::BUY, OrderType::MARKET, 0.0, 5)), -1);
+
+    book.setAuction(true);                       // compiled out
+    EXPECT_FALSE(book.inAuction());
+
+    book.addOrder(lmt(OrderSide::SELL, 100.01, 4));
+    book.addOrder(lmt(OrderSide::SELL, 100.02, 4));
+    book.addOrder(lmt(OrderSide::BUY , 100.00, 3));
+    EXPECT_TRUE(book.match().empty());
+
+    book.addOrder(lmt(OrderSide::BUY, 100.015, 6));
+    auto fills = book.match();
+    ASSERT_EQ(fills.size(), 1u);
+    EXPECT_EQ(fills[0].qty, 4);
+
+    book.publish();
+    BookSnapshot s = book.snapshot();
+    ASSERT_EQ(s.nBids, 2);
+    EXPECT_EQ(s.bids[0].px, toTicks(100.015));
+    EXPECT_EQ(s.bids[0].qty, 2);
+    EXPECT_EQ(s.asks[0].px, toTicks(100.02));
+}
@@ -0,0 +1,318 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "OrderGateway.hpp"
+
+namespace {
+// Loopback client simulator: blocking socket, one frame at a time.
+class SimClient {
+public:
+    static SimClient tcp(int port) {
+        SimClient c(socket(AF_INET, SOCK_STREAM, 0));
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_port   = htons(static_cast<std::uint16_t>(port));
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        c.ok_ = connect(c.fd_, reinterpret_cast<sockaddr*>(&a), sizeof(a)) == 0;
+        return c;
+    }
+    static SimClient unixSocket(const std::string& path) {
+        SimClient c(socket(AF_UNIX, SOCK_STREAM, 0));
+        sockaddr_un a{};
+        a.sun_family = AF_UNIX;
+        std::strncpy(a.sun_path, path.c_str(), sizeof(a.sun_path) - 1);
+        c.ok_ = connect(c.fd_, reinterpret_cast<sockaddr*>(&a), sizeof(a)) == 0;
+        return c;
+    }
+    SimClient(SimClient&& o) noexcept : fd_(o.fd_), ok_(o.ok_) { o.fd_ = -1; }
+    ~SimClient() { if (fd_ >= 0) ::close(fd_); }
+
+    bool ok() const { return ok_; }
+    void shutdownWrite() { ::shutdown(fd_, SHUT_WR); }
+
+    void sendBytes(const void* p, std::size_t n) { ASSERT_EQ(::send(fd_, p, n, 0), (ssize_t)n); }
+    template <typename F> void sendFrame(const F& f) { sendBytes(&f, sizeof(f)); }
+
+    // false on timeout or when the gateway closed the connection
+    template <typename F> bool recvFrame(F& f, int timeoutMs = 2000) {
+        static_assert(sizeof(F) == WIRE_FRAME);
+        std::size_t got = 0;
+        auto* p = reinterpret_cast<char*>(&f);
+        while (got < sizeof(F)) {
+            pollfd pfd{fd_, POLLIN, 0};
+            if (::poll(&pfd, 1, timeoutMs) <= 0) return false;
+            ssize_t n = ::recv(fd_, p + got, sizeof(F) - got, 0);
+            if (n <= 0) return false;
+            got += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+    bool recvType(OutboundType type, OutboundMsg& ev) {
+        while (recvFrame(ev))
+            if (ev.type == type) return true;
+        return false;
+    }
+
+    void logon(AccountId account, bool cancelOnDisconnect = false) {
+        WireLogon l;
+        l.account = account;
+        l.cancelOnDisconnect = cancelOnDisconnect;
+        sendFrame(l);
+        WireLogon echo;
+        ASSERT_TRUE(recvFrame(echo));
+        ASSERT_EQ(echo.type, WIRE_LOGON);
+        EXPECT_EQ(echo.account, account);
+    }
+    SymbolId symbol(const char* name) {
+        WireSymbol s;
+        std::strncpy(s.name, name, sizeof(s.name) - 1);
+        sendFrame(s);
+        WireSymbol r;
+        return recvFrame(r) && r.type == WIRE_SYMBOL ? r.symbolId : SymbolTable::NONE;
+    }
+
+private:
+    explicit SimClient(int fd) : fd_(fd) {}
+    int fd_;
+    bool ok_ = false;
+};
+
+InboundMsg limit(SymbolId sym, OrderSide side, double px, int qty, std::uint64_t clientId)
+{
+    InboundMsg m = InboundMsg::newOrder(sym, Order("", side, OrderType::LIMIT, px, qty));
+    m.clientId = clientId;
+    return m;
+}
+
+GatewayConfig tcpConfig()
+{
+    GatewayConfig cfg;
+    cfg.tcpPort = 0;
+    return cfg;
+}
+}
+
+TEST(OrderGateway, TcpOrderRoundTrip)
+{
+    EngineRunner runner;
+    auto gw = OrderGateway::open(runner, tcpConfig());
+    ASSERT_TRUE(gw);
+    ASSERT_GT(gw->tcpPort(), 0);
+
+    auto c = SimClient::tcp(gw->tcpPort());
+    ASSERT_TRUE(c.ok());
+    c.logon(1);
+    SymbolId sym = c.symbol("AAPL");
+    ASSERT_NE(sym, SymbolTable::NONE);
+
+    c.sendFrame(limit(sym, OrderSide::BUY, 100.0, 10, 42));
+    OutboundMsg ev;
+    ASSERT_TRUE(c.recvType(OutboundType::ACK, ev));
+    EXPECT_EQ(ev.ack.clientId, 42u);                 // the routing tag is stripped
+    EXPECT_NE(ev.ack.orderId, NO_ORDER);
+    EXPECT_EQ(gw->connections(), 1u);
+}
+
+TEST(OrderGateway, RepliesGoToTheirOwnConnection)
+{
+    EngineRunner runner;
+    auto gw = OrderGateway::open(runner, tcpConfig());
+    ASSERT_TRUE(gw);
+    auto buyer  = SimClient::tcp(gw->tcpPort());
+    auto seller = SimClient::tcp(gw->tcpPort());
+    buyer.logon(1);
+    seller.logon(2);
+    SymbolId sym = buyer.symbol("MSFT");
+
+    buyer.sendFrame(limit(sym, OrderSide::BUY, 50.0, 5, 7));
+    OutboundMsg ev;
+    ASSERT_TRUE(buyer.recvType(OutboundType::ACK, ev));
+    OrderId buyId = ev.ack.orderId;
+
+    seller.sendFrame(limit(sym, OrderSide::SELL, 50.0, 5, 7));
+    ASSERT_TRUE(seller.recvType(OutboundType::ACK, ev));
+    EXPECT_NE(ev.ack.orderId, buyId);
+    ASSERT_TRUE(seller.recvType(OutboundType::TRADE, ev));
+    EXPECT_EQ(ev.trade.buyId, buyId);
+
+    // the buyer sees the trade but never the seller's ack
+    ASSERT_TRUE(buyer.recvFrame(ev));
+    while (ev.type == OutboundType::TOB) ASSERT_TRUE(buyer.recvFrame(ev));
+    EXPECT_EQ(ev.type, OutboundType::TRADE);
+    EXPECT_EQ(ev.trade.qty, 5);
+
+    // cancel rejects are routed back by client id too
+    InboundMsg cxl = InboundMsg::cancel(buyId);
+    cxl.clientId = 99;
+    buyer.sendFrame(cxl);
+    ASSERT_TRUE(buyer.recvType(OutboundType::REJECT, ev));
+    EXPECT_EQ(ev.reject.clientId, 99u);
+    EXPECT_EQ(ev.reject.orderId, buyId);
+}
+
+TEST(OrderGateway, FramesSplitAcrossReadsAndBatched)
+{
+    EngineRunner runner;
+    auto gw = OrderGateway::open(runner, tcpConfig());
+    ASSERT_TRUE(gw);
+    auto c = SimClient::tcp(gw->tcpPort());
+    c.logon(3);
+    SymbolId sym = c.symbol("IBM");
+
+    InboundMsg msgs[3] = { limit(sym, OrderSide::BUY, 10.0, 1, 1),
+                           limit(sym, OrderSide::BUY, 11.0, 1, 2),
+                           limit(sym, OrderSide::BUY, 12.0, 1, 3) };
+    const auto* bytes = reinterpret_cast<const char*>(msgs);
+    c.sendBytes(bytes, 100);                          // one and a half frames
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    c.sendBytes(bytes + 100, sizeof(msgs) - 100);
+
+    for (std::uint64_t cid = 1; cid <= 3; ++cid) {
+        OutboundMsg ev;
+        ASSERT_TRUE(c.recvType(OutboundType::ACK, ev));
+        EXPECT_EQ(ev.ack.clientId, cid);
+    }
+}
+
+TEST(OrderGateway, UnixSocketAndCancelOnDisconnect)
+{
+    EngineRunner runner;
+    GatewayConfig cfg;
+    cfg.unixPath = "/tmp/tce_gw_test_" + std::to_string(getpid()) + ".sock";
+    auto gw = OrderGateway::open(runner, cfg);
+    ASSERT_TRUE(gw);
+    EXPECT_EQ(gw->tcpPort(), -1);
+    {
+        auto c = SimClient::unixSocket(cfg.unixPath);
+        ASSERT_TRUE(c.ok());
+        c.logon(4, true);
+        InboundMsg m = limit(c.symbol("GOOG"), OrderSide::SELL, 90.0, 2, 1);
+        m.account = 77;                               // overridden by the logon
+        c.sendFrame(m);
+        OutboundMsg ev;
+        ASSERT_TRUE(c.recvType(OutboundType::ACK, ev));
+        EXPECT_EQ(runner.engine().risk().exposure(4).openOrders, 1);
+    }
+    for (int i = 0; i < 2000 && runner.engine().risk().exposure(4).openOrders != 0; ++i)
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    EXPECT_EQ(runner.engine().risk().exposure(4).openOrders, 0);
+}
+
+TEST(OrderGateway, BurstLargerThanTheQueueReachesAReadingClient)
+{
+    EngineRunner runner;
+    auto gw = OrderGateway::open(runner, tcpConfig());
+    ASSERT_TRUE(gw);
+    auto c = SimClient::tcp(gw->tcpPort());
+    c.logon(1);
+    SymbolId sym = c.symbol("BRST");
+
+    // every order raises the bid: one quote each, all published in one batch
+    const int n = static_cast<int>(OrderGateway::TX_FRAMES) * 3 / 2;
+    std::vector<InboundMsg> burst;
+    for (int i = 0; i < n; ++i) burst.push_back(limit(sym, OrderSide::BUY, 1.0 + i * 0.01, 1, 0));
+    ASSERT_EQ(runner.push(burst.data(), burst.size()), burst.size());
+
+    int quotes = 0;
+    OutboundMsg ev;
+    while (quotes < n && c.recvFrame(ev)) quotes += ev.type == OutboundType::TOB;
+    EXPECT_EQ(quotes, n);
+    EXPECT_EQ(gw->connections(), 1u);
+}
+
+TEST(OrderGateway, AccountsCannotTouchEachOthersOrders)
+{
+    EngineRunner runner;
+    auto gw = OrderGateway::open(runner, tcpConfig());
+    ASSERT_TRUE(gw);
+    auto a = SimClient::tcp(gw->tcpPort());
+    auto b = SimClient::tcp(gw->tcpPort());
+    a.logon(1);
+    b.logon(2);
+    SymbolId sym = a.symbol("AMZN");
+
+    a.sendFrame(limit(sym, OrderSide::BUY, 30.0, 4, 1));
+    OutboundMsg ev;
+    ASSERT_TRUE(a.recvType(OutboundType::ACK, ev));
+    const OrderId id = ev.ack.orderId;
+
+    InboundMsg cxl = InboundMsg::cancel(id);
+    cxl.account = 1;                                  // overridden by the logon
+    cxl.clientId = 5;
+    b.sendFrame(cxl);
+    ASSERT_TRUE(b.recvType(OutboundType::REJECT, ev));
+    EXPECT_EQ(ev.reject.reason, RejectReason::UNKNOWN_ORDER);
+    InboundMsg mod = InboundMsg::modify(id, toTicks(31.0), 1);
+    mod.clientId = 6;
+    b.sendFrame(mod);
+    ASSERT_TRUE(b.recvType(OutboundType::REJECT, ev));
+    EXPECT_EQ(ev.reject.clientId, 6u);
+    EXPECT_EQ(runner.engine().risk().exposure(1).openOrders, 1);
+    auto bids = runner.engine().getBook("AMZN")->getBuyOrders();
+    ASSERT_EQ(bids.size(), 1u);
+    EXPECT_EQ(bids[0]->getPrice(), toTicks(30.0));
+    EXPECT_EQ(bids[0]->getQuantity(), 4);
+
+    // the owner still can
+    cxl.clientId = 7;
+    a.sendFrame(cxl);
+    for (int i = 0; i < 2000 && runner.engine().risk().exposure(1).openOrders != 0; ++i)
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    EXPECT_EQ(runner.engine().risk().exposure(1).openOrders, 0);
+
+    // auctions are not a client's to run
+    b.sendFrame(InboundMsg::auctionStart());
+    while (b.recvFrame(ev)) {}
+    EXPECT_FALSE(runner.engine().getBook("AMZN")->inAuction());
+}
+
+TEST(OrderGateway, OrdersBeforeLogonCloseTheConnection)
+{
+    EngineRunner runner;
+    auto gw = OrderGateway::open(runner, tcpConfig());
+    ASSERT_TRUE(gw);
+    auto c = SimClient::tcp(gw->tcpPort());
+    c.sendFrame(limit(1, OrderSide::BUY, 1.0, 1, 1));
+    OutboundMsg ev;
+    EXPECT_FALSE(c.recvFrame(ev));
+}
+
+TEST(OrderGateway, RepliesForAClosedConnectionSkipTheNextOnItsSlot)
+{
+    EngineRunner runner;
+    auto gw = OrderGateway::open(runner, tcpConfig());
+    ASSERT_TRUE(gw);
+    auto old = SimClient::tcp(gw->tcpPort());
+    old.logon(1);
+    SymbolId sym = old.symbol("SLOT");
+
+    // the old client's orders queue up behind a backlog of unknown cancels,
+    // so their acks are still in flight when the slot is handed on
+    std::vector<InboundMsg> backlog(60000, InboundMsg::cancel(12345));
+    ASSERT_EQ(runner.push(backlog.data(), backlog.size()), backlog.size());
+    for (int i = 0; i < 10; ++i) old.sendFrame(limit(sym, OrderSide::BUY, 1.0, 1, 777));
+    old.shutdownWrite();
+    for (int i = 0; i < 1000 && gw->connections() != 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_EQ(gw->connections(), 0u);
+
+    auto next = SimClient::tcp(gw->tcpPort());
+    next.logon(2);
+    next.sendFrame(limit(sym, OrderSide::BUY, 1.0, 1, 5));
+    OutboundMsg ev;
+    int foreign = 0;
+    for (;;) {
+        ASSERT_TRUE(next.recvFrame(ev));
+        if (ev.type == OutboundType::REJECT) ++foreign;
+        if (ev.type != OutboundType::ACK) continue;
+        if (ev.ack.clientId == 5u) break;
+        ++foreign;
+    }
+    EXPECT_EQ(foreign, 0);
+}
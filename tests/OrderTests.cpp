@@ -7,7 +7,7 @@ TEST(OrderBasic, ConstructorAndAccessors)
     EXPECT_EQ(o.getSymbol(),  "AAPL");
     EXPECT_EQ(o.getSide(),    OrderSide::BUY);
     EXPECT_EQ(o.getType(),    OrderType::LIMIT);
-    EXPECT_EQ(o.getPrice(),   150.25);
+    EXPECT_EQ(o.getPrice(),   toTicks(150.25));
     EXPECT_EQ(o.getQuantity(),100);
     EXPECT_TRUE(o.isActive());
 }
@@ -16,8 +16,8 @@ TEST(OrderBasic, ModifyReduceCancel)
 {
     Order o("MSFT", OrderSide::SELL, OrderType::LIMIT, 300.00, 50);
 
-    o.modify(299.50, 40);
-    EXPECT_EQ(o.getPrice(),   299.50);
+    o.modify(toTicks(299.50), 40);
+    EXPECT_EQ(o.getPrice(),   toTicks(299.50));
     EXPECT_EQ(o.getQuantity(),40);
 
     o.reduceQuantity(15);
@@ -33,16 +33,19 @@ TEST(OrderBasic, ModifyReduceCancel)
 
 TEST(OrderValidation, InvalidConstruction)
 {
-    EXPECT_THROW(Order("AAPL", OrderSide::BUY, OrderType::LIMIT, 0.0,  10), std::invalid_argument);
-    EXPECT_THROW(Order("AAPL", OrderSide::BUY, OrderType::LIMIT, 150,   0), std::invalid_argument);
-    EXPECT_THROW(Order("",     OrderSide::BUY, OrderType::LIMIT, 150,  10), std::invalid_argument);
+    EXPECT_EQ(Order("AAPL", OrderSide::BUY, OrderType::LIMIT, 0.0,  10).validate(), RejectReason::BAD_PRICE);
+    EXPECT_EQ(Order("AAPL", OrderSide::BUY, OrderType::LIMIT, 150,   0).validate(), RejectReason::BAD_QTY);
+    EXPECT_EQ(Order("",     OrderSide::BUY, OrderType::LIMIT, 150,  10).validate(), RejectReason::EMPTY_SYMBOL);
+    EXPECT_EQ(Order("AAPL", OrderSide::BUY, OrderType::MARKET, 0.0, 10).validate(), RejectReason::NONE);
 }
 
 TEST(OrderValidation, InvalidModify)
 {
     Order o("AAPL", OrderSide::BUY, OrderType::LIMIT, 150.0, 10);
-    EXPECT_THROW(o.modify(-1.0, 10),               std::invalid_argument);
-    EXPECT_THROW(o.modify(150.0,-5),               std::invalid_argument);
+    EXPECT_EQ(o.modify(toTicks(-1.0), 10),  RejectReason::BAD_PRICE);
+    EXPECT_EQ(o.modify(toTicks(150.0),-5),  RejectReason::BAD_QTY);
+    EXPECT_EQ(o.reduceQuantity(11),         RejectReason::BAD_QTY);
+    EXPECT_EQ(o.getQuantity(), 10);
     o.cancel();
-    EXPECT_THROW(o.modify(150.0, 5),               std::logic_error);
+    EXPECT_EQ(o.modify(toTicks(150.0), 5),  RejectReason::INACTIVE_ORDER);
 }
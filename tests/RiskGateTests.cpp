@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "ExecutionEngine.hpp"
+
+using std::make_shared;
+
+static auto acctLimit(const std::string& sym, OrderSide s, double px, int qty,
+                      AccountId acct)
+{
+    return make_shared<Order>(sym, s, OrderType::LIMIT, px, qty, acct);
+}
+
+TEST(RiskGateUnit, LimitsAndCounters)
+{
+    RiskGate gate(4, 8);
+    RiskLimits l;
+    l.maxOrderQty   = 100;
+    l.maxNotional   = 10'000.0;
+    l.maxOpenOrders = 2;
+    l.maxPosition   = 150;
+    gate.setLimits(1, l);
+
+    EXPECT_EQ(gate.check(1, 1, OrderSide::BUY, toTicks(10.0), 101), RejectReason::QTY_LIMIT);
+    EXPECT_EQ(gate.check(1, 1, OrderSide::BUY, toTicks(200.0), 100), RejectReason::NOTIONAL_LIMIT);
+    EXPECT_EQ(gate.check(9, 1, OrderSide::BUY, toTicks(10.0), 1), RejectReason::UNKNOWN_ACCOUNT);
+    EXPECT_EQ(gate.check(1, 1, OrderSide::BUY, toTicks(10.0), 100), RejectReason::NONE);
+
+    gate.onAccept(1, 1, OrderSide::BUY, toTicks(10.0), 100);
+    EXPECT_EQ(gate.check(1, 1, OrderSide::BUY, toTicks(10.0), 60), RejectReason::POSITION_LIMIT);
+    EXPECT_EQ(gate.check(1, 1, OrderSide::SELL, toTicks(10.0), 60), RejectReason::NONE);
+
+    gate.onAccept(1, 2, OrderSide::SELL, toTicks(10.0), 10);
+    EXPECT_EQ(gate.check(1, 3, OrderSide::BUY, toTicks(10.0), 1), RejectReason::OPEN_ORDER_LIMIT);
+
+    gate.onFill(1, 1, OrderSide::BUY, toTicks(10.0), 40, false);
+    EXPECT_EQ(gate.position(1, 1), 40);
+    EXPECT_DOUBLE_EQ(gate.exposure(1).openNotional, 700.0);
+    EXPECT_EQ(gate.exposure(1).openOrders, 2);
+
+    gate.onCancel(1, 1, OrderSide::BUY, toTicks(10.0), 60);
+    EXPECT_EQ(gate.exposure(1).openOrders, 1);
+    EXPECT_DOUBLE_EQ(gate.exposure(1).openNotional, 100.0);
+    EXPECT_EQ(gate.position(1, 1), 40);
+}
+
+TEST(RiskGateEngine, RejectsAndTracksPerAccount)
+{
+    ExecutionEngine eng;
+    std::vector<RejectReason> why;
+    eng.setRejectHandler([&](const ExecutionEngine::Reject& r){ why.push_back(r.reason); });
+
+    RiskLimits l;
+    l.maxOpenOrders = 1;
+    l.maxPosition   = 10;
+    eng.risk().setLimits(7, l);
+
+    int bid = eng.submit(acctLimit("AAPL", OrderSide::BUY, 100.0, 10, 7));
+    EXPECT_GE(bid, 0);
+    EXPECT_EQ(eng.submit(acctLimit("AAPL", OrderSide::BUY, 99.0, 1, 7)), -1);
+    // other accounts are unaffected
+    EXPECT_GE(eng.submit(acctLimit("AAPL", OrderSide::BUY, 99.0, 1, 3)), 0);
+
+    SymbolId aapl = eng.symbols().find("AAPL");
+    eng.submit(acctLimit("AAPL", OrderSide::SELL, 100.0, 4, 3));
+    EXPECT_EQ(eng.risk().position(7, aapl),  4);
+    EXPECT_EQ(eng.risk().position(3, aapl), -4);
+    EXPECT_EQ(eng.risk().exposure(7).openOrders, 1);
+
+    EXPECT_TRUE(eng.cancel(bid));
+    EXPECT_EQ(eng.risk().exposure(7).openOrders, 0);
+    EXPECT_DOUBLE_EQ(eng.risk().exposure(7).openNotional, 0.0);
+
+    // position 4 + 7 would breach 10
+    EXPECT_EQ(eng.submit(acctLimit("AAPL", OrderSide::BUY, 90.0, 7, 7)), -1);
+
+    std::vector<RejectReason> expected = {
+        RejectReason::OPEN_ORDER_LIMIT, RejectReason::POSITION_LIMIT };
+    EXPECT_EQ(why, expected);
+}
+
+TEST(RiskGateEngine, ModifyIsChecked)
+{
+    ExecutionEngine eng;
+    RiskLimits l;
+    l.maxNotional = 1'000.0;
+    eng.risk().setLimits(2, l);
+
+    OrderId id = eng.submit(acctLimit("MSFT", OrderSide::SELL, 100.0, 5, 2));
+    ASSERT_GE(id, 0);
+    EXPECT_FALSE(eng.modify(id, std::nullopt, 11));
+    EXPECT_TRUE (eng.modify(id, toTicks(50.0), 20));
+    EXPECT_DOUBLE_EQ(eng.risk().exposure(2).openNotional, 1'000.0);
+}
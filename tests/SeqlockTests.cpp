@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "Seqlock.hpp"
+
+namespace {
+struct Payload {
+    std::uint64_t a, b, c, d;
+};
+}
+
+TEST(Seqlock, StoreThenLoad)
+{
+    Seqlock<Payload> s;
+    EXPECT_EQ(s.load().a, 0u);
+    s.store({1, 2, 3, 4});
+    Payload p = s.load();
+    EXPECT_EQ(p.a, 1u);
+    EXPECT_EQ(p.d, 4u);
+}
+
+TEST(Seqlock, ReadersNeverSeeTornWrites)
+{
+    Seqlock<Payload> s;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (std::uint64_t i = 1; i <= 200'000; ++i) s.store({i, i, i, i});
+        done = true;
+    });
+
+    std::uint64_t last = 0;
+    while (!done) {
+        Payload p = s.load();
+        ASSERT_EQ(p.a, p.b);
+        ASSERT_EQ(p.a, p.c);
+        ASSERT_EQ(p.a, p.d);
+        ASSERT_GE(p.a, last);           // versions never go backwards
+        last = p.a;
+    }
+    writer.join();
+    EXPECT_EQ(s.load().a, 200'000u);
+}
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ShmClient.hpp"
+#include "ShmGateway.hpp"
+
+namespace {
+std::string uniqueName(const char* tag)
+{
+    return "/tce_test_" + std::to_string(getpid()) + "_" + tag;
+}
+
+bool nextOf(ShmClient& c, OutboundType type, OutboundMsg& out)
+{
+    for (int i = 0; i < 2000; ++i) {
+        while (c.next(out))
+            if (out.type == type) return true;
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    return false;
+}
+
+InboundMsg limit(SymbolId sym, OrderSide side, double px, int qty)
+{
+    return InboundMsg::newOrder(sym, Order("", side, OrderType::LIMIT, px, qty));
+}
+}
+
+TEST(SpscRing, FifoAndFull)
+{
+    SpscRing<std::uint64_t, 4> r;
+    std::uint64_t v = 0;
+    EXPECT_FALSE(r.tryPop(v));
+    for (std::uint64_t i = 1; i <= 4; ++i) EXPECT_TRUE(r.tryPush(i));
+    EXPECT_FALSE(r.tryPush(5));
+    ASSERT_TRUE(r.tryPop(v));
+    EXPECT_EQ(v, 1u);
+    EXPECT_TRUE(r.tryPush(5));
+    for (std::uint64_t i = 2; i <= 5; ++i) {
+        ASSERT_TRUE(r.tryPop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_TRUE(r.empty());
+}
+
+TEST(SpscRing, ConcurrentProducerConsumer)
+{
+    auto r = std::make_unique<SpscRing<std::uint64_t, 64>>();
+    constexpr std::uint64_t N = 50'000;
+    std::thread producer([&] {
+        for (std::uint64_t i = 1; i <= N; ++i)
+            while (!r->tryPush(i)) std::this_thread::yield();
+    });
+    std::uint64_t expect = 1, v;
+    while (expect <= N) {
+        if (r->tryPop(v)) { ASSERT_EQ(v, expect++); }
+        else std::this_thread::yield();
+    }
+    producer.join();
+}
+
+TEST(BroadcastRing, ReadersKeepOwnCursors)
+{
+    BroadcastRing<std::uint64_t, 8> r;
+    std::uint64_t a = r.head(), b = r.head(), v = 0;
+    EXPECT_EQ(r.read(a, v), (BroadcastRing<std::uint64_t, 8>::Read::EMPTY));
+    r.publish(10);
+    r.publish(11);
+    ASSERT_EQ(r.read(a, v), (BroadcastRing<std::uint64_t, 8>::Read::OK));
+    EXPECT_EQ(v, 10u);
+    ASSERT_EQ(r.read(a, v), (BroadcastRing<std::uint64_t, 8>::Read::OK));
+    EXPECT_EQ(v, 11u);
+    ASSERT_EQ(r.read(b, v), (BroadcastRing<std::uint64_t, 8>::Read::OK));
+    EXPECT_EQ(v, 10u);
+    EXPECT_EQ(r.read(a, v), (BroadcastRing<std::uint64_t, 8>::Read::EMPTY));
+}
+
+TEST(BroadcastRing, SlowReaderIsLapped)
+{
+    BroadcastRing<std::uint64_t, 8> r;
+    std::uint64_t cur = r.head(), v = 0;
+    for (std::uint64_t i = 0; i < 20; ++i) r.publish(i);
+    EXPECT_EQ(r.read(cur, v), (BroadcastRing<std::uint64_t, 8>::Read::LAPPED));
+    EXPECT_EQ(cur, 13u);
+    ASSERT_EQ(r.read(cur, v), (BroadcastRing<std::uint64_t, 8>::Read::OK));
+    EXPECT_EQ(v, 13u);
+}
+
+TEST(ShmTransport, OrderRoundTrip)
+{
+    EngineRunner runner;
+    auto gw = ShmGateway::open(runner, uniqueName("rt"));
+    ASSERT_TRUE(gw);
+    auto c = ShmClient::connect(uniqueName("rt"), 7, false);
+    ASSERT_TRUE(c);
+    EXPECT_EQ(gw->clients(), 1u);
+
+    SymbolId sym = c->symbolId("AAPL");
+    ASSERT_NE(sym, SymbolTable::NONE);
+    EXPECT_EQ(sym, runner.engine().symbols().find("AAPL"));
+    EXPECT_STREQ(c->symbolName(sym), "AAPL");
+
+    std::uint64_t buyCid = c->send(limit(sym, OrderSide::BUY, 100.0, 10));
+    EXPECT_EQ(buyCid >> 48, c->slot() + 1);
+    OutboundMsg ev;
+    ASSERT_TRUE(nextOf(*c, OutboundType::ACK, ev));
+    EXPECT_EQ(ev.ack.clientId, buyCid);
+    OrderId buyId = ev.ack.orderId;
+
+    c->send(limit(sym, OrderSide::SELL, 100.0, 4));
+    ASSERT_TRUE(nextOf(*c, OutboundType::TRADE, ev));
+    EXPECT_EQ(ev.trade.buyId, buyId);
+    EXPECT_EQ(ev.trade.qty, 4);
+    EXPECT_EQ(ev.trade.px, toTicks(100.0));
+    EXPECT_EQ(c->lost(), 0u);
+}
+
+TEST(ShmTransport, OrdersAreStampedWithTheConnectionAccount)
+{
+    EngineRunner runner;
+    auto gw = ShmGateway::open(runner, uniqueName("acct"));
+    ASSERT_TRUE(gw);
+    auto c = ShmClient::connect(uniqueName("acct"), 5, true);
+    ASSERT_TRUE(c);
+
+    SymbolId sym = c->symbolId("MSFT");
+    InboundMsg m = limit(sym, OrderSide::BUY, 50.0, 3);
+    m.account = 9;                                  // ignored by the gateway
+    c->send(m);
+    OutboundMsg ev;
+    ASSERT_TRUE(nextOf(*c, OutboundType::ACK, ev));
+    EXPECT_EQ(runner.engine().risk().exposure(5).openOrders, 1);
+
+    // disconnecting with cancelOnDisconnect pulls the account's orders
+    c.reset();
+    for (int i = 0; i < 2000 && runner.engine().risk().exposure(5).openOrders != 0; ++i)
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    EXPECT_EQ(runner.engine().risk().exposure(5).openOrders, 0);
+    EXPECT_EQ(gw->clients(), 0u);
+}
+
+TEST(ShmTransport, ClientsCannotTouchOtherAccountsOrRunAuctions)
+{
+    EngineRunner runner;
+    auto gw = ShmGateway::open(runner, uniqueName("own"));
+    ASSERT_TRUE(gw);
+    auto a = ShmClient::connect(uniqueName("own"), 1, false);
+    auto b = ShmClient::connect(uniqueName("own"), 2, false);
+    ASSERT_TRUE(a && b);
+
+    SymbolId sym = a->symbolId("IBM");
+    a->send(limit(sym, OrderSide::BUY, 20.0, 3));
+    OutboundMsg ev;
+    ASSERT_TRUE(nextOf(*a, OutboundType::ACK, ev));
+    const OrderId id = ev.ack.orderId;
+
+    b->send(InboundMsg::cancel(id));
+    b->send(InboundMsg::modify(id, toTicks(21.0), 1));
+    b->send(InboundMsg::auctionStart());
+    b->send(limit(sym, OrderSide::SELL, 30.0, 1));  // acked once the rest is handled
+    ASSERT_TRUE(nextOf(*b, OutboundType::ACK, ev));
+
+    auto bids = runner.engine().getBook("IBM")->getBuyOrders();
+    ASSERT_EQ(bids.size(), 1u);
+    EXPECT_EQ(bids[0]->getOrderId(), id);
+    EXPECT_EQ(bids[0]->getPrice(), toTicks(20.0));
+    EXPECT_EQ(bids[0]->getQuantity(), 3);
+    EXPECT_FALSE(runner.engine().getBook("IBM")->inAuction());
+}
+
+TEST(ShmTransport, ConnectFailsWithoutGateway)
+{
+    EXPECT_FALSE(ShmClient::connect(uniqueName("none"), 1, false));
+}
+
+TEST(ShmTransport, ClientInAnotherProcess)
+{
+    EngineRunner runner;
+    const std::string name = uniqueName("fork");
+    auto gw = ShmGateway::open(runner, name);
+    ASSERT_TRUE(gw);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        auto c = ShmClient::connect(name, 3, false);
+        if (!c) _exit(2);
+        std::uint64_t cid = c->send(limit(c->symbolId("IBM"), OrderSide::SELL, 20.0, 1));
+        OutboundMsg ev;
+        bool acked = false;
+        for (int i = 0; i < 2000 && !acked; ++i) {
+            while (!acked && c->next(ev)) acked = ev.type == OutboundType::ACK && ev.ack.clientId == cid;
+            if (!acked) usleep(500);
+        }
+        _exit(acked ? 0 : 3);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_NE(runner.engine().symbols().find("IBM"), SymbolTable::NONE);
+}
+
+TEST(ShmTransport, ReservationOfADeadClientIsFreed)
+{
+    EngineRunner runner;
+    const std::string name = uniqueName("reserved");
+    auto gw = ShmGateway::open(runner, name);
+    ASSERT_TRUE(gw);
+    ShmMapping map = ShmMapping::open(name, sizeof(ShmRegion), false);
+    ASSERT_TRUE(map);
+    auto* region = static_cast<ShmRegion*>(map.data());
+
+    // a client that reserved slot 0 and died before claiming it, and a live
+    // one still filling in slot 1
+    pid_t dead = fork();
+    ASSERT_GE(dead, 0);
+    if (dead == 0) _exit(0);
+    ASSERT_EQ(waitpid(dead, nullptr, 0), dead);
+    std::uint32_t expected = 0;
+    ASSERT_TRUE(region->clients[0].state.compare_exchange_strong(expected, shmReservedBy(dead)));
+    expected = 0;
+    ASSERT_TRUE(region->clients[1].state.compare_exchange_strong(expected, shmReservedBy(getpid())));
+
+    for (int i = 0; i < 200 && region->clients[0].state.load() != 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(region->clients[0].state.load(), 0u);
+    EXPECT_EQ(region->clients[1].state.load(), shmReservedBy(getpid()));
+    EXPECT_TRUE(ShmClient::connect(name, 1, false));
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "EngineRunner.hpp"
+#include "Tape.hpp"
+
+namespace {
+constexpr std::int64_t SEC = 1'000'000'000;
+constexpr std::int64_t DAY = 86'400 * SEC;
+constexpr std::int64_t T0  = 19'000 * DAY;      // 2022-01-08 00:00 UTC
+
+struct TempDir {
+    std::string path;
+    explicit TempDir(const char* tag)
+        : path((std::filesystem::temp_directory_path() /
+                (std::string("tcx_") + tag + "_" + std::to_string(getpid()))).string()) {
+        std::filesystem::remove_all(path);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+};
+}
+
+TEST(Tape, AppendsColumnsAndAnswersRangeQueries)
+{
+    TempDir dir("tape");
+    SymbolTable syms;
+    const SymbolId a = syms.intern("AAPL"), m = syms.intern("MSFT");
+    auto w = TapeWriter::open(dir.path, syms);
+    ASSERT_TRUE(w);
+
+    // enough rows to grow the files and fill several index blocks
+    const std::uint64_t N = TapeWriter::INITIAL_ROWS + 3 * TAPE_BLOCK;
+    for (std::uint64_t i = 0; i < N; ++i) {
+        const SymbolId s = i % 3 == 0 ? m : a;
+        w->trade(T0 + static_cast<std::int64_t>(i) * 1000, s, 100 * PX_SCALE + i, 1 + i % 7,
+                 2 * i, 2 * i + 1);
+    }
+    w->trade(T0 + 5, a, 1, 1, 0, 0);                // clock stepped back: clamped
+    w->quote(T0, a, 10, 11, 5, 6);
+    w->quote(T0 + 1, a, 10, 11, 5, 6);              // unchanged, not recorded
+    w->quote(T0 + 2, a, 10, 12, 5, 6);
+    ASSERT_TRUE(w->ok());
+    EXPECT_EQ(w->dayDir(), dir.path + "/20220108");
+
+    TapeReader r;
+    ASSERT_TRUE(r.open(w->dayDir()));
+    EXPECT_EQ(r.meta().pxScale, PX_SCALE);
+    EXPECT_EQ(r.meta().dayStartNs, T0);
+    EXPECT_EQ(r.symbol("MSFT"), m);
+    EXPECT_EQ(r.symbol("GOOG"), SymbolTable::NONE);
+
+    const auto& t = r.trades();
+    ASSERT_EQ(t.n, N + 1);
+    EXPECT_EQ(t.sym[3], m);
+    EXPECT_EQ(t.px[70000], 100 * PX_SCALE + 70000);
+    EXPECT_EQ(t.sellId[70000], 140001);
+    EXPECT_EQ(t.ts[N], t.ts[N - 1]);
+    EXPECT_EQ(r.quotes().n, 2u);
+    EXPECT_EQ(r.quotes().askPx[1], 12);
+
+    auto range = r.tradeRange(T0 + 5000 * 1000, T0 + 9000 * 1000);
+    EXPECT_EQ(range.first, 5000u);
+    EXPECT_EQ(range.second, 9000u);
+    EXPECT_EQ(r.tradeRange(T0 - DAY, T0).second, 0u);
+    EXPECT_EQ(r.tradeRange(T0, T0 + DAY).second, N + 1);
+
+    std::vector<std::size_t> rows;
+    r.forEachTrade(m, T0 + 5000 * 1000, T0 + 5010 * 1000, [&](std::size_t row){ rows.push_back(row); });
+    EXPECT_EQ(rows, (std::vector<std::size_t>{5001, 5004, 5007}));
+}
+
+TEST(Tape, RollsOverDaysAndReopens)
+{
+    TempDir dir("tape_days");
+    SymbolTable syms;
+    const SymbolId a = syms.intern("AAPL");
+    {
+        auto w = TapeWriter::open(dir.path, syms);
+        w->trade(T0 + 10, a, 1, 1, 1, 2);
+        w->trade(T0 + DAY + 10, a, 2, 1, 3, 4);
+        EXPECT_EQ(w->dayDir(), dir.path + "/20220109");
+    }
+    auto w = TapeWriter::open(dir.path, syms);      // e.g. after a restart
+    w->trade(T0 + DAY + 20, a, 3, 1, 5, 6);
+
+    TapeReader first, second;
+    ASSERT_TRUE(first.open(dir.path + "/20220108"));
+    ASSERT_TRUE(second.open(dir.path + "/20220109"));
+    EXPECT_EQ(first.trades().n, 1u);
+    ASSERT_EQ(second.trades().n, 2u);
+    EXPECT_EQ(second.trades().px[1], 3);
+
+    w->trade(T0 + DAY + 30, a, 4, 1, 7, 8);
+    EXPECT_EQ(second.trades().n, 2u);
+    ASSERT_TRUE(second.refresh());
+    EXPECT_EQ(second.trades().n, 3u);
+}
+
+TEST(Tape, RunnerRecordsFillsAndQuotes)
+{
+    TempDir dir("tape_runner");
+    EngineRunner r;
+    ASSERT_TRUE(r.recordTape(dir.path));
+    EXPECT_FALSE(r.recordTape(dir.path));
+
+    const SymbolId sym = r.engine().symbols().intern("AAPL");
+    Order buy("AAPL", OrderSide::BUY, OrderType::LIMIT, 150, 3);
+    Order sell("AAPL", OrderSide::SELL, OrderType::LIMIT, 150, 2);
+    r.push(InboundMsg::newOrder(sym, buy));
+    r.push(InboundMsg::newOrder(sym, sell));
+
+    OutboundMsg ev;
+    int tobs = 0;
+    for (int i = 0; i < 1000 && tobs < 2; ++i) {
+        while (r.poll(ev)) tobs += ev.type == OutboundType::TOB;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    r.stop();
+
+    std::vector<std::filesystem::path> days;
+    for (const auto& d : std::filesystem::directory_iterator(dir.path)) days.push_back(d.path());
+    ASSERT_EQ(days.size(), 1u);
+    TapeReader t;
+    ASSERT_TRUE(t.open(days[0].string()));
+    ASSERT_EQ(t.trades().n, 1u);
+    EXPECT_EQ(t.trades().px[0], 150 * PX_SCALE);
+    EXPECT_EQ(t.trades().qty[0], 2);
+    EXPECT_EQ(t.quotes().n, 2u);
+    EXPECT_EQ(t.quotes().bidQty[1], 1);
+}
+
+TEST(Tape, RunnerRecordsQuotesAfterCancelAndCrossingModify)
+{
+    TempDir dir("tape_cxl");
+    EngineRunner r;
+    ASSERT_TRUE(r.recordTape(dir.path));
+    const SymbolId sym = r.engine().symbols().intern("MSFT");
+    auto ack = [&](const Order& o) {
+        r.push(InboundMsg::newOrder(sym, o));
+        OutboundMsg ev;
+        for (int i = 0; i < 1000; ++i) {
+            while (r.poll(ev)) if (ev.type == OutboundType::ACK) return ev.ack.orderId;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return NO_ORDER;
+    };
+    const OrderId bid  = ack(Order("MSFT", OrderSide::BUY,  OrderType::LIMIT, 10, 5));   // quote 1
+    const OrderId ask  = ack(Order("MSFT", OrderSide::SELL, OrderType::LIMIT, 12, 5));   // quote 2
+    ack(Order("MSFT", OrderSide::BUY, OrderType::LIMIT, 9, 5));                          // behind the top
+    ASSERT_NE(bid, NO_ORDER);
+    ASSERT_NE(ask, NO_ORDER);
+    r.push(InboundMsg::cancel(bid));                                    // quote 3: bid 9
+    r.push(InboundMsg::modify(ask, toTicks(9), std::nullopt));          // crosses: quote 4, empty
+    OutboundMsg ev;
+    int tobs = 0, trades = 0;
+    for (int i = 0; i < 1000 && (tobs < 2 || trades < 1); ++i) {
+        while (r.poll(ev)) {
+            tobs += ev.type == OutboundType::TOB;
+            trades += ev.type == OutboundType::TRADE;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    r.stop();
+    EXPECT_EQ(tobs, 2);
+
+    std::vector<std::filesystem::path> days;
+    for (const auto& d : std::filesystem::directory_iterator(dir.path)) days.push_back(d.path());
+    ASSERT_EQ(days.size(), 1u);
+    TapeReader t;
+    ASSERT_TRUE(t.open(days[0].string()));
+    EXPECT_EQ(t.trades().n, 1u);
+    ASSERT_EQ(t.quotes().n, 4u);
+    EXPECT_EQ(t.quotes().bidPx[2], 9 * PX_SCALE);
+    EXPECT_EQ(t.quotes().askPx[2], 12 * PX_SCALE);
+    EXPECT_EQ(t.quotes().bidQty[3], 0);
+    EXPECT_EQ(t.quotes().askQty[3], 0);
+}
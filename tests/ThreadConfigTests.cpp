@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "EngineRunner.hpp"
+
+#ifdef __linux__
+#include <sched.h>
+
+TEST(ThreadConfig, PinsCallingThread)
+{
+    bool ok = false;
+    int cpu = -1;
+    std::thread t([&] {
+        ThreadConfig cfg;
+        cfg.cpus = {0};
+        ok  = applyThreadConfig(cfg);
+        cpu = sched_getcpu();
+    });
+    t.join();
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(cpu, 0);
+}
+#endif
+
+TEST(ThreadConfig, DefaultsAreNoOp)
+{
+    EXPECT_TRUE(applyThreadConfig({}));
+}
+
+TEST(ThreadConfig, BusyPollRunnerDeliversEvents)
+{
+    ThreadConfig cfg;
+    cfg.busyPoll = true;
+    EngineRunner r(cfg);
+
+    auto o = std::make_shared<Order>("AAPL", OrderSide::BUY, OrderType::LIMIT, 100.0, 5);
+    r.push(InboundMsg::newOrder(r.engine().symbols().intern("AAPL"), *o));
+
+    OutboundMsg ev{};
+    for (int i = 0; i < 1000 && !r.poll(ev); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(ev.type, OutboundType::ACK);
+    EXPECT_TRUE(r.workerConfigured());
+}
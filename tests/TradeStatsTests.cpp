@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "EngineRunner.hpp"
+#include "TradeStats.hpp"
+
+namespace {
+constexpr SymbolId SYM = 3;
+constexpr std::int64_t SEC = 1'000'000'000;
+}
+
+TEST(TradeStats, RunningSummaryAndBars)
+{
+    TradeStats st;
+    st.setBarInterval(10 * SEC);
+    std::vector<TradeStats::Bar> closed;
+    st.setBarHandler([&](SymbolId s, const TradeStats::Bar& b){
+        EXPECT_EQ(s, SYM);
+        closed.push_back(b);
+    });
+
+    TradeStats::Summary s;
+    EXPECT_FALSE(st.summary(SYM, s));
+
+    st.onTrade(SYM, toTicks(10.0), 100, 100 * SEC + 1);
+    st.onTrade(SYM, toTicks(12.0), 100, 101 * SEC);
+    st.onTrade(SYM, toTicks(9.0),  200, 109 * SEC);
+    EXPECT_FALSE(st.summary(SYM, s));              // nothing published yet
+    st.publish(SYM);
+    ASSERT_TRUE(st.summary(SYM, s));
+    EXPECT_EQ(s.trades, 3u);
+    EXPECT_EQ(s.volume, 400);
+    EXPECT_EQ(s.vwap(), toTicks((1000.0 + 1200.0 + 1800.0) / 400));
+    EXPECT_EQ(s.last, toTicks(9.0));
+    EXPECT_EQ(s.high, toTicks(12.0));
+    EXPECT_EQ(s.low, toTicks(9.0));
+    EXPECT_EQ(s.bar.startNs, 100 * SEC);
+    EXPECT_EQ(s.bar.trades, 3u);
+    EXPECT_EQ(st.nextCloseNs(), 110 * SEC);
+    EXPECT_TRUE(closed.empty());
+
+    // the first trade of a later interval closes the bar; quiet ones make none
+    st.onTrade(SYM, toTicks(11.0), 50, 135 * SEC);
+    ASSERT_EQ(closed.size(), 1u);
+    EXPECT_EQ(closed[0].open, toTicks(10.0));
+    EXPECT_EQ(closed[0].high, toTicks(12.0));
+    EXPECT_EQ(closed[0].low, toTicks(9.0));
+    EXPECT_EQ(closed[0].close, toTicks(9.0));
+    EXPECT_EQ(closed[0].volume, 400);
+    EXPECT_EQ(st.nextCloseNs(), 140 * SEC);
+
+    st.closeBars(139 * SEC);
+    EXPECT_EQ(closed.size(), 1u);
+    st.closeBars(140 * SEC);
+    ASSERT_EQ(closed.size(), 2u);
+    EXPECT_EQ(closed[1].startNs, 130 * SEC);
+    EXPECT_EQ(closed[1].vwap(), toTicks(11.0));
+    EXPECT_EQ(st.nextCloseNs(), 0);
+
+    ASSERT_TRUE(st.summary(SYM, s));               // closing publishes
+    EXPECT_EQ(s.bar.trades, 0u);
+    EXPECT_EQ(s.trades, 4u);
+    EXPECT_EQ(s.open, toTicks(10.0));
+}
+
+TEST(TradeStats, EngineFeedsStatsAndRunnerClosesBars)
+{
+    EngineRunner r;
+    r.setBarInterval(std::chrono::milliseconds(50));
+    const SymbolId sym = r.engine().symbols().intern("AAPL");
+
+    auto buy  = std::make_shared<Order>("AAPL", OrderSide::BUY,  OrderType::LIMIT, 150, 3);
+    auto sell = std::make_shared<Order>("AAPL", OrderSide::SELL, OrderType::LIMIT, 149, 3);
+    r.push(InboundMsg::newOrder(sym, *buy));
+    r.push(InboundMsg::newOrder(sym, *sell));
+
+    // an idle worker still closes the bar once its interval is over
+    OutboundMsg bar{};
+    OutboundMsg ev;
+    for (int i = 0; i < 1000 && bar.type != OutboundType::BAR; ++i) {
+        while (r.poll(ev))
+            if (ev.type == OutboundType::BAR) bar = ev;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(bar.type, OutboundType::BAR);
+    EXPECT_EQ(bar.symbolId, sym);
+    EXPECT_EQ(bar.bar.open, 150 * PX_SCALE);
+    EXPECT_EQ(bar.bar.vwap, 150 * PX_SCALE);
+    EXPECT_EQ(bar.bar.volume, 3);
+    EXPECT_EQ(bar.bar.startNs % 50'000'000, 0);
+
+    TradeStats::Summary s;
+    ASSERT_TRUE(r.engine().stats().summary(sym, s));
+    EXPECT_EQ(s.trades, 1u);
+    EXPECT_EQ(s.volume, 3);
+    EXPECT_EQ(s.last, toTicks(150.0));
+    EXPECT_EQ(s.bar.trades, 0u);
+    r.stop();
+}
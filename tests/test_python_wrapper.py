@@ -1,4 +1,5 @@
 import sys, pathlib, time
+import pytest
 ROOT = pathlib.Path(__file__).resolve().parents[1]
 sys.path.insert(0, str(ROOT / "research" / "py"))
 
@@ -70,4 +71,98 @@ def test_market_order_hits_best():
         trades = [e for e in events if isinstance(e, Trade)]
         if trades:
             t = trades[-1]
-            assert t.px == 310.0 and t.qty == 7
\ No newline at end of file
+            assert t.px == 310.0 and t.qty == 7
+
+def test_tape_is_readable_without_copying(tmp_path):
+    from tcx.tape import Tape
+    with Engine() as eng:
+        eng.record_tape(str(tmp_path))
+        eng.submit_limit("TAPE", BUY, 10.0, 5)
+        eng.submit_limit("TAPE", SELL, 10.0, 2)
+        wait_for(lambda: eng.stats("TAPE"))
+
+    (day,) = list(tmp_path.iterdir())
+    tape = Tape(str(day))
+    assert len(tape.trades["px"]) == 1
+    assert tape.trades["px"][0] == 10 * tape.px_scale and tape.trades["qty"][0] == 2
+    assert tape.trade_rows("TAPE", 0, 2**62) == [0]
+    assert tape.trade_rows("NONE", 0, 2**62) == []
+    assert len(tape.quotes["bid"]) == 2
+
+def test_metrics_count_orders_and_fills():
+    with Engine() as eng:
+        eng.submit_limit("MET", BUY , 10.0, 5)
+        eng.submit_limit("MET", SELL, 10.0, 3)
+        m = wait_for(lambda: (m := eng.metrics())["msgs_handled"] == 2 and m)
+        assert m["orders"] == 2 and m["filled_qty"] == 3
+        assert m["resting_orders"] == 1 and eng.book_orders("MET") == 1
+
+def test_flow_control_grants_credits():
+    from tcx.engine import Overflow
+    with Engine() as eng:
+        eng.set_flow_control(in_capacity=100, session_credits=10, inbound=Overflow.REJECT)
+        s = eng.open_session(3, cancel_on_disconnect=False)
+        assert eng.credits() == 100 and eng.credits(s) == 10
+        with pytest.raises(ValueError):
+            eng.set_flow_control(inbound=Overflow.CONFLATE)
+        assert eng.metrics()["throttled"] == 0
+
+def test_tick_size_rejects_off_tick_prices():
+    from tcx.engine import Reject
+    with Engine() as eng:
+        eng.set_tick_size("TICK", 0.05)
+        assert eng.tick_size("TICK") == 0.05
+        eng.submit_limit("TICK", BUY, 10.02, 5)
+        eng.submit_limit("TICK", BUY, 10.05, 5)
+        wait_for(lambda: eng.metrics()["msgs_handled"] == 2)
+        events = eng.poll()
+        assert [e for e in events if isinstance(e, Reject)]
+        bids, _ = eng.depth("TICK")
+        assert bids == [(10.05, 5)]
+        with pytest.raises(ValueError):
+            eng.set_tick_size("TICK", 0)
+
+def test_subscribers_each_see_every_trade():
+    from tcx.engine import EventType, Trade
+    with Engine() as eng:
+        everything = eng.subscribe()
+        trades = eng.subscribe("SUB", [EventType.TRADE])
+        eng.submit_limit("SUB", BUY, 20.0, 4)
+        eng.submit_limit("SUB", SELL, 20.0, 4)
+        wait_for(lambda: eng.metrics()["msgs_handled"] == 2)
+        seen = []
+        wait_for(lambda: seen.extend(trades.poll()) or seen)
+        assert seen == [Trade("SUB", seen[0].buy_id, seen[0].sell_id, 4, 20.0)]
+        assert [e for e in everything.poll() if isinstance(e, Trade)] == seen
+        assert [e for e in eng.poll() if isinstance(e, Trade)] == seen
+        assert everything.lost == 0
+        everything.close(); trades.close()
+
+def test_events_wake_an_asyncio_consumer():
+    import asyncio
+    from tcx.engine import Trade
+    async def first_trade(eng):
+        async for batch in eng.events():
+            trades = [e for e in batch if isinstance(e, Trade)]
+            if trades:
+                return trades
+    async def main(eng):
+        consumer = asyncio.create_task(first_trade(eng))
+        await asyncio.sleep(0.01)           # consumer is asleep on the fd
+        eng.submit_limit("AIO", BUY, 5.0, 2)
+        eng.submit_limit("AIO", SELL, 5.0, 2)
+        return await asyncio.wait_for(consumer, 1.0)
+    with Engine() as eng:
+        trades = asyncio.run(main(eng))
+        assert [(t.qty, t.px) for t in trades] == [(2, 5.0)]
+
+def test_event_fd_stays_readable_after_an_ack_timeout():
+    import select
+    from tcx.engine import lib
+    with Engine() as eng:
+        eng.submit_limit("TMO", BUY, 7.0, 1)
+        wait_for(lambda: eng.metrics()["msgs_handled"] == 1)
+        # nothing acks client id 999: times out with the events buffered
+        assert lib.tcx_await_ack(eng._h, 999, 20) == -1
+        assert select.select([eng.fileno()], [], [], 0)[0]
+        assert eng.poll()